@@ -41,8 +41,13 @@ public class LocalizationImporter : ModuleRules
 				"Projects",
 				"DesktopPlatform",
 				"ApplicationCore",
-				"InputCore"
+				"InputCore",
+				"Json",
+				"AssetRegistry"
 			}
 			);
+
+		// Used to inflate .xlsx parts without going through Python
+		AddEngineThirdPartyPrivateStaticDependencies(Target, "zlib");
 	}
 }
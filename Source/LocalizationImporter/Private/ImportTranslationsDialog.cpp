@@ -1,7 +1,11 @@
 ﻿// Copyright (C) 2022 Dakarai Simmons - All Rights Reserved
 
 #include "ImportTranslationsDialog.h"
-#include "PythonBridge.h"
+#include "LISpreadsheet.h"
+#include "LIImport.h"
+#include "LIImporterSettings.h"
+#include "LIRunSummary.h"
+#include "LocalizationImporter.h"
 #include "LICommandletExecutor.h"
 #include "DesktopPlatformModule.h"
 #include "EditorDirectories.h"
@@ -15,22 +19,20 @@
 #include "Widgets/Input/SButton.h"
 #include "Widgets/Input/SCheckBox.h"
 #include "Widgets/Input/SComboButton.h"
+#include "Widgets/Images/SThrobber.h"
 #include "Widgets/Layout/SBorder.h"
 #include "Widgets/Layout/SBox.h"
 #include "Widgets/Layout/SSeparator.h"
 #include "Widgets/Layout/SUniformGridPanel.h"
 #include "Widgets/Text/STextBlock.h"
 #include "Widgets/Views/SListView.h"
-#include "LocalizationCommandletExecution.h"
-#include "LocalizationConfigurationScript.h"
-#include "LocalizationSettings.h"
 #include "LocalizationTargetTypes.h"
 #include "Misc/MessageDialog.h"
 #include "SourceControlOperations.h"
 #include "HAL/PlatformFilemanager.h"
-#include "Interfaces/IPluginManager.h"
 #include "Widgets/Notifications/SNotificationList.h"
 #include "Framework/Notifications/NotificationManager.h"
+#include "Async/Async.h"
 
 
 #define LOCTEXT_NAMESPACE "ImportTranslationsDialog"
@@ -39,6 +41,9 @@ void SImportTranslationsDialog::Construct(const FArguments& InArgs)
 {
 	ParentWindowPtr = InArgs._ParentWindow;
 
+	for(const ULocalizationTarget* Target : FLIImport::GetGameTargets())
+		SelectedTargets.Add(MakeShareable(new FUpdateTranslationsSettings(Target->Settings.Name, true)));
+
 	ChildSlot
 	[
 		SNew(SBorder)
@@ -70,18 +75,48 @@ void SImportTranslationsDialog::Construct(const FArguments& InArgs)
 							.VAlign(VAlign_Center)
 							[
 								SNew(STextBlock)
-								.Text(LOCTEXT("FileName", "Please select a spreadsheet"))
+								.Text(LOCTEXT("FileName", "Please select one or more spreadsheets"))
 							]
 							+SHorizontalBox::Slot()
 							.AutoWidth()
 							[
 								SNew(SButton)
 								.Text(this, &SImportTranslationsDialog::GetFileButtonText)
+								.ToolTipText(this, &SImportTranslationsDialog::GetFileButtonTooltip)
 								.OnClicked(this, &SImportTranslationsDialog::ChooseFile)
 							]
 						]
 						+SVerticalBox::Slot()
 						.AutoHeight()
+						.Padding(0.0f, 5.0f, 0.0f, 0.0f)
+						[
+							SNew(SHorizontalBox)
+							.Visibility(this, &SImportTranslationsDialog::GetLoadingVisibility)
+							+SHorizontalBox::Slot()
+							.AutoWidth()
+							.Padding(0.0f, 0.0f, 5.0f, 0.0f)
+							.VAlign(VAlign_Center)
+							[
+								SNew(SThrobber)
+							]
+							+SHorizontalBox::Slot()
+							.FillWidth(1.0f)
+							.VAlign(VAlign_Center)
+							[
+								SNew(STextBlock)
+								.Text(LOCTEXT("LoadingSpreadsheet", "Reading the spreadsheet..."))
+							]
+							+SHorizontalBox::Slot()
+							.AutoWidth()
+							[
+								SNew(SButton)
+								.Text(LOCTEXT("StopLoadingBtn", "Stop"))
+								.ToolTipText(LOCTEXT("StopLoadingTooltip", "Stop reading the spreadsheet"))
+								.OnClicked(this, &SImportTranslationsDialog::OnCancelLoadClicked)
+							]
+						]
+						+SVerticalBox::Slot()
+						.AutoHeight()
 						.Padding(0.0f, 20.0f, 0.0f, 0.0f)
 						[
 							SNew(STextBlock)
@@ -96,6 +131,32 @@ void SImportTranslationsDialog::Construct(const FArguments& InArgs)
 						]
 						+SVerticalBox::Slot()
 						.AutoHeight()
+						.Padding(0.0f, 0.0f, 0.0f, 3.0f)
+						[
+							SNew(SHorizontalBox)
+							+SHorizontalBox::Slot()
+							.FillWidth(1.0f)
+							.VAlign(VAlign_Center)
+							[
+								SNew(STextBlock)
+								.Text(LOCTEXT("TargetsLabel", "Targets:"))
+							]
+							+SHorizontalBox::Slot()
+							.AutoWidth()
+							[
+								SNew(SComboButton)
+								.ToolTipText(LOCTEXT("TargetComboTooltip", "Select which localization targets to update. Targets that don't depend on each other are updated at the same time."))
+								.OnGetMenuContent(this, &SImportTranslationsDialog::GenerateTargetSelector)
+								.IsEnabled(this, &SImportTranslationsDialog::IsTargetButtonEnabled)
+								.ButtonContent()
+								[
+									SNew(STextBlock)
+									.Text(this, &SImportTranslationsDialog::GetTargetButtonText)
+								]
+							]
+						]
+						+SVerticalBox::Slot()
+						.AutoHeight()
 						[
 							SNew(SHorizontalBox)
 							+SHorizontalBox::Slot()
@@ -181,6 +242,41 @@ void SImportTranslationsDialog::Construct(const FArguments& InArgs)
 								.Text(LOCTEXT("ForceRefresh","Force Full Refresh"))
 								.ToolTipText(LOCTEXT("ForceRefreshTooltip", "If checked all items will be updated instead of just empty ones."))
 							]
+							+SHorizontalBox::Slot()
+							.AutoWidth()
+							.Padding(10.0f, 0.0f, 5.0f, 0.0f)
+							.VAlign(VAlign_Center)
+							[
+								SNew(SCheckBox)
+								.IsChecked(bMatchByKey ? ECheckBoxState::Checked : ECheckBoxState::Unchecked)
+								.OnCheckStateChanged(this, &SImportTranslationsDialog::OnMatchByKeyChecked)
+								.ToolTipText(LOCTEXT("MatchByKeyTooltip", "If checked entries are matched by their key first and by their English text only when no row has that key."))
+							]
+							+SHorizontalBox::Slot()
+							.AutoWidth()
+							.VAlign(VAlign_Center)
+							[
+								SNew(STextBlock)
+								.Text(LOCTEXT("MatchByKey","Match by Key"))
+								.ToolTipText(LOCTEXT("MatchByKeyTooltip", "If checked entries are matched by their key first and by their English text only when no row has that key."))
+							]
+							+SHorizontalBox::Slot()
+							.AutoWidth()
+							.Padding(10.0f, 0.0f, 5.0f, 0.0f)
+							.VAlign(VAlign_Center)
+							[
+								SNew(SCheckBox)
+								.OnCheckStateChanged(this, &SImportTranslationsDialog::OnQuickCompileChecked)
+								.ToolTipText(LOCTEXT("QuickCompileTooltip", "If checked only the .locres files are written, straight from the spreadsheet and the text gathered last time, without updating the .po files. For checking translations in the editor; a full update is still needed before shipping."))
+							]
+							+SHorizontalBox::Slot()
+							.AutoWidth()
+							.VAlign(VAlign_Center)
+							[
+								SNew(STextBlock)
+								.Text(LOCTEXT("QuickCompile","Quick Compile"))
+								.ToolTipText(LOCTEXT("QuickCompileTooltip", "If checked only the .locres files are written, straight from the spreadsheet and the text gathered last time, without updating the .po files. For checking translations in the editor; a full update is still needed before shipping."))
+							]
 						]
 					]
 				]
@@ -218,6 +314,12 @@ void SImportTranslationsDialog::Construct(const FArguments& InArgs)
 	];
 }
 
+SImportTranslationsDialog::~SImportTranslationsDialog()
+{
+	// The load keeps its own reference, it only needs to be told to stop.
+	CancelLoad();
+}
+
 bool SImportTranslationsDialog::CheckOutOrAddFile(const FString& File, bool ForceSourceControlUpdate, bool ShowErrorInNotification, FText* OutErrorMsg)
 {
 	FText errorMessage;
@@ -297,40 +399,107 @@ FReply SImportTranslationsDialog::ChooseFile()
 	{
 		bOpened = Platform->OpenFileDialog(
 			FSlateApplication::Get().FindBestParentWindowHandleForDialogs(nullptr),
-			LOCTEXT("FileDialogTitle", "Please select a spreadsheet").ToString(),
+			LOCTEXT("FileDialogTitle", "Please select one or more spreadsheets").ToString(),
 			DefaultLocation,
 			TEXT(""),
-			FString("Spreadsheet files (*.xlsx)|*.xlsx"),
-			EFileDialogFlags::None,
+			FString("Spreadsheet files (*.xlsx;*.csv;*.tsv)|*.xlsx;*.csv;*.tsv"),
+			EFileDialogFlags::Multiple,
 			OpenedFiles
 		);
 	}
 
 	if(bOpened && OpenedFiles.Num() > 0)
 	{
-		SpreadsheetPath = OpenedFiles[0];
-		
-		UPythonBridge *bridge = UPythonBridge::Get();
-		
-		if(IsValid(bridge))
+		// The file dialog doesn't keep the order files were clicked in, so precedence goes by file name.
+		OpenedFiles.Sort([](const FString& A, const FString& B)
 		{
-			TArray<FUpdateTranslationsSettings> pages = bridge->ImportSpreadsheet(SpreadsheetPath);
-			if(pages.Num() > 0)
-			{
-				for(int i = 0; i < pages.Num(); ++i)
-				{
-					if(pages[i].Checked)
-						SelectedLanguages.Add(MakeShareable(new FUpdateTranslationsSettings(pages[i].Title, true)));
-					else
-						SelectedPages.Add(MakeShareable(new FUpdateTranslationsSettings(pages[i].Title, true)));
-				}
-			}
-		}
+			return FPaths::GetCleanFilename(A) < FPaths::GetCleanFilename(B);
+		});
+		LoadSpreadsheets(OpenedFiles);
 	}
 	
 	return FReply::Handled();
 }
 
+void SImportTranslationsDialog::LoadSpreadsheets(const TArray<FString>& Paths)
+{
+	CancelLoad();
+
+	// The lists only ever show the spreadsheets that were picked last.
+	SpreadsheetPaths = Paths;
+	SelectedPages.Reset();
+	SelectedLanguages.Reset();
+
+	SpreadsheetLoad = MakeShared<FSpreadsheetLoad, ESPMode::ThreadSafe>();
+	SpreadsheetLoad->Paths = Paths;
+
+	const TSharedPtr<FSpreadsheetLoad, ESPMode::ThreadSafe> Load = SpreadsheetLoad;
+	SpreadsheetLoadResult = Async(EAsyncExecution::ThreadPool, [Load]()
+	{
+		return FLISpreadsheet::ImportSpreadsheets(Load->Paths, Load->Settings, &Load->bCancelled);
+	});
+}
+
+void SImportTranslationsDialog::CancelLoad()
+{
+	if(SpreadsheetLoad.IsValid())
+		SpreadsheetLoad->bCancelled = true;
+
+	SpreadsheetLoad.Reset();
+	SpreadsheetLoadResult = TFuture<bool>();
+}
+
+FReply SImportTranslationsDialog::OnCancelLoadClicked()
+{
+	CancelLoad();
+	SpreadsheetPaths.Empty();
+
+	return FReply::Handled();
+}
+
+bool SImportTranslationsDialog::IsLoading() const
+{
+	return SpreadsheetLoad.IsValid();
+}
+
+EVisibility SImportTranslationsDialog::GetLoadingVisibility() const
+{
+	return IsLoading() ? EVisibility::Visible : EVisibility::Collapsed;
+}
+
+void SImportTranslationsDialog::Tick(const FGeometry& AllottedGeometry, const double InCurrentTime, const float InDeltaTime)
+{
+	SCompoundWidget::Tick(AllottedGeometry, InCurrentTime, InDeltaTime);
+
+	if(!SpreadsheetLoadResult.IsValid() || !SpreadsheetLoadResult.IsReady())
+		return;
+
+	const bool bLoaded = SpreadsheetLoadResult.Get();
+	const TSharedPtr<FSpreadsheetLoad, ESPMode::ThreadSafe> Load = SpreadsheetLoad;
+	SpreadsheetLoad.Reset();
+	SpreadsheetLoadResult = TFuture<bool>();
+
+	if(!bLoaded)
+	{
+		TArray<FString> FileNames;
+		for(const FString& Path : Load->Paths)
+			FileNames.Add(FPaths::GetCleanFilename(Path));
+
+		FNotificationInfo LoadError(FText::Format(LOCTEXT("SpreadsheetLoadFailed", "Could not find any translations in {0}."), FText::FromString(FString::Join(FileNames, TEXT(", ")))));
+		LoadError.ExpireDuration = 3.0f;
+		FSlateNotificationManager::Get().AddNotification(LoadError);
+		return;
+	}
+
+	for(const FUpdateTranslationsSettings& Setting : Load->Settings)
+	{
+		if(Setting.Checked)
+			SelectedLanguages.Add(MakeShareable(new FUpdateTranslationsSettings(Setting.Title, true)));
+		else
+			SelectedPages.Add(MakeShareable(new FUpdateTranslationsSettings(Setting.Title, true)));
+	}
+}
+
 TSharedRef<SWidget> SImportTranslationsDialog::GenerateLanguageSelector()
 {
 	return SNew(SBox)
@@ -342,6 +511,17 @@ TSharedRef<SWidget> SImportTranslationsDialog::GenerateLanguageSelector()
 	];
 }
 
+TSharedRef<SWidget> SImportTranslationsDialog::GenerateTargetSelector()
+{
+	return SNew(SBox)
+	[
+		SNew(SListView<TSharedPtr<FUpdateTranslationsSettings>>)
+		.SelectionMode(ESelectionMode::None)
+		.ListItemsSource(&SelectedTargets)
+		.OnGenerateRow(this, &SImportTranslationsDialog::OnGenerateTargetsRow)
+	];
+}
+
 TSharedRef<SWidget> SImportTranslationsDialog::GeneratePageSelector()
 {
 	return SNew(SBox)
@@ -355,16 +535,29 @@ TSharedRef<SWidget> SImportTranslationsDialog::GeneratePageSelector()
 
 FText SImportTranslationsDialog::GetFileButtonText() const
 {
-	int32 lastSlash;
-	int32 dotIdx;
-	
-	if(!SpreadsheetPath.FindLastChar('/', lastSlash))
-		SpreadsheetPath.FindLastChar('\\', lastSlash);
+	if(SpreadsheetPaths.Num() > 1)
+		return FText::Format(LOCTEXT("MultipleFilesButtonText", "{0} Spreadsheets"), FText::AsNumber(SpreadsheetPaths.Num()));
 
-	SpreadsheetPath.FindLastChar('.', dotIdx);
-	
-	return SpreadsheetPath.IsEmpty() ? LOCTEXT("FileButtonText", "Choose File...") :
-	FText::FromString(SpreadsheetPath.Mid(lastSlash + 1));
+	return SpreadsheetPaths.Num() == 0 ? LOCTEXT("FileButtonText", "Choose File...") :
+	FText::FromString(FPaths::GetCleanFilename(SpreadsheetPaths[0]));
+}
+
+FText SImportTranslationsDialog::GetFileButtonTooltip() const
+{
+	if(SpreadsheetPaths.Num() < 2)
+		return LOCTEXT("FileButtonTooltip", "Choose the spreadsheets to import. Several can be picked at once.");
+
+	FString FileList;
+	for(const FString& Path : SpreadsheetPaths)
+		FileList += TEXT("\n") + FPaths::GetCleanFilename(Path);
+
+	return FText::Format(LOCTEXT("MultipleFilesTooltip", "Rows in later spreadsheets replace the same rows in earlier ones:{0}"), FText::FromString(FileList));
+}
+
+FText SImportTranslationsDialog::GetTargetButtonText() const
+{
+	return IsTargetButtonEnabled() ? LOCTEXT("TargetBtnText", "Select Targets") :
+	LOCTEXT("DisabledTargetBtnText", "No Targets Found");
 }
 
 FText SImportTranslationsDialog::GetPageButtonText() const
@@ -384,6 +577,11 @@ EVisibility SImportTranslationsDialog::GetSettingsVisibility() const
 	return EVisibility::Visible;
 }
 
+bool SImportTranslationsDialog::IsTargetButtonEnabled() const
+{
+	return SelectedTargets.Num() > 0;
+}
+
 bool SImportTranslationsDialog::IsPageButtonEnabled() const
 {
 	return SelectedPages.Num() > 0;
@@ -396,7 +594,7 @@ ECheckBoxState SImportTranslationsDialog::IsPageSettingChecked(const TSharedPtr<
 
 bool SImportTranslationsDialog::IsProceedButtonEnabled() const
 {
-	return !SpreadsheetPath.IsEmpty();
+	return SpreadsheetPaths.Num() > 0 && !IsLoading();
 }
 
 bool SImportTranslationsDialog::IsLangButtonEnabled() const
@@ -436,6 +634,11 @@ bool SImportTranslationsDialog::MakeWritable(const FString& file, bool showError
 
 FReply SImportTranslationsDialog::OnAcceptSettings()
 {
+	TRACE_CPUPROFILER_EVENT_SCOPE(LIImport_AcceptSettings);
+
+	// Every stage from here on, up to the executor's last task, ends up in the run summary.
+	const TSharedRef<FLIRunSummary> RunSummary = MakeShared<FLIRunSummary>();
+
 	// From LocalizationTargetDetailCustomization.cpp::GatherText() Line 858
 	// Save unsaved packages.
 
@@ -446,7 +649,12 @@ FReply SImportTranslationsDialog::OnAcceptSettings()
 	const bool bNotifyNoPackagesSaved = false;
 	const bool bCanBeDeclined = true;
 	bool DidPackagesNeedSaving;
-	const bool WerePackagesSaved = FEditorFileUtils::SaveDirtyPackages(bPromptUserToSave, bSaveMapPackages, bSaveContentPackages, bFastSave, bNotifyNoPackagesSaved, bCanBeDeclined, &DidPackagesNeedSaving);
+	bool WerePackagesSaved;
+	{
+		TRACE_CPUPROFILER_EVENT_SCOPE(LIImport_SavePackages);
+		FLIRunSummary::FScopedStage Stage(*RunSummary, TEXT("Save Packages"));
+		WerePackagesSaved = FEditorFileUtils::SaveDirtyPackages(bPromptUserToSave, bSaveMapPackages, bSaveContentPackages, bFastSave, bNotifyNoPackagesSaved, bCanBeDeclined, &DidPackagesNeedSaving);
+	}
 
 	if(DidPackagesNeedSaving && !WerePackagesSaved)
 	{
@@ -459,6 +667,9 @@ FReply SImportTranslationsDialog::OnAcceptSettings()
 	}
 
 	{
+		TRACE_CPUPROFILER_EVENT_SCOPE(LIImport_CheckOutConfig);
+		FLIRunSummary::FScopedStage Stage(*RunSummary, TEXT("Check Out Config"));
+
 		FString ConfigFilePath = FPaths::ProjectConfigDir() / "DefaultEditor.ini";
 		bool bSuccess = CheckOutOrAddFile(ConfigFilePath, true);
 
@@ -468,89 +679,73 @@ FReply SImportTranslationsDialog::OnAcceptSettings()
 
 	const TSharedPtr<SWindow> ParentWindow = FSlateApplication::Get().FindWidgetWindow(this->AsShared());
 
-	// From LocalizationCommandletTasks.cpp::GatherTextForTarget() Line 37
-	ULocalizationTargetSet *GameTargetSet = ULocalizationSettings::GetGameTargetSet();
+	// The picked targets, in the order the target set has them
 	TArray<ULocalizationTarget*> Targets;
-
-	if(GameTargetSet)
-		Targets.Append(GameTargetSet->TargetObjects);
+	for(ULocalizationTarget* Target : FLIImport::GetGameTargets())
+	{
+		const TSharedPtr<FUpdateTranslationsSettings>* Selected = SelectedTargets.FindByPredicate([Target](const TSharedPtr<FUpdateTranslationsSettings>& Item) { return Item->Title == Target->Settings.Name; });
+		if(Selected && (*Selected)->Checked)
+			Targets.Add(Target);
+	}
 
 	if(Targets.Num() > 0)
 	{
+		FLIImportRequest Request;
+		Request.Spreadsheets = SpreadsheetPaths;
+		Request.bCaseSensitive = IsCaseSensitive;
+		Request.bForceRefresh = bForceRefresh;
+		Request.bMatchByKey = bMatchByKey;
+		Request.bQuickCompile = bQuickCompile;
+
+		for(int i = 0; i < SelectedPages.Num(); ++i)
 		{
-			UPythonBridge *Bridge = UPythonBridge::Get();
+			if(SelectedPages[i]->Checked)
+				Request.Pages.Add(SelectedPages[i]->Title);
+		}
 
-			if(Bridge)
-			{
-				FString Pages = "";
-				FString Langs = "";
-				int32 PageLen = 0, LangLen = 0;
+		for(int i = 0; i < SelectedLanguages.Num(); ++i)
+		{
+			if(SelectedLanguages[i]->Checked)
+				Request.Languages.Add(SelectedLanguages[i]->Title);
+		}
 
-				for(int i = 0; i < SelectedPages.Num(); ++i)
-				{
-					if(SelectedPages[i]->Checked)
-					{
-						Pages += SelectedPages[i]->Title + "\n";
-						++PageLen;
-					}
-				}					
-
-				for(int i = 0; i < SelectedLanguages.Num(); ++i)
-				{
-					if(SelectedLanguages[i]->Checked)
-					{
-						Langs += SelectedLanguages[i]->Title + "\n";
-						++LangLen;
-					}
-				}
+		// One import per target, each a chain of tasks that waits for the targets it depends on.
+		// The first one builds the translation table, the others find it up to date.
+		TArray<FLIImport> Imports;
+		TArray<FLITaskChain> TaskChains;
+		TArray<FString> TargetNames;
+		int32 NumTasks = 0;
+		for(int32 TargetIndex = 0; TargetIndex < Targets.Num(); ++TargetIndex)
+		{
+			FLIImport& Import = Imports.AddDefaulted_GetRef();
+			FText ErrMessageText;
+			if(!Import.Prepare(Targets[TargetIndex], Request, *RunSummary, ErrMessageText))
+			{
+				const FText ErrMessageTitle = LOCTEXT("SettingsErrorTitle", "Error!");
 
-				Bridge->UpdateSelection(SpreadsheetPath, FString::Printf(TEXT("%d %d\n%s"), PageLen, LangLen, *Pages), Langs, bForceRefresh, IsCaseSensitive);
+				FMessageDialog::Open(EAppMsgType::Ok, ErrMessageText, &ErrMessageTitle);
+				return FReply::Handled();
 			}
 		}
-		
-		ULocalizationTarget *LocalizationTarget = Targets[0];
-		TArray<LocalizationCommandletExecution::FTask> Tasks;
-        const bool bShouldUseProjectFile = true; // True because we're targeting game content separate from engine
 
-		// GatherText setup
-        const FString GatherScriptPath = LocalizationConfigurationScript::GetGatherTextConfigPath(LocalizationTarget);
-		LocalizationConfigurationScript::GenerateGatherTextConfigFile(LocalizationTarget).WriteWithSCC(GatherScriptPath);
+		// Fingerprints can't see a gather that runs earlier in this import.
+		TArray<FLIImport*> ImportPtrs;
+		for(FLIImport& Import : Imports)
+			ImportPtrs.Add(&Import);
+		FLIImport::InvalidateDependentGathers(ImportPtrs, Targets);
 
-		Tasks.Add(LocalizationCommandletExecution::FTask(LOCTEXT("GatherTaskName", "Gather Text"), GatherScriptPath, bShouldUseProjectFile));
-
-		// ExportText setup
-		const FString ExportPath = FPaths::ConvertRelativePathToFull(LocalizationConfigurationScript::GetDataDirectory(LocalizationTarget));
-		const FString ExportScriptPath = LocalizationConfigurationScript::GetExportTextConfigPath(LocalizationTarget, TOptional<FString>());
-		LocalizationConfigurationScript::GenerateExportTextConfigFile(LocalizationTarget, TOptional<FString>(), ExportPath).WriteWithSCC(ExportScriptPath);
-		
-		Tasks.Add(LocalizationCommandletExecution::FTask(LOCTEXT("ExportTaskName", "Export Translations"), ExportScriptPath, bShouldUseProjectFile));
-
-		//Super Special Python Task
-		const FString PluginPath = IPluginManager::Get().FindPlugin("LocalizationImporter")->GetBaseDir();
-		const FString PythonScriptPath = FPaths::Combine(*PluginPath, TEXT("Content/Python"));
-		
-		// Apparently there's a bug in 4.24 where the python command can take files directly,
-		// but won't work if the path has spaces (even with quotes).
-		// This is a workaround to pass in literal code that imports and runs the script.
-		const FString PythonCode = FString::Printf(TEXT("import os\\nimport sys\\nsys.path.append('%s')\\nfrom update_translations import *\\nupdate()"), *PythonScriptPath);
-		Tasks.Add(LocalizationCommandletExecution::FTask(LOCTEXT("PythonTask","(Python) Update Translations"), PythonCode, true));
-
-		// ImportText setup
-		const FString ImportScriptPath = LocalizationConfigurationScript::GetImportTextConfigPath(LocalizationTarget, TOptional<FString>());
-		LocalizationConfigurationScript::GenerateImportTextConfigFile(LocalizationTarget, TOptional<FString>(), ExportPath).WriteWithSCC(ImportScriptPath);
-		Tasks.Add(LocalizationCommandletExecution::FTask(LOCTEXT("ImportTaskName", "Import Translations"), ImportScriptPath, bShouldUseProjectFile));
-
-		const FString ReportScriptPath = LocalizationConfigurationScript::GetWordCountReportConfigPath(LocalizationTarget);
-		LocalizationConfigurationScript::GenerateWordCountReportConfigFile(LocalizationTarget).WriteWithSCC(ReportScriptPath);
-		Tasks.Add(LocalizationCommandletExecution::FTask(LOCTEXT("ReportTaskName", "Generate Reports"), ReportScriptPath, bShouldUseProjectFile));
-
-		// CompileText setup
-		const FString CompileScriptPath = LocalizationConfigurationScript::GetCompileTextConfigPath(LocalizationTarget);
-		LocalizationConfigurationScript::GenerateCompileTextConfigFile(LocalizationTarget).WriteWithSCC(CompileScriptPath);
-		Tasks.Add(LocalizationCommandletExecution::FTask(LOCTEXT("CompileTaskName", "Compile Translations"), CompileScriptPath, bShouldUseProjectFile));
+		for(int32 TargetIndex = 0; TargetIndex < Targets.Num(); ++TargetIndex)
+		{
+			FLITaskChain& TaskChain = TaskChains.AddDefaulted_GetRef();
+			TaskChain.Name = Targets[TargetIndex]->Settings.Name;
+			TaskChain.Tasks = Imports[TargetIndex].GetTasks();
+			TaskChain.Dependencies = FLIImport::FindDependencies(Targets, TargetIndex);
+			TargetNames.Add(TaskChain.Name);
+			NumTasks += TaskChain.Tasks.Num();
+		}
 
 		FFormatNamedArguments Arguments;
-		Arguments.Add(TEXT("TargetName"), FText::FromString(LocalizationTarget->Settings.Name));
+		Arguments.Add(TEXT("TargetName"), FText::FromString(FString::Join(TargetNames, TEXT(", "))));
 		const FText windowTitle = FText::Format(LOCTEXT("LocalizationTaskWindowTitle", "Updating Translations for ({TargetName})"), Arguments);
 		const TSharedRef<SWindow> CommandletWindow = SNew(SWindow)
 		.Title(windowTitle)
@@ -559,28 +754,57 @@ FReply SImportTranslationsDialog::OnAcceptSettings()
 		.ClientSize(FVector2D(600, 400))
 		.ActivationPolicy(EWindowActivationPolicy::Always)
 		.FocusWhenFirstShown(true);
-		const TSharedRef<SLICommandletExecutor> CommandletExecutor = SNew(SLICommandletExecutor, CommandletWindow, Tasks);
-		CommandletWindow->SetContent(CommandletExecutor);
+		// Reported as soon as the translations are compiled, while background tasks such as the reports may still be running.
+		TSharedPtr<SLICommandletExecutor> CommandletExecutor;
+		bool bImportsFinished = false;
+		const auto FinishImports = [&Imports, &CommandletExecutor, &bImportsFinished]()
+		{
+			if(bImportsFinished)
+				return;
+			bImportsFinished = true;
+
+			// Each target keeps what it got through, even when another one failed.
+			TArray<FString> CompiledCultures;
+			for(int32 TargetIndex = 0; TargetIndex < Imports.Num(); ++TargetIndex)
+			{
+				const FLIImport& Import = Imports[TargetIndex];
+				Import.Finish(CommandletExecutor->WasChainSuccessful(TargetIndex), CommandletExecutor->DidTaskRun(TargetIndex, Import.GetGatherTaskIndex()));
+
+				if(CommandletExecutor->DidTaskRun(TargetIndex, Import.GetCompileTaskIndex()))
+				{
+					for(const FLIApplySettings::FCulture& Culture : Import.GetApplySettings().Cultures)
+						CompiledCultures.AddUnique(Culture.Culture);
+				}
+			}
+
+			// So the new translations show up in the editor, and PIE, before the dialog is even closed.
+			FLIImport::ReloadTranslations(CompiledCultures);
+
+			if(!CommandletExecutor->WasSuccessful())
+				FMessageDialog::Open(EAppMsgType::Ok, LOCTEXT("TaskFailed", "Update Failed\nPlease Check your setup and try again."));
+			else if(CommandletExecutor->HasBackgroundWork())
+				FMessageDialog::Open(EAppMsgType::Ok, LOCTEXT("TaskPassedReportsPending", "Update Successful!\nThe word count reports are still being generated, the task list links to them once they're done."));
+			else
+				FMessageDialog::Open(EAppMsgType::Ok, LOCTEXT("TaskPassed", "Update Successful!"));
+		};
+
+		const ULIImporterSettings* ImporterSettings = GetDefault<ULIImporterSettings>();
+		CommandletExecutor = SNew(SLICommandletExecutor, CommandletWindow, TaskChains)
+		.SingleProcess(ImporterSettings->bRunInSingleProcess)
+		.MaxParallelChains(ULIImporterSettings::GetNumWorkers(ImporterSettings->MaxParallelTargets, TaskChains.Num()))
+		.MaxParallelTasks(ULIImporterSettings::GetNumWorkers(ImporterSettings->MaxParallelTasks, NumTasks))
+		.RunSummary(RunSummary)
+		.OnCompleted_Lambda(FinishImports);
+		CommandletWindow->SetContent(CommandletExecutor.ToSharedRef());
 
 		FSlateApplication::Get().AddModalWindow(CommandletWindow, ParentWindow, false);
 
-		bool bSuccessful = CommandletExecutor->WasSuccessful();
+		// A cancelled run never completed.
+		FinishImports();
 
-		if(bSuccessful)
-		{
-			FMessageDialog::Open(EAppMsgType::Ok, LOCTEXT("TaskPassed", "Update Successful!"));
-			if(ParentWindowPtr.IsValid())
-            {
-            	ParentWindowPtr.Pin()->RequestDestroyWindow();
-            }
-		}			
-		else
+		if(ParentWindowPtr.IsValid())
 		{
-			FMessageDialog::Open(EAppMsgType::Ok, LOCTEXT("TaskFailed", "Update Failed\nPlease Check your setup and try again."));
-			if(ParentWindowPtr.IsValid())
-			{
-				ParentWindowPtr.Pin()->RequestDestroyWindow();
-			}
+			ParentWindowPtr.Pin()->RequestDestroyWindow();
 		}
 	}
 	else
@@ -596,6 +820,8 @@ FReply SImportTranslationsDialog::OnAcceptSettings()
 
 FReply SImportTranslationsDialog::OnCancelSettings()
 {
+	CancelLoad();
+
 	if(ParentWindowPtr.IsValid())
 	{
 		ParentWindowPtr.Pin()->RequestDestroyWindow();
@@ -634,6 +860,57 @@ void SImportTranslationsDialog::OnForceRefreshChecked(ECheckBoxState state)
 	}
 }
 
+void SImportTranslationsDialog::OnMatchByKeyChecked(ECheckBoxState state)
+{
+	switch (state)
+	{
+	case ECheckBoxState::Checked:
+		bMatchByKey = true;
+		break;
+	case ECheckBoxState::Unchecked:
+	case ECheckBoxState::Undetermined:
+		bMatchByKey = false;
+		break;
+	}
+}
+
+void SImportTranslationsDialog::OnQuickCompileChecked(ECheckBoxState state)
+{
+	switch (state)
+	{
+	case ECheckBoxState::Checked:
+		bQuickCompile = true;
+		break;
+	case ECheckBoxState::Unchecked:
+	case ECheckBoxState::Undetermined:
+		bQuickCompile = false;
+		break;
+	}
+}
+
+TSharedRef<ITableRow> SImportTranslationsDialog::OnGenerateTargetsRow(TSharedPtr<FUpdateTranslationsSettings> item, const TSharedRef<STableViewBase>& table)
+{
+	return SNew(STableRow<TSharedPtr<FUpdateTranslationsSettings>>, table)
+	.ShowSelection(true)
+	.Content()
+	[
+		SNew(SCheckBox)
+		.OnCheckStateChanged_Lambda([item](ECheckBoxState state)
+		{
+			item->Checked = state == ECheckBoxState::Checked;
+		})
+		.IsChecked_Lambda([item]()->ECheckBoxState
+		{
+			return item->Checked ? ECheckBoxState::Checked : ECheckBoxState::Unchecked;
+		})
+		.Content()
+		[
+			SNew(STextBlock)
+			.Text(FText::FromString(item->Title))
+		]
+	];
+}
+
 TSharedRef<ITableRow> SImportTranslationsDialog::OnGeneratePagesRow(TSharedPtr<FUpdateTranslationsSettings> item, const TSharedRef<STableViewBase>& table)
 {
 	return SNew(STableRow<TSharedPtr<FUpdateTranslationsSettings>>, table)
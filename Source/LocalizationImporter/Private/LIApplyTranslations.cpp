@@ -0,0 +1,435 @@
+// Copyright (C) 2022 Dakarai Simmons - All Rights Reserved
+
+#include "LIApplyTranslations.h"
+#include "LITranslationTable.h"
+#include "LIPortableObject.h"
+#include "LIImporterSettings.h"
+#include "LIProgress.h"
+#include "LocalizationImporter.h"
+#include "Async/Async.h"
+#include "Hash/CityHash.h"
+#include "Dom/JsonObject.h"
+#include "Serialization/JsonReader.h"
+#include "Serialization/JsonSerializer.h"
+#include "Serialization/JsonWriter.h"
+#include "HAL/FileManager.h"
+#include "Internationalization/Culture.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+
+namespace LIApply
+{
+	// The column titles our spreadsheets use, mapped to culture codes.
+	static const TCHAR* const LanguageCodes[][2] =
+	{
+		{ TEXT("English"), TEXT("en") },
+		{ TEXT("Spanish (Latin America)"), TEXT("es") },
+		{ TEXT("Spanish (Spain)"), TEXT("es-ES") },
+		{ TEXT("Chinese"), TEXT("zh-Hans") },
+		{ TEXT("Japanese"), TEXT("ja-JP") },
+		{ TEXT("French"), TEXT("fr") },
+		{ TEXT("Russian"), TEXT("ru") },
+		{ TEXT("Polish"), TEXT("pl") },
+		{ TEXT("German"), TEXT("de") },
+		{ TEXT("Korean"), TEXT("ko") }
+	};
+
+	// Keeps a row's key from sharing a manifest slot with an English text that happens to read the same.
+	static const uint64 KeyHashSeed = 0x4C494B4559ull;
+
+	static uint64 HashRowKey(const FLIUtf8View& Key)
+	{
+		return CityHash64WithSeed(Key.Data, Key.Len, KeyHashSeed);
+	}
+
+	static TArray<TSharedPtr<FJsonValue>> ToJsonArray(const TArray<FString>& Strings)
+	{
+		TArray<TSharedPtr<FJsonValue>> Values;
+		for(const FString& String : Strings)
+			Values.Add(MakeShared<FJsonValueString>(String));
+		return Values;
+	}
+}
+
+bool FLIApplySettings::SaveToFile(const FString& Path) const
+{
+	const TSharedRef<FJsonObject> Root = MakeShared<FJsonObject>();
+	Root->SetStringField(TEXT("Target"), Target);
+	Root->SetArrayField(TEXT("Spreadsheets"), LIApply::ToJsonArray(Spreadsheets));
+	Root->SetStringField(TEXT("Table"), TablePath);
+	Root->SetArrayField(TEXT("Pages"), LIApply::ToJsonArray(Pages));
+	Root->SetBoolField(TEXT("CaseSensitive"), bCaseSensitive);
+	Root->SetBoolField(TEXT("ForceRefresh"), bForceRefresh);
+	Root->SetBoolField(TEXT("MatchByKey"), bMatchByKey);
+	Root->SetNumberField(TEXT("MaxParallelCultures"), MaxParallelCultures);
+
+	TArray<TSharedPtr<FJsonValue>> CultureValues;
+	for(const FCulture& Culture : Cultures)
+	{
+		const TSharedRef<FJsonObject> CultureObject = MakeShared<FJsonObject>();
+		CultureObject->SetStringField(TEXT("Language"), Culture.Language);
+		CultureObject->SetStringField(TEXT("Culture"), Culture.Culture);
+		CultureObject->SetStringField(TEXT("POPath"), Culture.POPath);
+		CultureValues.Add(MakeShared<FJsonValueObject>(CultureObject));
+	}
+	Root->SetArrayField(TEXT("Cultures"), CultureValues);
+
+	FString Json;
+	const TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&Json);
+	return FJsonSerializer::Serialize(Root, Writer) && FFileHelper::SaveStringToFile(Json, *Path, FFileHelper::EEncodingOptions::ForceUTF8WithoutBOM);
+}
+
+bool FLIApplySettings::LoadFromFile(const FString& Path)
+{
+	FString Json;
+	if(!FFileHelper::LoadFileToString(Json, *Path))
+		return false;
+
+	TSharedPtr<FJsonObject> Root;
+	const TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(Json);
+	if(!FJsonSerializer::Deserialize(Reader, Root) || !Root.IsValid())
+		return false;
+
+	Root->TryGetStringField(TEXT("Target"), Target);
+	Spreadsheets.Reset();
+	Root->TryGetStringArrayField(TEXT("Spreadsheets"), Spreadsheets);
+	Root->TryGetStringField(TEXT("Table"), TablePath);
+	Root->TryGetStringArrayField(TEXT("Pages"), Pages);
+	bCaseSensitive = Root->GetBoolField(TEXT("CaseSensitive"));
+	bForceRefresh = Root->GetBoolField(TEXT("ForceRefresh"));
+	Root->TryGetBoolField(TEXT("MatchByKey"), bMatchByKey);
+	Root->TryGetNumberField(TEXT("MaxParallelCultures"), MaxParallelCultures);
+
+	Cultures.Reset();
+	const TArray<TSharedPtr<FJsonValue>>* CultureValues;
+	if(Root->TryGetArrayField(TEXT("Cultures"), CultureValues))
+	{
+		for(const TSharedPtr<FJsonValue>& Value : *CultureValues)
+		{
+			const TSharedPtr<FJsonObject> CultureObject = Value->AsObject();
+			if(CultureObject.IsValid())
+			{
+				FCulture& Culture = Cultures.AddDefaulted_GetRef();
+				Culture.Language = CultureObject->GetStringField(TEXT("Language"));
+				Culture.Culture = CultureObject->GetStringField(TEXT("Culture"));
+				Culture.POPath = CultureObject->GetStringField(TEXT("POPath"));
+			}
+		}
+	}
+
+	return Spreadsheets.Num() > 0;
+}
+
+FString FLIApplySettings::GetDefaultPath(const FString& TargetName)
+{
+	return FPaths::ConvertRelativePathToFull(FPaths::ProjectSavedDir() / TEXT("LocalizationImporter") / (TargetName + TEXT(".ApplyTranslations.json")));
+}
+
+uint64 FLIApplySettings::GetCultureSettingsHash(const FCulture& Culture) const
+{
+	FString Key = FString::Join(Pages, TEXT("\n"));
+	Key += FString::Printf(TEXT("\n%d\n%d\n%s"), bCaseSensitive ? 1 : 0, bMatchByKey ? 1 : 0, *Culture.Language);
+	return CityHash64((const char*)*Key, Key.Len() * sizeof(TCHAR));
+}
+
+FString FLIApplySettings::FindCultureForLanguage(const FString& Language, const TArray<FString>& TargetCultures)
+{
+	for(const auto& LanguageCode : LIApply::LanguageCodes)
+	{
+		if(Language.Equals(LanguageCode[0], ESearchCase::CaseSensitive))
+			return TargetCultures.Contains(LanguageCode[1]) ? FString(LanguageCode[1]) : FString();
+	}
+
+	// Otherwise accept a column titled with the culture code itself, or the culture's English name.
+	for(const FString& CultureName : TargetCultures)
+	{
+		if(Language.Equals(CultureName))
+			return CultureName;
+
+		const FCulturePtr Culture = FInternationalization::Get().GetCulture(CultureName);
+		if(Culture.IsValid() && Language.Equals(Culture->GetEnglishName()))
+			return CultureName;
+	}
+
+	return FString();
+}
+
+bool FLIApplyTranslations::Run(const FLIApplySettings& Settings)
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(LIApplyTranslations_Run);
+
+	const int32 NumCultures = Settings.Cultures.Num();
+
+	// Whatever an earlier, unfinished import left pending no longer applies.
+	FLIImportManifest::DiscardPending(Settings.Target);
+
+	FLIImportManifest Manifest;
+	Manifest.Load(FLIImportManifest::GetPath(Settings.Target));
+
+	const uint64 SpreadsheetHash = FLIImportManifest::HashFiles(Settings.Spreadsheets);
+
+	TArray<FLIImportManifest::FCultureRecord> Records;
+	Records.SetNum(NumCultures);
+	TArray<const FLIImportManifest::FCultureRecord*> Previous;
+	Previous.Init(nullptr, NumCultures);
+
+	TArray<FString> Languages;
+	TArray<int32> OutdatedCultures;
+	for(int32 Index = 0; Index < NumCultures; ++Index)
+	{
+		const FLIApplySettings::FCulture& Culture = Settings.Cultures[Index];
+		FLIImportManifest::FCultureRecord& Record = Records[Index];
+		Record.SettingsHash = Settings.GetCultureSettingsHash(Culture);
+		Record.SpreadsheetHash = SpreadsheetHash;
+		Record.POHash = FLIImportManifest::HashFile(Culture.POPath);
+
+		// Only a .po file that's exactly as the last import left it can be updated incrementally.
+		const FLIImportManifest::FCultureRecord* Last = Manifest.FindCulture(Culture.POPath);
+		if(!Settings.bForceRefresh && Last && Last->SettingsHash == Record.SettingsHash && Last->POHash == Record.POHash)
+		{
+			if(Last->SpreadsheetHash == Record.SpreadsheetHash)
+			{
+				UE_LOG(LocalizationImporterPlugin, Display, TEXT("%s (%s) is up to date."), *Culture.Language, *Culture.Culture);
+				continue;
+			}
+
+			Previous[Index] = Last;
+		}
+
+		OutdatedCultures.Add(Index);
+		Languages.AddUnique(Culture.Language);
+	}
+
+	if(OutdatedCultures.Num() == 0)
+	{
+		UE_LOG(LocalizationImporterPlugin, Display, TEXT("Nothing changed since the last import."));
+		return true;
+	}
+
+	const double BuildStartTime = FPlatformTime::Seconds();
+
+	// The table saved when the import was prepared is used as is, as long as it was built from these very spreadsheets.
+	FLITranslationTable Table;
+	const uint64 TableSourceHash = FLITranslationTable::HashSource(SpreadsheetHash, Settings.Pages, Settings.bCaseSensitive);
+	if(!Settings.TablePath.IsEmpty() && Table.Load(Settings.TablePath, TableSourceHash) && Table.HasLanguages(Languages))
+	{
+		UE_LOG(LocalizationImporterPlugin, Display, TEXT("Mapped %d phrases from '%s' in %.2f seconds."), Table.Num(), *Settings.TablePath, FPlatformTime::Seconds() - BuildStartTime);
+	}
+	else
+	{
+		if(!Table.Build(Settings.Spreadsheets, Settings.Pages, Languages, Settings.bCaseSensitive))
+			return false;
+
+		UE_LOG(LocalizationImporterPlugin, Display, TEXT("Read %d phrases from '%s' in %.2f seconds."), Table.Num(), *FString::Join(Settings.Spreadsheets, TEXT("', '")), FPlatformTime::Seconds() - BuildStartTime);
+	}
+
+	const int32 NumOutdated = OutdatedCultures.Num();
+	const int32 NumWorkers = ULIImporterSettings::GetNumWorkers(Settings.MaxParallelCultures, NumOutdated);
+	const double ApplyStartTime = FPlatformTime::Seconds();
+
+	TArray<FLIApplyResult> Results;
+	Results.SetNum(NumCultures);
+	TArray<bool> Succeeded;
+	Succeeded.Init(false, NumCultures);
+
+	// Each worker keeps taking the next culture until there are none left, so a slow culture doesn't hold up the rest.
+	FThreadSafeCounter NextCulture;
+	FThreadSafeCounter NumDone;
+	auto Worker = [&]()
+	{
+		for(int32 Next = NextCulture.Increment() - 1; Next < NumOutdated; Next = NextCulture.Increment() - 1)
+		{
+			const int32 Index = OutdatedCultures[Next];
+			Succeeded[Index] = ApplyCulture(Table, Settings, Settings.Cultures[Index], Previous[Index], Records[Index], Results[Index]);
+			FLIProgress::Report(NumDone.Increment(), NumOutdated);
+		}
+	};
+
+	TArray<TFuture<void>> Futures;
+	for(int32 WorkerIndex = 1; WorkerIndex < NumWorkers; ++WorkerIndex)
+		Futures.Add(Async(EAsyncExecution::ThreadPool, Worker));
+
+	// This thread is the first worker.
+	Worker();
+
+	for(TFuture<void>& Future : Futures)
+		Future.Wait();
+
+	bool bSuccess = true;
+	double SlowestCulture = 0.0;
+	double TotalCultureTime = 0.0;
+	for(const int32 Index : OutdatedCultures)
+	{
+		bSuccess &= Succeeded[Index];
+		SlowestCulture = FMath::Max(SlowestCulture, Results[Index].Seconds);
+		TotalCultureTime += Results[Index].Seconds;
+	}
+
+	UE_LOG(LocalizationImporterPlugin, Display, TEXT("Applied %d cultures on %d threads in %.2f seconds (slowest culture %.2f seconds, %.2f seconds combined)."),
+		NumOutdated, NumWorkers, FPlatformTime::Seconds() - ApplyStartTime, SlowestCulture, TotalCultureTime);
+
+	if(!bSuccess)
+		return false;
+
+	// A .po file that changed since the last import (a new gather, or one that was never imported) has to go
+	// through import and compile even if nothing was written to it, anything else only if it was written to.
+	bool bNeedsImport = false;
+	for(const int32 Index : OutdatedCultures)
+		bNeedsImport |= Previous[Index] == nullptr || Results[Index].NumUpdated > 0;
+
+	// Cultures that were already up to date keep their record, cultures outside this import keep theirs too.
+	for(const int32 Index : OutdatedCultures)
+		Manifest.FindOrAddCulture(Settings.Cultures[Index].POPath) = MoveTemp(Records[Index]);
+
+	if(!bNeedsImport)
+		UE_LOG(LocalizationImporterPlugin, Display, TEXT("The spreadsheet changed, but none of the changes affect the selected cultures."));
+
+	const FString ManifestPath = bNeedsImport ? FLIImportManifest::GetPendingPath(Settings.Target) : FLIImportManifest::GetPath(Settings.Target);
+	if(!Manifest.Save(ManifestPath))
+	{
+		UE_LOG(LocalizationImporterPlugin, Error, TEXT("Could not write '%s'."), *ManifestPath);
+		return false;
+	}
+
+	return true;
+}
+
+bool FLIApplyTranslations::ApplyCulture(const FLITranslationTable& Table, const FLIApplySettings& Settings, const FLIApplySettings::FCulture& Culture,
+	const FLIImportManifest::FCultureRecord* Previous, FLIImportManifest::FCultureRecord& OutRecord, FLIApplyResult& OutResult)
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(LIApplyTranslations_ApplyCulture);
+
+	const double StartTime = FPlatformTime::Seconds();
+	const int32 LanguageIndex = Table.GetLanguageIndex(Culture.Language);
+
+	OutRecord.Entries.Reset();
+	OutRecord.Entries.Reserve(Table.Num());
+	for(int32 TableIndex = 0; TableIndex < Table.Num(); ++TableIndex)
+	{
+		// Later rows overwrite earlier ones, the same way the table's lookups resolve them.
+		const uint64 TranslationHash = FLIImportManifest::HashText(Table.GetTranslation(TableIndex, LanguageIndex));
+		OutRecord.Entries.Add(FLIImportManifest::HashText(Table.GetSource(TableIndex)), TranslationHash);
+
+		const FLIUtf8View RowKey = Table.GetKey(TableIndex);
+		if(Settings.bMatchByKey && !RowKey.IsEmpty())
+			OutRecord.Entries.Add(LIApply::HashRowKey(RowKey), TranslationHash);
+	}
+
+	// Keys and English texts that were added, removed or translated differently since the last import.
+	TSet<uint64> ChangedKeys;
+	bool bEntriesRemoved = false;
+	if(Previous)
+	{
+		for(const TPair<uint64, uint64>& Entry : OutRecord.Entries)
+		{
+			const uint64* LastTranslation = Previous->Entries.Find(Entry.Key);
+			if(!LastTranslation || *LastTranslation != Entry.Value)
+				ChangedKeys.Add(Entry.Key);
+		}
+
+		for(const TPair<uint64, uint64>& Entry : Previous->Entries)
+		{
+			if(!OutRecord.Entries.Contains(Entry.Key))
+			{
+				ChangedKeys.Add(Entry.Key);
+				bEntriesRemoved = true;
+			}
+		}
+	}
+
+	FLIPortableObject PortableObject;
+	if(!PortableObject.Load(Culture.POPath))
+	{
+		UE_LOG(LocalizationImporterPlugin, Error, TEXT("Could not read '%s' for %s."), *Culture.POPath, *Culture.Language);
+		return false;
+	}
+
+	const TArray<FLIPortableObject::FEntry>& Entries = PortableObject.GetEntries();
+
+	TArray<FLIPortableObject::FReplacement> Replacements;
+	TArray<ANSICHAR> MsgCtxtScratch;
+	TArray<ANSICHAR> MsgIdScratch;
+	TArray<ANSICHAR> MsgStrScratch;
+	TArray<ANSICHAR> KeyScratch;
+
+	for(int32 EntryIndex = 0; EntryIndex < Entries.Num(); ++EntryIndex)
+	{
+		const FLIPortableObject::FEntry& Entry = Entries[EntryIndex];
+
+		// The header entry has an empty msgid.
+		const FLIUtf8View MsgId = PortableObject.GetString(Entry.MsgId, MsgIdScratch);
+		if(MsgId.IsEmpty())
+			continue;
+
+		// The row with the entry's key wins; English text is only the fallback for rows without one.
+		int32 TableIndex = INDEX_NONE;
+		bool bChanged = !Previous;
+		if(Settings.bMatchByKey && Entry.MsgCtxt.Len > 0)
+		{
+			TableIndex = Table.FindByContext(PortableObject.GetString(Entry.MsgCtxt, MsgCtxtScratch));
+			if(TableIndex != INDEX_NONE)
+				bChanged |= ChangedKeys.Contains(LIApply::HashRowKey(Table.GetKey(TableIndex)));
+			else
+				bChanged |= bEntriesRemoved; // Its key may have just been taken out of the spreadsheet.
+		}
+
+		if(TableIndex == INDEX_NONE)
+		{
+			const FLIUtf8View LookupKey = Table.MakeLookupKey(MsgId, KeyScratch);
+			TableIndex = Table.Find(LookupKey);
+			bChanged |= ChangedKeys.Contains(FLIImportManifest::HashText(LookupKey));
+		}
+
+		if(!bChanged)
+			continue;
+
+		++OutResult.NumEntries;
+
+		const FLIUtf8View MsgStr = PortableObject.GetString(Entry.MsgStr, MsgStrScratch);
+		if(!Settings.bForceRefresh && !MsgStr.IsEmpty())
+			continue;
+
+		if(TableIndex != INDEX_NONE)
+			++OutResult.NumMatched;
+
+		// A forced refresh also clears translations the spreadsheet no longer has.
+		const FLIUtf8View Translation = Table.GetTranslation(TableIndex, LanguageIndex);
+		if(Translation.Len == MsgStr.Len && (MsgStr.Len == 0 || FMemory::Memcmp(Translation.Data, MsgStr.Data, MsgStr.Len) == 0))
+			continue;
+
+		Replacements.Add({ EntryIndex, Translation });
+	}
+
+	OutResult.NumUpdated = Replacements.Num();
+
+	// Leave the file (and its timestamp) alone when nothing changed.
+	if(Replacements.Num() > 0)
+	{
+		const FString TempPath = Culture.POPath + TEXT(".tmp");
+		if(!PortableObject.Save(TempPath, Replacements))
+		{
+			IFileManager::Get().Delete(*TempPath);
+			return false;
+		}
+
+		// The mapping has to be released before the file it maps can be replaced.
+		PortableObject.Unload();
+
+		if(!IFileManager::Get().Move(*Culture.POPath, *TempPath, true, true))
+		{
+			UE_LOG(LocalizationImporterPlugin, Error, TEXT("Could not replace '%s'."), *Culture.POPath);
+			IFileManager::Get().Delete(*TempPath);
+			return false;
+		}
+
+		OutRecord.POHash = FLIImportManifest::HashFile(Culture.POPath);
+	}
+
+	OutResult.Seconds = FPlatformTime::Seconds() - StartTime;
+
+	UE_LOG(LocalizationImporterPlugin, Display, TEXT("%s (%s): %d entries, %d matched, %d updated in %.2f seconds."),
+		*Culture.Language, *Culture.Culture, OutResult.NumEntries, OutResult.NumMatched, OutResult.NumUpdated, OutResult.Seconds);
+
+	return true;
+}
@@ -0,0 +1,41 @@
+// Copyright (C) 2022 Dakarai Simmons - All Rights Reserved
+
+#include "LIApplyTranslationsCommandlet.h"
+#include "LIApplyTranslations.h"
+#include "LocalizationImporter.h"
+#include "Misc/Paths.h"
+
+ULIApplyTranslationsCommandlet::ULIApplyTranslationsCommandlet()
+{
+	IsClient = false;
+	IsEditor = true;
+	IsServer = false;
+	LogToConsole = true;
+}
+
+int32 ULIApplyTranslationsCommandlet::Main(const FString& Params)
+{
+	TArray<FString> Tokens;
+	TArray<FString> Switches;
+	TMap<FString, FString> ParamVals;
+	UCommandlet::ParseCommandLine(*Params, Tokens, Switches, ParamVals);
+
+	FString ConfigPath = ParamVals.FindRef(TEXT("config"));
+	if(ConfigPath.IsEmpty())
+	{
+		UE_LOG(LocalizationImporterPlugin, Error, TEXT("No settings file given. Use -config=\"<path>\"."));
+		return -1;
+	}
+
+	if(FPaths::IsRelative(ConfigPath))
+		ConfigPath = FPaths::Combine(FPaths::ProjectDir(), ConfigPath);
+
+	FLIApplySettings Settings;
+	if(!Settings.LoadFromFile(ConfigPath))
+	{
+		UE_LOG(LocalizationImporterPlugin, Error, TEXT("Could not read settings from '%s'."), *ConfigPath);
+		return -1;
+	}
+
+	return FLIApplyTranslations::Run(Settings) ? 0 : -1;
+}
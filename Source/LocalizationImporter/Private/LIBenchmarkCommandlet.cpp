@@ -0,0 +1,649 @@
+// Copyright (C) 2022 Dakarai Simmons - All Rights Reserved
+
+#include "LIBenchmarkCommandlet.h"
+#include "LIApplyTranslations.h"
+#include "LISpreadsheet.h"
+#include "LITranslationTable.h"
+#include "LIImporterSettings.h"
+#include "LIProgress.h"
+#include "LocalizationImporter.h"
+#include "Async/ParallelFor.h"
+#include "Dom/JsonObject.h"
+#include "Serialization/JsonSerializer.h"
+#include "Serialization/JsonWriter.h"
+#include "HAL/FileManager.h"
+#include "Math/RandomStream.h"
+#include "Misc/DateTime.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+THIRD_PARTY_INCLUDES_START
+#include "zlib.h"
+THIRD_PARTY_INCLUDES_END
+
+namespace LIBenchmark
+{
+	static const TCHAR WordJoiner = 0x2060;
+	static const TCHAR* const Namespace = TEXT("Benchmark");
+
+	// Nothing here needs escaping in XML or in a .po file, so the generator can write text as is.
+	static const TCHAR* const Words[] =
+	{
+		TEXT("the"), TEXT("lantern"), TEXT("spirit"), TEXT("path"), TEXT("river"), TEXT("mountain"), TEXT("whispers"), TEXT("gate"),
+		TEXT("ancient"), TEXT("opens"), TEXT("before"), TEXT("you"), TEXT("quietly"), TEXT("shrine"), TEXT("forest"), TEXT("journey"),
+		TEXT("remember"), TEXT("light"), TEXT("stone"), TEXT("bridge"), TEXT("falls"), TEXT("beyond"), TEXT("kami"), TEXT("wind")
+	};
+
+	struct FParameters
+	{
+		FParameters()
+			: Rows(5000), Pages(4), Cultures(8), SegmentDensity(0.1f), Iterations(5), Seed(0) {}
+
+		int32 Rows;
+		int32 Pages;
+		int32 Cultures;
+
+		// Share of rows whose cells are split into phrases with U+2060
+		float SegmentDensity;
+
+		int32 Iterations;
+		int32 Seed;
+	};
+
+	// Every sample taken of one stage, in seconds.
+	struct FStage
+	{
+		FString Name;
+		TArray<double> Samples;
+	};
+
+	static FStage& FindOrAddStage(TArray<FStage>& Stages, const TCHAR* Name)
+	{
+		FStage* Stage = Stages.FindByPredicate([Name](const FStage& Other) { return Other.Name == Name; });
+		if(Stage)
+			return *Stage;
+
+		FStage& NewStage = Stages.AddDefaulted_GetRef();
+		NewStage.Name = Name;
+		return NewStage;
+	}
+
+	static void AppendU16(TArray<uint8>& Out, const uint16 Value)
+	{
+		Out.Add(uint8(Value));
+		Out.Add(uint8(Value >> 8));
+	}
+
+	static void AppendU32(TArray<uint8>& Out, const uint32 Value)
+	{
+		AppendU16(Out, uint16(Value));
+		AppendU16(Out, uint16(Value >> 16));
+	}
+
+	/*
+	 * Just enough of a zip writer to package a workbook: deflated entries,
+	 * no data descriptors, no zip64, everything built in memory.
+	 */
+	class FZipWriter
+	{
+	public:
+		bool AddEntry(const FString& Name, const TArray<uint8>& Data)
+		{
+			TArray<uint8> Compressed;
+			if(!Deflate(Data, Compressed))
+				return false;
+
+			FEntry& Entry = Entries.AddDefaulted_GetRef();
+			Entry.Name = Name;
+			Entry.Crc = crc32(0L, Data.GetData(), Data.Num());
+			Entry.CompressedSize = Compressed.Num();
+			Entry.UncompressedSize = Data.Num();
+			Entry.LocalHeaderOffset = Archive.Num();
+
+			const FTCHARToUTF8 Utf8Name(*Name);
+			AppendU32(Archive, 0x04034b50);
+			AppendHeaderFields(Entry, Utf8Name.Length());
+			Archive.Append((const uint8*)Utf8Name.Get(), Utf8Name.Length());
+			Archive.Append(Compressed);
+			return true;
+		}
+
+		const TArray<uint8>& Finish()
+		{
+			const uint32 DirectoryOffset = Archive.Num();
+			for(const FEntry& Entry : Entries)
+			{
+				const FTCHARToUTF8 Utf8Name(*Entry.Name);
+				AppendU32(Archive, 0x02014b50);
+				AppendU16(Archive, 20); // Version made by
+				AppendHeaderFields(Entry, Utf8Name.Length());
+				AppendU16(Archive, 0); // Comment length
+				AppendU16(Archive, 0); // Disk number
+				AppendU16(Archive, 0); // Internal attributes
+				AppendU32(Archive, 0); // External attributes
+				AppendU32(Archive, Entry.LocalHeaderOffset);
+				Archive.Append((const uint8*)Utf8Name.Get(), Utf8Name.Length());
+			}
+
+			const uint32 DirectorySize = Archive.Num() - DirectoryOffset;
+			AppendU32(Archive, 0x06054b50);
+			AppendU16(Archive, 0);
+			AppendU16(Archive, 0);
+			AppendU16(Archive, Entries.Num());
+			AppendU16(Archive, Entries.Num());
+			AppendU32(Archive, DirectorySize);
+			AppendU32(Archive, DirectoryOffset);
+			AppendU16(Archive, 0);
+			return Archive;
+		}
+
+	private:
+		struct FEntry
+		{
+			FString Name;
+			uint32 Crc;
+			uint32 CompressedSize;
+			uint32 UncompressedSize;
+			uint32 LocalHeaderOffset;
+		};
+
+		// The part the local header and the central directory have in common.
+		void AppendHeaderFields(const FEntry& Entry, const int32 NameLength)
+		{
+			AppendU16(Archive, 20); // Version needed
+			AppendU16(Archive, 0); // Flags
+			AppendU16(Archive, 8); // Deflate
+			AppendU16(Archive, 0); // Time
+			AppendU16(Archive, 0x21); // Date, 1980-01-01
+			AppendU32(Archive, Entry.Crc);
+			AppendU32(Archive, Entry.CompressedSize);
+			AppendU32(Archive, Entry.UncompressedSize);
+			AppendU16(Archive, NameLength);
+			AppendU16(Archive, 0); // Extra field length
+		}
+
+		static bool Deflate(const TArray<uint8>& Data, TArray<uint8>& OutCompressed)
+		{
+			z_stream Stream;
+			FMemory::Memzero(Stream);
+
+			// Raw deflate, the way zip entries store it.
+			if(deflateInit2(&Stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY) != Z_OK)
+				return false;
+
+			OutCompressed.SetNumUninitialized(deflateBound(&Stream, Data.Num()));
+			Stream.next_in = const_cast<uint8*>(Data.GetData());
+			Stream.avail_in = Data.Num();
+			Stream.next_out = OutCompressed.GetData();
+			Stream.avail_out = OutCompressed.Num();
+
+			const bool bSuccess = deflate(&Stream, Z_FINISH) == Z_STREAM_END;
+			OutCompressed.SetNum(Stream.total_out, false);
+			deflateEnd(&Stream);
+			return bSuccess;
+		}
+
+		TArray<FEntry> Entries;
+		TArray<uint8> Archive;
+	};
+
+	static TArray<uint8> ToUtf8(const FString& Text)
+	{
+		const FTCHARToUTF8 Converted(*Text);
+		return TArray<uint8>((const uint8*)Converted.Get(), Converted.Length());
+	}
+
+	// "A" for 0, "Z" for 25, "AA" for 26 and so on.
+	static FString GetColumnName(int32 Column)
+	{
+		FString Name;
+		for(++Column; Column > 0; Column = (Column - 1) / 26)
+			Name.InsertAt(0, TCHAR(TEXT('A') + (Column - 1) % 26));
+		return Name;
+	}
+
+	static FString GetLanguageName(const int32 CultureIndex)
+	{
+		return FString::Printf(TEXT("Language %02d"), CultureIndex + 1);
+	}
+
+	static FString GetCultureName(const int32 CultureIndex)
+	{
+		return FString::Printf(TEXT("x-bench-%02d"), CultureIndex + 1);
+	}
+
+	/*
+	 * Builds the workbook and the (untranslated) .po file that goes with it.
+	 * Every row gets a key and its own English text; a SegmentDensity share of the rows instead
+	 * holds a few phrases wrapped in U+2060 pairs, which the .po file lists as separate entries.
+	 */
+	class FDataGenerator
+	{
+	public:
+		explicit FDataGenerator(const FParameters& InParameters)
+			: Parameters(InParameters), Random(InParameters.Seed), NumEntries(0) {}
+
+		bool Generate(const FString& WorkbookPath, FString& OutPortableObject)
+		{
+			OutPortableObject = TEXT("msgid \"\"\nmsgstr \"\"\n\"Content-Type: text/plain; charset=UTF-8\\n\"\n\n");
+
+			FZipWriter Zip;
+			for(int32 Page = 0; Page < Parameters.Pages; ++Page)
+			{
+				if(!Zip.AddEntry(FString::Printf(TEXT("xl/worksheets/sheet%d.xml"), Page + 1), ToUtf8(GenerateSheet(Page, OutPortableObject))))
+					return false;
+			}
+
+			FString SharedStringsXml = FString::Printf(TEXT("<?xml version=\"1.0\" encoding=\"UTF-8\" standalone=\"yes\"?>\n")
+				TEXT("<sst xmlns=\"http://schemas.openxmlformats.org/spreadsheetml/2006/main\" count=\"%d\" uniqueCount=\"%d\">"), SharedStrings.Num(), SharedStrings.Num());
+			for(const FString& String : SharedStrings)
+			{
+				SharedStringsXml += TEXT("<si><t>");
+				SharedStringsXml += String;
+				SharedStringsXml += TEXT("</t></si>");
+			}
+			SharedStringsXml += TEXT("</sst>");
+
+			FString ContentTypes = TEXT("<?xml version=\"1.0\" encoding=\"UTF-8\" standalone=\"yes\"?>\n")
+				TEXT("<Types xmlns=\"http://schemas.openxmlformats.org/package/2006/content-types\">")
+				TEXT("<Default Extension=\"rels\" ContentType=\"application/vnd.openxmlformats-package.relationships+xml\"/>")
+				TEXT("<Default Extension=\"xml\" ContentType=\"application/xml\"/>")
+				TEXT("<Override PartName=\"/xl/workbook.xml\" ContentType=\"application/vnd.openxmlformats-officedocument.spreadsheetml.sheet.main+xml\"/>")
+				TEXT("<Override PartName=\"/xl/sharedStrings.xml\" ContentType=\"application/vnd.openxmlformats-officedocument.spreadsheetml.sharedStrings+xml\"/>");
+
+			FString Workbook = TEXT("<?xml version=\"1.0\" encoding=\"UTF-8\" standalone=\"yes\"?>\n")
+				TEXT("<workbook xmlns=\"http://schemas.openxmlformats.org/spreadsheetml/2006/main\" xmlns:r=\"http://schemas.openxmlformats.org/officeDocument/2006/relationships\"><sheets>");
+
+			FString WorkbookRelationships = TEXT("<?xml version=\"1.0\" encoding=\"UTF-8\" standalone=\"yes\"?>\n")
+				TEXT("<Relationships xmlns=\"http://schemas.openxmlformats.org/package/2006/relationships\">");
+
+			for(int32 Page = 0; Page < Parameters.Pages; ++Page)
+			{
+				ContentTypes += FString::Printf(TEXT("<Override PartName=\"/xl/worksheets/sheet%d.xml\" ContentType=\"application/vnd.openxmlformats-officedocument.spreadsheetml.worksheet+xml\"/>"), Page + 1);
+				Workbook += FString::Printf(TEXT("<sheet name=\"%s\" sheetId=\"%d\" r:id=\"rId%d\"/>"), *GetPageName(Page), Page + 1, Page + 1);
+				WorkbookRelationships += FString::Printf(TEXT("<Relationship Id=\"rId%d\" Type=\"http://schemas.openxmlformats.org/officeDocument/2006/relationships/worksheet\" Target=\"worksheets/sheet%d.xml\"/>"), Page + 1, Page + 1);
+			}
+
+			ContentTypes += TEXT("</Types>");
+			Workbook += TEXT("</sheets></workbook>");
+			WorkbookRelationships += FString::Printf(TEXT("<Relationship Id=\"rId%d\" Type=\"http://schemas.openxmlformats.org/officeDocument/2006/relationships/sharedStrings\" Target=\"sharedStrings.xml\"/>"), Parameters.Pages + 1);
+			WorkbookRelationships += TEXT("</Relationships>");
+
+			const FString PackageRelationships = TEXT("<?xml version=\"1.0\" encoding=\"UTF-8\" standalone=\"yes\"?>\n")
+				TEXT("<Relationships xmlns=\"http://schemas.openxmlformats.org/package/2006/relationships\">")
+				TEXT("<Relationship Id=\"rId1\" Type=\"http://schemas.openxmlformats.org/officeDocument/2006/relationships/officeDocument\" Target=\"xl/workbook.xml\"/>")
+				TEXT("</Relationships>");
+
+			return Zip.AddEntry(TEXT("[Content_Types].xml"), ToUtf8(ContentTypes))
+				&& Zip.AddEntry(TEXT("_rels/.rels"), ToUtf8(PackageRelationships))
+				&& Zip.AddEntry(TEXT("xl/workbook.xml"), ToUtf8(Workbook))
+				&& Zip.AddEntry(TEXT("xl/_rels/workbook.xml.rels"), ToUtf8(WorkbookRelationships))
+				&& Zip.AddEntry(TEXT("xl/sharedStrings.xml"), ToUtf8(SharedStringsXml))
+				&& FFileHelper::SaveArrayToFile(Zip.Finish(), *WorkbookPath);
+		}
+
+		static FString GetPageName(const int32 Page)
+		{
+			return FString::Printf(TEXT("Page %d"), Page + 1);
+		}
+
+		// Entries in the .po file, not counting the header
+		int32 GetNumEntries() const
+		{
+			return NumEntries;
+		}
+
+	private:
+		FString GenerateSheet(const int32 Page, FString& PortableObject)
+		{
+			FString Sheet = TEXT("<?xml version=\"1.0\" encoding=\"UTF-8\" standalone=\"yes\"?>\n")
+				TEXT("<worksheet xmlns=\"http://schemas.openxmlformats.org/spreadsheetml/2006/main\"><sheetData>");
+
+			TArray<FString> Cells;
+			Cells.Add(TEXT("Keys"));
+			Cells.Add(TEXT("English"));
+			for(int32 CultureIndex = 0; CultureIndex < Parameters.Cultures; ++CultureIndex)
+				Cells.Add(GetLanguageName(CultureIndex));
+			AppendRow(Sheet, 1, Cells);
+
+			TArray<FString> Segments;
+			for(int32 Row = 0; Row < Parameters.Rows; ++Row)
+			{
+				const FString Key = FString::Printf(TEXT("Page%d.Row%d"), Page + 1, Row + 1);
+				const FString Phrase = FString::Printf(TEXT("Page %d line %d"), Page + 1, Row + 1);
+
+				Segments.Reset();
+				if(Random.FRand() < Parameters.SegmentDensity)
+				{
+					const int32 NumSegments = Random.RandRange(2, 4);
+					for(int32 Segment = 0; Segment < NumSegments; ++Segment)
+						Segments.Add(MakePhrase(FString::Printf(TEXT("%s part %d"), *Phrase, Segment + 1)));
+				}
+
+				Cells.Reset();
+				Cells.Add(Key);
+
+				if(Segments.Num() == 0)
+				{
+					const FString English = MakePhrase(Phrase);
+					Cells.Add(English);
+					for(int32 CultureIndex = 0; CultureIndex < Parameters.Cultures; ++CultureIndex)
+						Cells.Add(FString::Printf(TEXT("[%s] %s"), *GetCultureName(CultureIndex), *English));
+
+					AppendEntry(PortableObject, Key, English);
+				}
+				else
+				{
+					Cells.Add(JoinSegments(Segments, FString()));
+					for(int32 CultureIndex = 0; CultureIndex < Parameters.Cultures; ++CultureIndex)
+						Cells.Add(JoinSegments(Segments, FString::Printf(TEXT("[%s] "), *GetCultureName(CultureIndex))));
+
+					// Split cells are matched by their English text, the keys the .po file has for them aren't in the sheet.
+					for(int32 Segment = 0; Segment < Segments.Num(); ++Segment)
+						AppendEntry(PortableObject, FString::Printf(TEXT("%s.%d"), *Key, Segment + 1), Segments[Segment]);
+				}
+
+				AppendRow(Sheet, Row + 2, Cells);
+			}
+
+			Sheet += TEXT("</sheetData></worksheet>");
+			return Sheet;
+		}
+
+		FString MakePhrase(const FString& Prefix)
+		{
+			FString Phrase = Prefix;
+			const int32 NumWords = Random.RandRange(3, 12);
+			for(int32 Word = 0; Word < NumWords; ++Word)
+			{
+				Phrase += TEXT(' ');
+				Phrase += Words[Random.RandHelper(UE_ARRAY_COUNT(Words))];
+			}
+			return Phrase;
+		}
+
+		static FString JoinSegments(const TArray<FString>& Segments, const FString& Prefix)
+		{
+			FString Cell;
+			for(const FString& Segment : Segments)
+			{
+				if(!Cell.IsEmpty())
+					Cell += TEXT(' ');
+
+				Cell += WordJoiner;
+				Cell += Prefix;
+				Cell += Segment;
+				Cell += WordJoiner;
+			}
+			return Cell;
+		}
+
+		void AppendRow(FString& Sheet, const int32 RowNumber, const TArray<FString>& Cells)
+		{
+			Sheet += FString::Printf(TEXT("<row r=\"%d\">"), RowNumber);
+			for(int32 Column = 0; Column < Cells.Num(); ++Column)
+			{
+				Sheet += FString::Printf(TEXT("<c r=\"%s%d\" t=\"s\"><v>%d</v></c>"), *GetColumnName(Column), RowNumber, SharedStrings.Num());
+				SharedStrings.Add(Cells[Column]);
+			}
+			Sheet += TEXT("</row>");
+		}
+
+		void AppendEntry(FString& PortableObject, const FString& Key, const FString& SourceText)
+		{
+			PortableObject += FString::Printf(TEXT("#. Key:\t%s\n#: /Game/Benchmark\nmsgctxt \"%s,%s\"\nmsgid \"%s\"\nmsgstr \"\"\n\n"), *Key, Namespace, *Key, *SourceText);
+			++NumEntries;
+		}
+
+		const FParameters& Parameters;
+		FRandomStream Random;
+
+		// Every cell gets its own shared string, the way large sheets of unique phrases end up.
+		TArray<FString> SharedStrings;
+
+		int32 NumEntries;
+	};
+
+	static TSharedRef<FJsonObject> MakeStageObject(const FStage& Stage)
+	{
+		TArray<double> Sorted = Stage.Samples;
+		Sorted.Sort();
+
+		double Total = 0.0;
+		TArray<TSharedPtr<FJsonValue>> Samples;
+		for(const double Sample : Stage.Samples)
+		{
+			Total += Sample;
+			Samples.Add(MakeShared<FJsonValueNumber>(Sample));
+		}
+
+		const TSharedRef<FJsonObject> Object = MakeShared<FJsonObject>();
+		if(Sorted.Num() > 0)
+		{
+			Object->SetNumberField(TEXT("Min"), Sorted[0]);
+			Object->SetNumberField(TEXT("Median"), Sorted[Sorted.Num() / 2]);
+			Object->SetNumberField(TEXT("Mean"), Total / Sorted.Num());
+			Object->SetNumberField(TEXT("Max"), Sorted.Last());
+		}
+		Object->SetArrayField(TEXT("Samples"), Samples);
+		return Object;
+	}
+
+	static int32 GetIntParam(const TMap<FString, FString>& ParamVals, const TCHAR* Name, const int32 Default, const int32 Min)
+	{
+		const FString* Value = ParamVals.Find(Name);
+		return Value ? FMath::Max(FCString::Atoi(**Value), Min) : Default;
+	}
+}
+
+ULIBenchmarkCommandlet::ULIBenchmarkCommandlet()
+{
+	IsClient = false;
+	IsEditor = true;
+	IsServer = false;
+	LogToConsole = true;
+}
+
+int32 ULIBenchmarkCommandlet::Main(const FString& Params)
+{
+	using namespace LIBenchmark;
+
+	TArray<FString> Tokens;
+	TArray<FString> Switches;
+	TMap<FString, FString> ParamVals;
+	UCommandlet::ParseCommandLine(*Params, Tokens, Switches, ParamVals);
+
+	FParameters Parameters;
+	Parameters.Rows = GetIntParam(ParamVals, TEXT("Rows"), Parameters.Rows, 1);
+	Parameters.Pages = GetIntParam(ParamVals, TEXT("Pages"), Parameters.Pages, 1);
+	Parameters.Cultures = GetIntParam(ParamVals, TEXT("Cultures"), Parameters.Cultures, 1);
+	Parameters.Iterations = GetIntParam(ParamVals, TEXT("Iterations"), Parameters.Iterations, 1);
+	Parameters.Seed = GetIntParam(ParamVals, TEXT("Seed"), Parameters.Seed, 0);
+	if(const FString* Density = ParamVals.Find(TEXT("SegmentDensity")))
+		Parameters.SegmentDensity = FMath::Clamp(FCString::Atof(**Density), 0.0f, 1.0f);
+
+	FString OutputPath = ParamVals.FindRef(TEXT("Output"));
+	if(OutputPath.IsEmpty())
+		OutputPath = FPaths::ProjectSavedDir() / TEXT("LocalizationImporter") / TEXT("Benchmark.json");
+	else if(FPaths::IsRelative(OutputPath))
+		OutputPath = FPaths::Combine(FPaths::ProjectDir(), OutputPath);
+	OutputPath = FPaths::ConvertRelativePathToFull(OutputPath);
+
+	// Kept apart from the plugin's own state, the manifest in particular is never touched.
+	const FString DataDir = FPaths::ConvertRelativePathToFull(FPaths::ProjectSavedDir() / TEXT("LocalizationImporter") / TEXT("Benchmark"));
+	const FString WorkbookPath = DataDir / TEXT("Benchmark.xlsx");
+
+	UE_LOG(LocalizationImporterPlugin, Display, TEXT("Generating %d pages of %d rows for %d cultures (segment density %.2f) in '%s'."),
+		Parameters.Pages, Parameters.Rows, Parameters.Cultures, Parameters.SegmentDensity, *DataDir);
+
+	FString PortableObject;
+	FDataGenerator Generator(Parameters);
+	if(!IFileManager::Get().MakeDirectory(*DataDir, true) || !Generator.Generate(WorkbookPath, PortableObject))
+	{
+		UE_LOG(LocalizationImporterPlugin, Error, TEXT("Could not write the benchmark workbook to '%s'."), *WorkbookPath);
+		return -1;
+	}
+
+	FLIApplySettings Settings;
+	Settings.Spreadsheets.Add(WorkbookPath);
+	Settings.bForceRefresh = true;
+	for(int32 Page = 0; Page < Parameters.Pages; ++Page)
+		Settings.Pages.Add(FDataGenerator::GetPageName(Page));
+
+	TArray<FString> Languages;
+	for(int32 CultureIndex = 0; CultureIndex < Parameters.Cultures; ++CultureIndex)
+	{
+		FLIApplySettings::FCulture& Culture = Settings.Cultures.AddDefaulted_GetRef();
+		Culture.Language = GetLanguageName(CultureIndex);
+		Culture.Culture = GetCultureName(CultureIndex);
+		Culture.POPath = DataDir / Culture.Culture / TEXT("Benchmark.po");
+		Languages.Add(Culture.Language);
+	}
+
+	// Every apply starts from the untranslated .po files, so each run does the same amount of work.
+	auto ResetPortableObjects = [&Settings, &PortableObject]()
+	{
+		bool bSuccess = true;
+		for(const FLIApplySettings::FCulture& Culture : Settings.Cultures)
+			bSuccess &= FFileHelper::SaveStringToFile(PortableObject, *Culture.POPath, FFileHelper::EEncodingOptions::ForceUTF8WithoutBOM);
+		return bSuccess;
+	};
+
+	TArray<FStage> Stages;
+	int32 NumPhrases = 0;
+	int32 NumUnmatched = 0;
+	bool bSuccess = true;
+
+	for(int32 Iteration = 0; Iteration < Parameters.Iterations && bSuccess; ++Iteration)
+	{
+		UE_LOG(LocalizationImporterPlugin, Display, TEXT("Iteration %d of %d."), Iteration + 1, Parameters.Iterations);
+
+		double StartTime = FPlatformTime::Seconds();
+		TArray<FUpdateTranslationsSettings> PageSettings;
+		bSuccess &= FLISpreadsheet::ImportSpreadsheet(WorkbookPath, PageSettings);
+		FindOrAddStage(Stages, TEXT("EnumerateSheets")).Samples.Add(FPlatformTime::Seconds() - StartTime);
+
+		StartTime = FPlatformTime::Seconds();
+		FLITranslationTable Table;
+		bSuccess &= Table.Build(Settings.Spreadsheets, Settings.Pages, Languages, Settings.bCaseSensitive);
+		FindOrAddStage(Stages, TEXT("BuildTable")).Samples.Add(FPlatformTime::Seconds() - StartTime);
+
+		// The cultures are applied from the saved table, the way the import hands it to the update step.
+		const FString TablePath = DataDir / TEXT("TranslationTable.bin");
+		const uint64 SourceHash = FLITranslationTable::HashSource(0, Settings.Pages, Settings.bCaseSensitive);
+		StartTime = FPlatformTime::Seconds();
+		bSuccess &= Table.Save(TablePath, SourceHash);
+		FindOrAddStage(Stages, TEXT("SaveTable")).Samples.Add(FPlatformTime::Seconds() - StartTime);
+
+		StartTime = FPlatformTime::Seconds();
+		bSuccess &= Table.Load(TablePath, SourceHash);
+		FindOrAddStage(Stages, TEXT("LoadTable")).Samples.Add(FPlatformTime::Seconds() - StartTime);
+		NumPhrases = Table.Num();
+
+		if(!bSuccess || !ResetPortableObjects())
+		{
+			bSuccess = false;
+			break;
+		}
+
+		// One culture at a time, which is what the join and rewrite of a single .po file costs.
+		NumUnmatched = 0;
+		for(const FLIApplySettings::FCulture& Culture : Settings.Cultures)
+		{
+			FLIImportManifest::FCultureRecord Record;
+			FLIApplyResult Result;
+			bSuccess &= FLIApplyTranslations::ApplyCulture(Table, Settings, Culture, nullptr, Record, Result);
+			FindOrAddStage(Stages, TEXT("ApplyCulture")).Samples.Add(Result.Seconds);
+			NumUnmatched += Result.NumEntries - Result.NumMatched;
+		}
+
+		if(!bSuccess || !ResetPortableObjects())
+		{
+			bSuccess = false;
+			break;
+		}
+
+		// Then every culture at once, the way the LIApplyTranslations commandlet runs them.
+		TArray<bool> Succeeded;
+		Succeeded.Init(false, Settings.Cultures.Num());
+		StartTime = FPlatformTime::Seconds();
+		ParallelFor(Settings.Cultures.Num(), [&](const int32 Index)
+		{
+			FLIImportManifest::FCultureRecord Record;
+			FLIApplyResult Result;
+			Succeeded[Index] = FLIApplyTranslations::ApplyCulture(Table, Settings, Settings.Cultures[Index], nullptr, Record, Result);
+		}, ULIImporterSettings::GetNumWorkers(0, Settings.Cultures.Num()) <= 1);
+		FindOrAddStage(Stages, TEXT("ApplyAllCultures")).Samples.Add(FPlatformTime::Seconds() - StartTime);
+
+		for(const bool bCultureSucceeded : Succeeded)
+			bSuccess &= bCultureSucceeded;
+	}
+
+	if(!bSuccess)
+	{
+		UE_LOG(LocalizationImporterPlugin, Error, TEXT("The benchmark failed, see above."));
+		return -1;
+	}
+
+	// Everything generated has a row, anything left over means the join broke.
+	if(NumUnmatched > 0)
+		UE_LOG(LocalizationImporterPlugin, Warning, TEXT("%d .po entries had no matching row."), NumUnmatched);
+
+	const TSharedRef<FJsonObject> Root = MakeShared<FJsonObject>();
+	Root->SetStringField(TEXT("Date"), FDateTime::UtcNow().ToIso8601());
+
+	const TSharedRef<FJsonObject> Machine = MakeShared<FJsonObject>();
+	Machine->SetStringField(TEXT("CPU"), FPlatformMisc::GetCPUBrand().TrimStartAndEnd());
+	Machine->SetNumberField(TEXT("Cores"), FPlatformMisc::NumberOfCoresIncludingHyperthreads());
+	Root->SetObjectField(TEXT("Machine"), Machine);
+
+	const TSharedRef<FJsonObject> ParametersObject = MakeShared<FJsonObject>();
+	ParametersObject->SetNumberField(TEXT("Rows"), Parameters.Rows);
+	ParametersObject->SetNumberField(TEXT("Pages"), Parameters.Pages);
+	ParametersObject->SetNumberField(TEXT("Cultures"), Parameters.Cultures);
+	ParametersObject->SetNumberField(TEXT("SegmentDensity"), Parameters.SegmentDensity);
+	ParametersObject->SetNumberField(TEXT("Iterations"), Parameters.Iterations);
+	ParametersObject->SetNumberField(TEXT("Seed"), Parameters.Seed);
+	Root->SetObjectField(TEXT("Parameters"), ParametersObject);
+
+	const TSharedRef<FJsonObject> Data = MakeShared<FJsonObject>();
+	Data->SetNumberField(TEXT("WorkbookBytes"), IFileManager::Get().FileSize(*WorkbookPath));
+	Data->SetNumberField(TEXT("Phrases"), NumPhrases);
+	Data->SetNumberField(TEXT("POEntries"), Generator.GetNumEntries());
+	Data->SetNumberField(TEXT("UnmatchedPOEntries"), NumUnmatched);
+	Root->SetObjectField(TEXT("Data"), Data);
+
+	const TSharedRef<FJsonObject> StagesObject = MakeShared<FJsonObject>();
+	for(const FStage& Stage : Stages)
+	{
+		const TSharedRef<FJsonObject> StageObject = MakeStageObject(Stage);
+		StagesObject->SetObjectField(Stage.Name, StageObject);
+		UE_LOG(LocalizationImporterPlugin, Display, TEXT("%s: %.3f seconds (median of %d)."), *Stage.Name, StageObject->GetNumberField(TEXT("Median")), Stage.Samples.Num());
+	}
+	Root->SetObjectField(TEXT("Stages"), StagesObject);
+
+	// The commandlet tasks depend on the project they run in, so they're taken from the executor's record of real imports.
+	FLITaskHistory History;
+	const TSharedRef<FJsonObject> Tasks = MakeShared<FJsonObject>();
+	if(History.Load())
+	{
+		for(const TPair<FString, double>& Duration : History.GetDurations())
+			Tasks->SetNumberField(Duration.Key, Duration.Value);
+	}
+	Root->SetObjectField(TEXT("Tasks"), Tasks);
+
+	FString Json;
+	const TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&Json);
+	if(!FJsonSerializer::Serialize(Root, Writer) || !FFileHelper::SaveStringToFile(Json, *OutputPath, FFileHelper::EEncodingOptions::ForceUTF8WithoutBOM))
+	{
+		UE_LOG(LocalizationImporterPlugin, Error, TEXT("Could not write '%s'."), *OutputPath);
+		return -1;
+	}
+
+	UE_LOG(LocalizationImporterPlugin, Display, TEXT("Wrote the results to '%s'."), *OutputPath);
+
+	if(!Switches.Contains(TEXT("KeepData")))
+		IFileManager::Get().DeleteDirectory(*DataDir, false, true);
+
+	return 0;
+}
@@ -1,10 +1,18 @@
 ﻿// Copyright (C) 2022 Dakarai Simmons - All Rights Reserved
 
 #include "LICommandletExecutor.h"
+#include "LIPipeline.h"
+#include "LocalizationImporter.h"
 #include "Widgets/Text/STextBlock.h"
 #include "EditorStyle.h"
 #include "SourceControlHelpers.h"
 #include "Widgets/Images/SThrobber.h"
+#include "Widgets/Layout/SScrollBar.h"
+#include "Widgets/Layout/SScrollBox.h"
+#include "Widgets/Input/SCheckBox.h"
+#include "Widgets/Input/SComboButton.h"
+#include "Widgets/Input/SHyperlink.h"
+#include "Framework/MultiBox/MultiBoxBuilder.h"
 #include "HAL/PlatformApplicationMisc.h"
 #include "DesktopPlatformModule.h"
 #include "LocalizationConfigurationScript.h"
@@ -12,28 +20,146 @@
 #include "UnrealEdMisc.h"
 #include "Android/AndroidErrorOutputDevice.h"
 #include "Commandlets/CommandletHelpers.h"
+#include "Async/Async.h"
+#include "Misc/OutputDeviceHelper.h"
+#include "Misc/CommandLine.h"
+
+#if PLATFORM_LINUX
+#include <poll.h>
+#include <errno.h>
+#elif PLATFORM_WINDOWS
+#include "Windows/AllowWindowsPlatformTypes.h"
+#include <windows.h>
+#include "Windows/HideWindowsPlatformTypes.h"
+#endif
 
 #define LOCTEXT_NAMESPACE "LICommandletExe"
 
+namespace LICommandletExecutor
+{
+	// Longest the log pump blocks before checking whether the commandlet has exited.
+	// The write end of the pipe stays open in the editor, so the pipe never reports end of file.
+	static const int32 PumpWakeUpMilliseconds = 25;
+
+	// How often the log pump looks at the commandlet's CPU time and memory.
+	static const double UsageSampleSeconds = 0.1;
+
+#if PLATFORM_WINDOWS
+	// Anonymous pipes can't be waited on, so they are peeked at this interval instead.
+	static const int32 PumpPeekMilliseconds = 5;
+#endif
+
+	// Blocks until the pipe has something to read or the wake-up interval passes.
+	static void WaitForPipe(void* const ReadPipe)
+	{
+#if PLATFORM_LINUX
+		pollfd PollFd;
+		PollFd.fd = static_cast<FPipeHandle*>(ReadPipe)->GetHandle();
+		PollFd.events = POLLIN;
+		PollFd.revents = 0;
+
+		const double EndTime = FPlatformTime::Seconds() + PumpWakeUpMilliseconds / 1000.0;
+		for (;;)
+		{
+			const int32 TimeoutMilliseconds = FMath::Max(0, FMath::CeilToInt((EndTime - FPlatformTime::Seconds()) * 1000.0));
+			if (poll(&PollFd, 1, TimeoutMilliseconds) >= 0 || errno != EINTR)
+			{
+				break;
+			}
+		}
+#elif PLATFORM_WINDOWS
+		const double EndTime = FPlatformTime::Seconds() + PumpWakeUpMilliseconds / 1000.0;
+		for (;;)
+		{
+			DWORD BytesAvailable = 0;
+			if (!::PeekNamedPipe(ReadPipe, nullptr, 0, nullptr, &BytesAvailable, nullptr) || BytesAvailable > 0 || FPlatformTime::Seconds() >= EndTime)
+			{
+				break;
+			}
+			::Sleep(PumpPeekMilliseconds);
+		}
+#else
+		FPlatformProcess::Sleep(PumpWakeUpMilliseconds / 1000.0f);
+#endif
+	}
+}
+
 SLICommandletExecutor::SLICommandletExecutor() :
-CurrentTaskIndex(INDEX_NONE),
-Runnable(nullptr),
-RunnableThread(nullptr)
+bSingleProcess(false),
+MaxParallelChains(1),
+MaxParallelTasks(1),
+RunStartTime(0.0),
+RunEndTime(0.0),
+bCompletionReported(false)
 {}
 
-void SLICommandletExecutor::Construct(const FArguments& Arguments, const TSharedRef<SWindow>& InParentWindow, const TArray<LocalizationCommandletExecution::FTask>& Tasks)
+void SLICommandletExecutor::Construct(const FArguments& Arguments, const TSharedRef<SWindow>& InParentWindow, const TArray<FLITaskChain>& TaskChains)
 {
 	ParentWindow = InParentWindow;
 
-	for (const LocalizationCommandletExecution::FTask& Task : Tasks)
+	// Tasks that swap the engine's source control settings around still need a process each, and nothing else can run next to them.
+	const bool bSwapsSettings = TaskChains.ContainsByPredicate([](const FLITaskChain& TaskChain)
 	{
-		const TSharedRef<FTaskListModel> Model = MakeShareable(new FTaskListModel());
-		Model->Task = Task;
-		TaskListModels.Add(Model);
+		return TaskChain.Tasks.ContainsByPredicate([](const FLITask& Task){ return !Task.ShouldUseProjectFile; });
+	});
+	bSingleProcess = Arguments._SingleProcess && !bSwapsSettings;
+	MaxParallelChains = bSwapsSettings ? 1 : FMath::Max(Arguments._MaxParallelChains, 1);
+	MaxParallelTasks = bSwapsSettings ? 1 : FMath::Max(Arguments._MaxParallelTasks, 1);
+	RunStartTime = FPlatformTime::Seconds();
+	OnCompleted = Arguments._OnCompleted;
+
+	TaskHistory.Load();
+
+	RunSummary = Arguments._RunSummary.IsValid() ? Arguments._RunSummary : MakeShared<FLIRunSummary>();
+
+	for (int32 ChainIndex = 0; ChainIndex < TaskChains.Num(); ++ChainIndex)
+	{
+		const FLITaskChain& TaskChain = TaskChains[ChainIndex];
+
+		FChain& Chain = Chains.AddDefaulted_GetRef();
+		Chain.Name = TaskChain.Name;
+		Chain.Dependencies = TaskChain.Dependencies;
+		Chain.FirstTask = TaskListModels.Num();
+
+		for (const FLITask& Task : TaskChain.Tasks)
+		{
+			const int32 TaskIndex = TaskListModels.Num();
+			const TSharedRef<FTaskListModel> Model = MakeShareable(new FTaskListModel());
+			Model->Task = Task;
+			Model->ChainIndex = ChainIndex;
+
+			// Only earlier tasks count, which keeps the graph free of cycles.
+			for (const int32 Dependency : Task.Dependencies)
+			{
+				if (ensure(Dependency >= 0 && Chain.FirstTask + Dependency < TaskIndex))
+				{
+					Model->Dependencies.AddUnique(Chain.FirstTask + Dependency);
+				}
+			}
+
+			// In single process mode, a task that only waits for the last task of a group carries on in that group's process.
+			// Background tasks keep to processes of their own, so they can run at a lower priority.
+			if (bSingleProcess && !Task.bBackground && Model->Dependencies.Num() == 1 && TaskGroups[TaskListModels[Model->Dependencies[0]]->GroupIndex].Tasks.Last() == Model->Dependencies[0]
+				&& !TaskListModels[Model->Dependencies[0]]->Task.bBackground)
+			{
+				Model->GroupIndex = TaskListModels[Model->Dependencies[0]]->GroupIndex;
+			}
+			else
+			{
+				Model->GroupIndex = TaskGroups.AddDefaulted();
+				TaskGroups[Model->GroupIndex].ChainIndex = ChainIndex;
+			}
+			TaskGroups[Model->GroupIndex].Tasks.Add(TaskIndex);
+
+			TaskListModels.Add(Model);
+		}
+
+		Chain.EndTask = TaskListModels.Num();
 	}
 
-	TSharedPtr<SScrollBar> VerticalScrollBar;
-	TSharedPtr<SScrollBar> HorizontalScrollBar;
+	// Created up front, the log view has to be given them before their place in the layout comes up.
+	const TSharedRef<SScrollBar> VerticalScrollBar = SNew(SScrollBar).Orientation(EOrientation::Orient_Vertical);
+	const TSharedRef<SScrollBar> HorizontalScrollBar = SNew(SScrollBar).Orientation(EOrientation::Orient_Horizontal);
 
 	ChildSlot
 	[
@@ -56,6 +182,15 @@ void SLICommandletExecutor::Construct(const FArguments& Arguments, const TShared
 				SAssignNew(ProgressBar, SProgressBar)
 				.Percent(this, &SLICommandletExecutor::GetProgressPercentage)
 			]
+			+SVerticalBox::Slot()
+			.AutoHeight()
+			.Padding(0.0f, 4.0f, 0.0f, 0.0)
+			[
+				SNew(STextBlock)
+				.Text(this, &SLICommandletExecutor::GetRunSummaryText)
+				.ToolTipText(FText::FromString(FLIRunSummary::GetPath()))
+				.Visibility_Lambda([this]{ return RunSummary->IsFinished() ? EVisibility::Visible : EVisibility::Collapsed; })
+			]
 		]
 		+ SVerticalBox::Slot()
 		.FillHeight(0.5)
@@ -75,16 +210,88 @@ void SLICommandletExecutor::Construct(const FArguments& Arguments, const TShared
 				+ SHeaderRow::Column("TaskName")
 				.DefaultLabel(LOCTEXT("TaskListNameColumnLabel", "Task"))
 				.FillWidth(1.0)
+				+ SHeaderRow::Column("Timeline")
+				.DefaultLabel(LOCTEXT("TaskListTimelineColumnLabel", "Timeline"))
+				.DefaultTooltip(LOCTEXT("TaskListTimelineColumnTooltip", "When each task ran over the course of the run. Bars that overlap ran at the same time."))
+				.FixedWidth(100.0)
+				+ SHeaderRow::Column("Progress")
+				.DefaultLabel(LOCTEXT("TaskListProgressColumnLabel", "Progress"))
+				.FixedWidth(140.0)
+				+ SHeaderRow::Column("Warnings")
+				.DefaultLabel(LOCTEXT("TaskListWarningsColumnLabel", "Warnings"))
+				.FixedWidth(70.0)
+				+ SHeaderRow::Column("Errors")
+				.DefaultLabel(LOCTEXT("TaskListErrorsColumnLabel", "Errors"))
+				.FixedWidth(70.0)
 				)
 				.ListItemsSource(&TaskListModels)
 				.OnGenerateRow(this, &SLICommandletExecutor::OnGenerateTaskListRow)
 				.ItemHeight(24.0)
 				.SelectionMode(ESelectionMode::Single)
+				.OnSelectionChanged(this, &SLICommandletExecutor::OnTaskSelectionChanged)
 			]
 		]
 	+ SVerticalBox::Slot()
-		.FillHeight(0.5)
+		.AutoHeight()
 		.Padding(0.0, 32.0, 8.0, 0.0)
+		[
+			SNew(SHorizontalBox)
+			+ SHorizontalBox::Slot()
+			.AutoWidth()
+			.VAlign(VAlign_Center)
+			[
+				SNew(SCheckBox)
+				.IsChecked_Lambda([this]{ return LogFilter.bErrors ? ECheckBoxState::Checked : ECheckBoxState::Unchecked; })
+				.OnCheckStateChanged_Lambda([this](ECheckBoxState State){ LogFilter.bErrors = State == ECheckBoxState::Checked; RefreshLogView(false); })
+				[
+					SNew(STextBlock)
+					.Text_Lambda([this]{ return FText::Format(LOCTEXT("ErrorsFilter", "Errors ({0})"), ViewedTask.IsValid() ? ViewedTask->Log.GetNumErrors() : 0); })
+				]
+			]
+			+ SHorizontalBox::Slot()
+			.AutoWidth()
+			.Padding(10.0f, 0.0f, 0.0f, 0.0f)
+			.VAlign(VAlign_Center)
+			[
+				SNew(SCheckBox)
+				.IsChecked_Lambda([this]{ return LogFilter.bWarnings ? ECheckBoxState::Checked : ECheckBoxState::Unchecked; })
+				.OnCheckStateChanged_Lambda([this](ECheckBoxState State){ LogFilter.bWarnings = State == ECheckBoxState::Checked; RefreshLogView(false); })
+				[
+					SNew(STextBlock)
+					.Text_Lambda([this]{ return FText::Format(LOCTEXT("WarningsFilter", "Warnings ({0})"), ViewedTask.IsValid() ? ViewedTask->Log.GetNumWarnings() : 0); })
+				]
+			]
+			+ SHorizontalBox::Slot()
+			.AutoWidth()
+			.Padding(10.0f, 0.0f, 0.0f, 0.0f)
+			.VAlign(VAlign_Center)
+			[
+				SNew(SCheckBox)
+				.IsChecked_Lambda([this]{ return LogFilter.bMessages ? ECheckBoxState::Checked : ECheckBoxState::Unchecked; })
+				.OnCheckStateChanged_Lambda([this](ECheckBoxState State){ LogFilter.bMessages = State == ECheckBoxState::Checked; RefreshLogView(false); })
+				[
+					SNew(STextBlock)
+					.Text(LOCTEXT("MessagesFilter", "Messages"))
+				]
+			]
+			+ SHorizontalBox::Slot()
+			.AutoWidth()
+			.Padding(10.0f, 0.0f, 0.0f, 0.0f)
+			.VAlign(VAlign_Center)
+			[
+				SNew(SComboButton)
+				.ToolTipText(LOCTEXT("CategoryFilterTooltip", "Only show lines logged to one category."))
+				.OnGetMenuContent(this, &SLICommandletExecutor::GenerateCategoryMenu)
+				.ButtonContent()
+				[
+					SNew(STextBlock)
+					.Text(this, &SLICommandletExecutor::GetCategoryFilterText)
+				]
+			]
+		]
+	+ SVerticalBox::Slot()
+		.FillHeight(0.5)
+		.Padding(0.0, 4.0, 8.0, 0.0)
 		[
 			SNew(SBorder)
 			.BorderImage(FEditorStyle::GetBrush("ToolPanel.GroupBorder"))
@@ -98,25 +305,28 @@ void SLICommandletExecutor::Construct(const FArguments& Arguments, const TShared
 					+SVerticalBox::Slot()
 					.FillHeight(1.0f)
 					[
-						SNew(SMultiLineEditableText)
-						.TextStyle(FEditorStyle::Get(), "LocalizationDashboard.CommandletLog.Text")
-						.Text(this, &SLICommandletExecutor::GetLogString)
-						.IsReadOnly(true)
-						.HScrollBar(HorizontalScrollBar)
-						.VScrollBar(VerticalScrollBar)
+						SNew(SScrollBox)
+						.Orientation(EOrientation::Orient_Horizontal)
+						.ExternalScrollbar(HorizontalScrollBar)
+						+SScrollBox::Slot()
+						[
+							SAssignNew(LogListView, SListView< TSharedPtr<FLILogBuffer::FLine> >)
+							.ListItemsSource(&NoLogLines)
+							.OnGenerateRow(this, &SLICommandletExecutor::OnGenerateLogRow)
+							.SelectionMode(ESelectionMode::None)
+							.ExternalScrollbar(VerticalScrollBar)
+						]
 					]
 					+SVerticalBox::Slot()
 						.AutoHeight()
 						[
-							SAssignNew(HorizontalScrollBar, SScrollBar)
-							.Orientation(EOrientation::Orient_Horizontal)
+							HorizontalScrollBar
 						]
 				]
 				+SHorizontalBox::Slot()
 					.AutoWidth()
 					[
-						SAssignNew(VerticalScrollBar, SScrollBar)
-						.Orientation(EOrientation::Orient_Vertical)
+						VerticalScrollBar
 					]
 			]
 		]
@@ -157,314 +367,1216 @@ void SLICommandletExecutor::Construct(const FArguments& Arguments, const TShared
 		]
 	];
 
-	if(TaskListModels.Num() > 0)
+	ScheduleTasks();
+}
+
+void SLICommandletExecutor::Tick(const FGeometry& AllottedGeometry, const double InCurrentTime, const float InDeltaTime)
+{
+	SCompoundWidget::Tick(AllottedGeometry, InCurrentTime, InDeltaTime);
+
+	for (int32 GroupIndex = 0; GroupIndex < TaskGroups.Num(); ++GroupIndex)
 	{
-		CurrentTaskIndex = 0;
-		ExecuteCommandlet(TaskListModels[CurrentTaskIndex].ToSharedRef());
+		const TSharedPtr<FExecution> Execution = TaskGroups[GroupIndex].Execution;
+		if (!Execution.IsValid())
+		{
+			continue;
+		}
+
+		// Poll for log output data.
+		FlushPendingLog(*Execution);
 
-		if (TaskListView.IsValid())
+		// On Task Completed.
+		if (Execution->InEditorResult.IsValid())
 		{
-			TaskListView->SetSelection(TaskListModels[CurrentTaskIndex]);
+			if (Execution->InEditorResult.IsReady())
+			{
+				OnExecutionCompletion(GroupIndex, Execution->InEditorResult.Get() ? 0 : -1);
+			}
+		}
+		// Not as soon as the process exits: what it wrote last may still be in the pipe, and the pump still reading it.
+		else if (Execution->CommandletProcess.IsValid())
+		{
+			if (Execution->bPumpFinished)
+			{
+				OnExecutionCompletion(GroupIndex, Execution->PumpReturnCode);
+			}
 		}
 	}
+
+	// Tasks whose dependencies just finished, and ones that waited for a free slot or for the editor.
+	ScheduleTasks();
+
+	const bool bRunFinished = IsRunFinished();
+	if (bRunFinished && !RunSummary->IsFinished() && !HasBackgroundWork())
+	{
+		FinishRun();
+	}
+
+	// Last, since the caller may open a dialog from it, which ticks this widget again.
+	if (bRunFinished && !bCompletionReported)
+	{
+		bCompletionReported = true;
+		OnCompleted.ExecuteIfBound();
+	}
 }
 
-void SLICommandletExecutor::Tick(const FGeometry& AllottedGeometry, const double InCurrentTime, const float InDeltaTime)
+void SLICommandletExecutor::ScheduleTasks()
 {
-	SCompoundWidget::Tick(AllottedGeometry, InCurrentTime, InDeltaTime);
+	int32 NumRunningChains = 0;
+	for (const FChain& Chain : Chains)
+	{
+		if (Chain.State == FChain::EState::Running)
+		{
+			++NumRunningChains;
+		}
+	}
 
-	// Poll for log output data.
-	if (!PendingLogData.String.IsEmpty())
+	for (FChain& Chain : Chains)
 	{
-		FString String;
+		if (Chain.State != FChain::EState::Waiting)
+		{
+			continue;
+		}
+
+		bool bReady = true;
+		for (const int32 Dependency : Chain.Dependencies)
+		{
+			// Never started, its tasks show as not run.
+			if (Chains[Dependency].State == FChain::EState::Failed)
+			{
+				Chain.State = FChain::EState::Failed;
+			}
+			bReady &= Chains[Dependency].State == FChain::EState::Succeeded;
+		}
+
+		if (bReady && Chain.State == FChain::EState::Waiting && NumRunningChains < MaxParallelChains)
+		{
+			Chain.State = FChain::EState::Running;
+			++NumRunningChains;
+		}
+	}
+
+	int32 NumRunning = 0;
+	for (const FTaskGroup& Group : TaskGroups)
+	{
+		if (Group.Execution.IsValid())
+		{
+			++NumRunning;
+		}
+	}
+
+	// Tasks that turn out to be up to date or to have nothing to do are done straight away, which can let later ones start in the same pass.
+	// Background tasks go last, so they only take slots nothing else is waiting for.
+	bool bStartedAny = true;
+	while (bStartedAny)
+	{
+		bStartedAny = false;
+		for (int32 Index = 0; Index < TaskGroups.Num() * 2; ++Index)
+		{
+			const int32 GroupIndex = Index % TaskGroups.Num();
+			FTaskGroup& Group = TaskGroups[GroupIndex];
+			const int32 TaskIndex = Group.Tasks[0];
+			const TSharedRef<FTaskListModel> TaskListModel = TaskListModels[TaskIndex].ToSharedRef();
+			if (TaskListModel->Task.bBackground != (Index >= TaskGroups.Num()))
+			{
+				continue;
+			}
+
+			// A chain is done once all but its background tasks are, which may still be ahead.
+			const FChain::EState ChainState = Chains[Group.ChainIndex].State;
+			if (Group.bStarted || (ChainState != FChain::EState::Running && (ChainState != FChain::EState::Succeeded || !TaskListModel->Task.bBackground)))
+			{
+				continue;
+			}
+
+			if (TaskListModel->Dependencies.ContainsByPredicate([this](const int32 Dependency){ return !IsTaskDone(Dependency); }))
+			{
+				continue;
+			}
+
+			// A group that's only work inside the editor doesn't need a process even in single process mode, there's no engine to share.
+			const bool bPipeline = bSingleProcess && !(Group.Tasks.Num() == 1 && TaskListModel->Task.Work);
+
+			if (!bPipeline && TaskListModel->Task.bUpToDate)
+			{
+				SkipTask(TaskListModel, FTaskListModel::EState::Cached, LOCTEXT("CachedTaskLog", "Up to date since the last run, nothing has changed."));
+			}
+			else if (!bPipeline && !TaskListModel->Task.RequiredFile.IsEmpty() && !FPaths::FileExists(TaskListModel->Task.RequiredFile))
+			{
+				SkipTask(TaskListModel, FTaskListModel::EState::Skipped, LOCTEXT("SkippedTaskLog", "Nothing to do, an earlier task found no changes."));
+			}
+			// Work inside the editor keeps every core busy by itself, and its log lines couldn't be told apart from another's; it waits its turn.
+			else if (NumRunning >= MaxParallelTasks || (!bPipeline && TaskListModel->Task.Work && IsEditorBusy()))
+			{
+				continue;
+			}
+			else if (bPipeline)
+			{
+				ExecutePipeline(GroupIndex);
+			}
+			else
+			{
+				SelectTask(TaskIndex);
+				ExecuteCommandlet(TaskIndex);
+			}
+
+			Group.bStarted = true;
+			bStartedAny = true;
+			if (Group.Execution.IsValid())
+			{
+				++NumRunning;
+			}
+		}
+	}
+
+	UpdateChainStates();
+}
+
+void SLICommandletExecutor::UpdateChainStates()
+{
+	// Whether each task is running, or may still run once what it waits for is done.
+	TArray<bool> Pending;
+	Pending.Init(false, TaskListModels.Num());
+
+	for (FChain& Chain : Chains)
+	{
+		if (Chain.State != FChain::EState::Running)
+		{
+			continue;
+		}
+
+		bool bAnyPending = false;
+		bool bAllDone = true;
+		for (int32 TaskIndex = Chain.FirstTask; TaskIndex < Chain.EndTask; ++TaskIndex)
+		{
+			const FTaskListModel& TaskListModel = *TaskListModels[TaskIndex];
+			if (IsTaskDone(TaskIndex) || TaskListModel.Task.bBackground)
+			{
+				continue;
+			}
+			bAllDone = false;
+
+			// A group that started and has nothing running any more won't get to the rest of its tasks.
+			const FTaskGroup& Group = TaskGroups[TaskListModel.GroupIndex];
+			if (TaskListModel.State == FTaskListModel::EState::Failed || (Group.bStarted && !Group.Execution.IsValid()))
+			{
+				continue;
+			}
+
+			Pending[TaskIndex] = !TaskListModel.Dependencies.ContainsByPredicate([this, &Pending](const int32 Dependency)
+			{
+				return !IsTaskDone(Dependency) && !Pending[Dependency];
+			});
+			bAnyPending |= Pending[TaskIndex];
+		}
+
+		if (bAllDone)
+		{
+			Chain.State = FChain::EState::Succeeded;
+		}
+		else if (!bAnyPending)
+		{
+			Chain.State = FChain::EState::Failed;
+		}
+	}
+}
+
+bool SLICommandletExecutor::IsTaskDone(const int32 TaskIndex) const
+{
+	const FTaskListModel::EState State = TaskListModels[TaskIndex]->State;
+	return State == FTaskListModel::EState::Succeeded || State == FTaskListModel::EState::Skipped || State == FTaskListModel::EState::Cached;
+}
+
+bool SLICommandletExecutor::WasSuccessful() const
+{
+	// Background tasks aren't what the run is for; theirs show in the task list.
+	return HasCompleted() && !TaskListModels.ContainsByPredicate([](const TSharedPtr<FTaskListModel>& TaskListModel)
+	{
+		return !TaskListModel->Task.bBackground && TaskListModel->State != FTaskListModel::EState::Succeeded && TaskListModel->State != FTaskListModel::EState::Skipped && TaskListModel->State != FTaskListModel::EState::Cached;
+	});
+}
+
+bool SLICommandletExecutor::DidTaskRun(const int32 ChainIndex, const int32 TaskIndex) const
+{
+	if (!Chains.IsValidIndex(ChainIndex) || TaskIndex < 0 || Chains[ChainIndex].FirstTask + TaskIndex >= Chains[ChainIndex].EndTask)
+	{
+		return false;
+	}
+
+	return TaskListModels[Chains[ChainIndex].FirstTask + TaskIndex]->State == FTaskListModel::EState::Succeeded;
+}
+
+bool SLICommandletExecutor::WasChainSuccessful(const int32 ChainIndex) const
+{
+	return Chains.IsValidIndex(ChainIndex) && Chains[ChainIndex].State == FChain::EState::Succeeded;
+}
+
+bool SLICommandletExecutor::HasBackgroundWork() const
+{
+	return TaskGroups.ContainsByPredicate([this](const FTaskGroup& Group)
+	{
+		return TaskListModels[Group.Tasks[0]]->Task.bBackground
+			&& (Group.Execution.IsValid() || (!Group.bStarted && Chains[Group.ChainIndex].State == FChain::EState::Succeeded));
+	});
+}
+
+void SLICommandletExecutor::FlushPendingLog(FExecution& Execution)
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(LIExecutor_FlushLog);
+
+	FLILogQueue::FChunk* Chunk;
+	while (Execution.LogQueue.Pop(Chunk))
+	{
+		const ANSICHAR* Data = (const ANSICHAR*)Chunk->GetData();
+		const int32 Len = Chunk->Num();
+
+		if (Execution.bPipeline)
+		{
+			// The pipeline's step markers decide which task a line belongs to, so it has to be split into whole lines first.
+			int32 LineStart = 0;
+			for (int32 i = 0; i < Len; ++i)
+			{
+				if (Data[i] != '\n')
+				{
+					continue;
+				}
+
+				if (Execution.PendingPipelineLine.Num() > 0)
+				{
+					Execution.PendingPipelineLine.Append(Data + LineStart, i + 1 - LineStart);
+					ProcessPipelineLine(Execution, Execution.PendingPipelineLine.GetData(), Execution.PendingPipelineLine.Num());
+					Execution.PendingPipelineLine.Reset();
+				}
+				else
+				{
+					ProcessPipelineLine(Execution, Data + LineStart, i + 1 - LineStart);
+				}
+				LineStart = i + 1;
+			}
+
+			Execution.PendingPipelineLine.Append(Data + LineStart, Len - LineStart);
+		}
+		else if (TaskListModels.IsValidIndex(Execution.TaskIndex))
+		{
+			// Forward string to proper log.
+			AppendTaskLog(TaskListModels[Execution.TaskIndex], Data, Len);
+		}
+
+		Execution.LogQueue.ReleaseChunk(Chunk);
+	}
+}
+
+void SLICommandletExecutor::AppendTaskLog(const TSharedPtr<FTaskListModel>& TaskListModel, const ANSICHAR* Utf8, const int32 Len)
+{
+	// Follow the output as it comes in, unless the log has been scrolled up to read something.
+	const bool bFollow = TaskListModel == ViewedTask && LogListView.IsValid() && LogListView->GetScrollDistanceRemaining().IsNearlyZero();
+
+	const int32 NumLines = TaskListModel->Log.Num();
+	TaskListModel->Log.Append(Utf8, Len);
+
+	const TArray<TSharedPtr<FLILogBuffer::FLine>>& Lines = TaskListModel->Log.GetLines();
+	for (int32 LineIndex = NumLines; LineIndex < Lines.Num(); ++LineIndex)
+	{
+		const FLILogBuffer::FLine& Line = *Lines[LineIndex];
+		TaskListModel->Progress.ParseMessage(TaskListModel->Log.GetLineChars(Line) + Line.MessageOffset, Line.Len - Line.MessageOffset);
+	}
+
+	if (TaskListModel == ViewedTask && TaskListModel->Log.Num() != NumLines)
+	{
+		RefreshLogView(bFollow, NumLines);
+	}
+}
+
+void SLICommandletExecutor::SetTaskLog(const TSharedPtr<FTaskListModel>& TaskListModel, const FText& Message)
+{
+	TaskListModel->Log.Reset();
+	TaskListModel->Log.Append(Message.ToString());
+	TaskListModel->Log.Flush();
+
+	if (TaskListModel == ViewedTask)
+	{
+		RefreshLogView(false);
+	}
+}
+
+void SLICommandletExecutor::ProcessPipelineLine(FExecution& Execution, const ANSICHAR* Utf8, const int32 Len)
+{
+	int32 StepIndex;
+	int32 ReturnCode;
+	FLIProcessUsage Usage;
+
+	// Almost every line is plain output, which goes to the log without being converted here.
+	FString Line;
+	if (FLIPipeline::MayContainMarker(Utf8, Len))
+	{
+		const FUTF8ToTCHAR Converted(Utf8, Len);
+		Line = FString(Converted.Length(), Converted.Get());
+	}
+
+	const TArray<int32>& PipelineTaskIndices = Execution.PipelineTaskIndices;
+	if (FLIPipeline::ParseStepBegin(Line, StepIndex) && PipelineTaskIndices.IsValidIndex(StepIndex))
+	{
+		const int32 TaskIndex = PipelineTaskIndices[StepIndex];
+
+		// The first step was marked as started along with the process, its time includes the engine booting.
+		if (TaskListModels[TaskIndex]->State != FTaskListModel::EState::InProgress)
+		{
+			MarkTaskStarted(TaskListModels[TaskIndex]);
+		}
+		Execution.TaskIndex = TaskIndex;
+		SelectTask(TaskIndex);
+	}
+	else if (FLIPipeline::ParseStepSkip(Line, StepIndex) && PipelineTaskIndices.IsValidIndex(StepIndex))
+	{
+		const int32 TaskIndex = PipelineTaskIndices[StepIndex];
+		TaskListModels[TaskIndex]->State = FTaskListModel::EState::Skipped;
+		TaskListModels[TaskIndex]->EndTime = FPlatformTime::Seconds();
+
+		// The pipeline says why right after the marker, so the log stays with the skipped task until the next step begins.
+		Execution.TaskIndex = TaskIndex;
+	}
+	else if (FLIPipeline::ParseStepEnd(Line, StepIndex, ReturnCode, Usage) && PipelineTaskIndices.IsValidIndex(StepIndex))
+	{
+		const int32 TaskIndex = PipelineTaskIndices[StepIndex];
+		TaskListModels[TaskIndex]->Usage = Usage;
+		MarkTaskFinished(TaskListModels[TaskIndex], ReturnCode == 0);
+
+		if (ReturnCode == 0)
+		{
+			Execution.TaskIndex = PipelineTaskIndices[FMath::Min(StepIndex + 1, PipelineTaskIndices.Num() - 1)];
+		}
+	}
+	else
+	{
+		// Output after the last step (engine shutdown) still goes to the last task's log.
+		AppendTaskLog(TaskListModels[Execution.TaskIndex], Utf8, Len);
+	}
+}
+
+void SLICommandletExecutor::SelectTask(const int32 TaskIndex)
+{
+	// With several tasks running, the one being looked at stays in view until it's done.
+	if (ViewedTask.IsValid() && ViewedTask->State == FTaskListModel::EState::InProgress && ViewedTask != TaskListModels[TaskIndex])
+	{
+		return;
+	}
+
+	if (TaskListView.IsValid())
+	{
+		TaskListView->SetSelection(TaskListModels[TaskIndex]);
+	}
+}
+
+void SLICommandletExecutor::MarkTaskStarted(const TSharedPtr<FTaskListModel>& TaskListModel)
+{
+	TaskListModel->State = FTaskListModel::EState::InProgress;
+	TaskListModel->StartTime = FPlatformTime::Seconds();
+	TaskListModel->Progress = FLIProgress();
+	TaskListModel->Progress.NumSteps = FLIProgress::CountGatherSteps(TaskListModel->Task.ScriptPath);
+}
+
+void SLICommandletExecutor::MarkTaskFinished(const TSharedPtr<FTaskListModel>& TaskListModel, const bool bSucceeded)
+{
+	TaskListModel->State = bSucceeded ? FTaskListModel::EState::Succeeded : FTaskListModel::EState::Failed;
+	TaskListModel->EndTime = FPlatformTime::Seconds();
+
+	// Only complete runs say anything about how long the next one will take.
+	if (bSucceeded && TaskListModel->StartTime > 0.0)
+	{
+		TaskHistory.Record(FLITaskHistory::MakeKey(TaskListModel->Task.CommandletName, TaskListModel->Task.ScriptPath), FPlatformTime::Seconds() - TaskListModel->StartTime);
+	}
+}
+
+void SLICommandletExecutor::OnPipelineCompletion(const int32 GroupIndex, const int32 ReturnCode)
+{
+	FTaskGroup& Group = TaskGroups[GroupIndex];
+	const TSharedPtr<FExecution> Execution = Group.Execution;
+	CleanUpExecution(*Execution);
+	Group.Execution.Reset();
+
+	// The whole process, engine start and shutdown included; its steps are added with the other tasks.
+	{
+		const bool bOnlyPipeline = TaskGroups.Num() == 1;
+		FLIRunSummary::FStage Stage;
+		Stage.Name = bOnlyPipeline ? TEXT("LIPipeline") : FString::Printf(TEXT("LIPipeline (%s)"), *GetTaskDisplayName(*TaskListModels[Group.Tasks[0]]).ToString());
+		Stage.Kind = FLIRunSummary::EStageKind::Process;
+		Stage.Result = ReturnCode == 0 ? TEXT("Succeeded") : TEXT("Failed");
+		Stage.WallSeconds = FPlatformTime::Seconds() - TaskListModels[Execution->PipelineTaskIndices[0]]->StartTime;
+		Stage.Usage = Execution->ProcessUsage;
+		RunSummary->AddStage(Stage);
+	}
+
+	// Completion waits for the pump to drain the pipe, and the pump has been joined, so this is the rest of the output.
+	FlushPendingLog(*Execution);
+	if (Execution->PendingPipelineLine.Num() > 0)
+	{
+		ProcessPipelineLine(*Execution, Execution->PendingPipelineLine.GetData(), Execution->PendingPipelineLine.Num());
+		Execution->PendingPipelineLine.Empty();
+	}
+
+	for (const int32 TaskIndex : Group.Tasks)
+	{
+		TaskListModels[TaskIndex]->Log.Flush();
+	}
+	RefreshLogView(false);
+
+	// Only a step whose end marker came through succeeded, whatever the process returned. One still running
+	// was cut short (a crash leaves no end marker), and the steps after it never ran.
+	for (const int32 TaskIndex : Group.Tasks)
+	{
+		const TSharedPtr<FTaskListModel>& TaskListModel = TaskListModels[TaskIndex];
+		if (TaskListModel->State == FTaskListModel::EState::InProgress)
+		{
+			MarkTaskFinished(TaskListModel, false);
+		}
+	}
+}
+
+void SLICommandletExecutor::OnExecutionCompletion(const int32 GroupIndex, const int32 ReturnCode)
+{
+	FTaskGroup& Group = TaskGroups[GroupIndex];
+	const TSharedPtr<FExecution> Execution = Group.Execution;
+	if (Execution->bPipeline)
+	{
+		OnPipelineCompletion(GroupIndex, ReturnCode);
+		return;
+	}
+
+	const bool bRanInEditor = Execution->InEditorResult.IsValid();
+	CleanUpExecution(*Execution);
+	Group.Execution.Reset();
+
+	// Whatever arrived after the last tick still belongs to this task.
+	FlushPendingLog(*Execution);
+
+	// Handle return code.
+	const TSharedPtr<FTaskListModel> CurrentTaskModel = TaskListModels[Execution->TaskIndex];
+	if (!bRanInEditor)
+	{
+		CurrentTaskModel->Usage = Execution->ProcessUsage;
+	}
+	else if (Execution->InEditorStartUsage.IsValid() && FLIProcessUsage::SampleCurrentProcess(CurrentTaskModel->Usage))
+	{
+		CurrentTaskModel->Usage.CPUSeconds -= Execution->InEditorStartUsage.CPUSeconds;
+	}
+	CurrentTaskModel->Log.Flush();
+	if (CurrentTaskModel == ViewedTask)
+	{
+		RefreshLogView(false);
+	}
+
+	// Restore engine's source control settings if necessary.
+	if (!CurrentTaskModel->Task.ShouldUseProjectFile)
+	{
+		const FString& EngineIniFile = SourceControlHelpers::GetGlobalSettingsIni();
+		const FString BackupEngineIniFile = FPaths::EngineSavedDir() / FPaths::GetCleanFilename(EngineIniFile) + TEXT(".bak");
+		if(!IFileManager::Get().Move(*EngineIniFile, *BackupEngineIniFile))
+		{
+			// (From engine source code) TODO: Error failed to restore engine source control settings INI.
+		}
+	}
+
+	// Zero code is successful, the tasks waiting on it start with the next schedule.
+	MarkTaskFinished(CurrentTaskModel, ReturnCode == 0);
+}
+
+TSharedPtr<FLICommandletProcess> FLICommandletProcess::Execute(const FString& CommandletName, const FString& ConfigFilePath, const bool UseProjectFile, const int32 PriorityModifier)
+{
+	// Create pipes.
+	void* ReadPipe;
+	void* WritePipe;
+	if (!FPlatformProcess::CreatePipe(ReadPipe, WritePipe))
+	{
+		return nullptr;
+	}
+
+	// Create process.
+	const FString CommandletArguments = BuildCommandletArguments(ConfigFilePath, UseProjectFile);
+	const FString ProjectFilePath = FString::Printf(TEXT("\"%s\""), *FPaths::ConvertRelativePathToFull(FPaths::GetProjectFilePath()));
+	FString ProcessArguments = CommandletHelpers::BuildCommandletProcessArguments(*CommandletName, UseProjectFile ? *ProjectFilePath : nullptr, *CommandletArguments);
+
+	// When the editor is being traced, the commandlet sends its trace to the same Unreal Insights instance.
+	FString TraceChannels;
+	FString TraceHost;
+	if (FParse::Value(FCommandLine::Get(), TEXT("-trace="), TraceChannels) && FParse::Value(FCommandLine::Get(), TEXT("-tracehost="), TraceHost))
+	{
+		ProcessArguments += FString::Printf(TEXT(" -trace=%s -tracehost=%s"), *TraceChannels, *TraceHost);
+	}
+
+	uint32 ProcessId = 0;
+	FProcHandle CommandletProcessHandle = FPlatformProcess::CreateProc(*FUnrealEdMisc::Get().GetExecutableForCommandlets(), *ProcessArguments, true, true, true, &ProcessId, PriorityModifier, nullptr, WritePipe);
+
+	// Close pipes if process failed.
+	if (!CommandletProcessHandle.IsValid())
+	{
+		FPlatformProcess::ClosePipe(ReadPipe, WritePipe);
+		return nullptr;
+	}
+
+	return MakeShareable(new FLICommandletProcess(ReadPipe, WritePipe, CommandletProcessHandle, ProcessId, ProcessArguments));
+}
+
+FString FLICommandletProcess::BuildCommandletArguments(const FString& ConfigFilePath, const bool UseProjectFile)
+{
+	const FString ConfigFileRelativeToGameDir = LocalizationConfigurationScript::MakePathRelativeForCommandletProcess(ConfigFilePath, UseProjectFile);
+	FString CommandletArguments = FString::Printf( TEXT("-config=\"%s\""), *ConfigFileRelativeToGameDir );
+
+	if (FLocalizationSourceControlSettings::IsSourceControlEnabled())
+	{
+		CommandletArguments += TEXT(" -EnableSCC");
+
+		if (!FLocalizationSourceControlSettings::IsSourceControlAutoSubmitEnabled())
+		{
+			CommandletArguments += TEXT(" -DisableSCCSubmit");
+		}
+	}
+
+	return CommandletArguments;
+}
+
+FLICommandletProcess::~FLICommandletProcess()
+{
+	if (ProcessHandle.IsValid() && FPlatformProcess::IsProcRunning(ProcessHandle))
+	{
+		FPlatformProcess::TerminateProc(ProcessHandle);
+	}
+	FPlatformProcess::ClosePipe(ReadPipe, WritePipe);
+}
+
+void SLICommandletExecutor::ExecuteCommandlet(const int32 TaskIndex)
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(LIExecutor_StartTask);
+
+	const TSharedRef<FTaskListModel> TaskListModel = TaskListModels[TaskIndex].ToSharedRef();
+
+	// Handle source control settings if not using project file for commandlet executable process.
+	if (!TaskListModel->Task.ShouldUseProjectFile)
+	{
+		const FString& EngineIniFile = SourceControlHelpers::GetGlobalSettingsIni();
+
+		// Backup engine's source control settings.
+		const FString BackupEngineIniFile = FPaths::EngineSavedDir() / FPaths::GetCleanFilename(EngineIniFile) + TEXT(".bak");
+		if (COPY_OK == IFileManager::Get().Copy(*BackupEngineIniFile, *EngineIniFile))
+		{
+			// Replace engine's source control settings with project's.
+			const FString& ProjectIniFile = SourceControlHelpers::GetSettingsIni();
+			if (COPY_OK == IFileManager::Get().Copy(*EngineIniFile, *ProjectIniFile))
+			{
+				// (From engine source code) TODO: Error failed to overwrite engine source control settings INI.
+			}
+		}
+		else
+		{
+			// (From engine source code) TODO: Error failed to backup engine source control settings INI.
+		}
+	}
+
+	if (TaskListModel->Task.Work)
+	{
+		ExecuteInEditor(TaskIndex);
+		return;
+	}
+
+	const TSharedRef<FExecution> Execution = MakeShared<FExecution>();
+	Execution->GroupIndex = TaskListModel->GroupIndex;
+	Execution->TaskIndex = TaskIndex;
+	Execution->CommandletProcess = FLICommandletProcess::Execute(TaskListModel->Task.CommandletName, TaskListModel->Task.ScriptPath, TaskListModel->Task.ShouldUseProjectFile, TaskListModel->Task.bBackground ? -1 : 0);
+	
+	if (Execution->CommandletProcess.IsValid())
+	{
+		MarkTaskStarted(TaskListModel);
+		TaskListModel->ProcessArguments = Execution->CommandletProcess->GetProcessArguments();
+	}
+	else
+	{
+		TaskListModel->State = FTaskListModel::EState::Failed;
+		return;
+	}
+
+	TaskGroups[TaskListModel->GroupIndex].Execution = Execution;
+	StartLogPump(*Execution);
+}
+
+void SLICommandletExecutor::SkipTask(const TSharedRef<FTaskListModel>& TaskListModel, const FTaskListModel::EState State, const FText& Reason)
+{
+	TaskListModel->State = State;
+	SetTaskLog(TaskListModel, Reason);
+}
+
+void SLICommandletExecutor::ExecuteInEditor(const int32 TaskIndex)
+{
+	// Forwards the plugin's log lines to the task log, formatted the same way a commandlet's output is.
+	class FInEditorLogCapture : public FOutputDevice
+	{
+	public:
+		explicit FInEditorLogCapture(FLILogQueue& InLogQueue)
+			: LogQueue(InLogQueue)
+		{
+		}
+
+		virtual void Serialize(const TCHAR* Data, ELogVerbosity::Type Verbosity, const FName& Category) override
+		{
+			if (Category == LocalizationImporterPlugin.GetCategoryName())
+			{
+				const FTCHARToUTF8 Line(*(FOutputDeviceHelper::FormatLogLine(Verbosity, Category, Data) + LINE_TERMINATOR));
+
+				// Work can log from several threads at once, but the queue takes one producer; they only ever wait on each other.
+				FScopeLock ScopeLock(&ProducerLock);
+				LogQueue.Write(Line.Get(), Line.Length());
+			}
+		}
+
+		virtual bool CanBeUsedOnAnyThread() const override
+		{
+			return true;
+		}
+
+	private:
+		FLILogQueue& LogQueue;
+		FCriticalSection ProducerLock;
+	};
+
+	const TSharedRef<FTaskListModel> TaskListModel = TaskListModels[TaskIndex].ToSharedRef();
+	const TSharedRef<FExecution> Execution = MakeShared<FExecution>();
+	Execution->GroupIndex = TaskListModel->GroupIndex;
+	Execution->TaskIndex = TaskIndex;
+
+	MarkTaskStarted(TaskListModel);
+	TaskListModel->ProcessArguments = LOCTEXT("InEditorTaskArguments", "Running inside the editor").ToString();
+	FLIProcessUsage::SampleCurrentProcess(Execution->InEditorStartUsage);
+
+	Execution->InEditorLogCapture = MakeUnique<FInEditorLogCapture>(Execution->LogQueue);
+	GLog->AddOutputDevice(Execution->InEditorLogCapture.Get());
+
+	Execution->InEditorResult = Async(EAsyncExecution::Thread, TFunction<bool()>(TaskListModel->Task.Work));
+	TaskGroups[TaskListModel->GroupIndex].Execution = Execution;
+}
+
+void SLICommandletExecutor::ExecutePipeline(const int32 GroupIndex)
+{
+	FTaskGroup& Group = TaskGroups[GroupIndex];
+	const TSharedRef<FExecution> Execution = MakeShared<FExecution>();
+	Execution->GroupIndex = GroupIndex;
+	Execution->bPipeline = true;
+
+	FLIPipeline Pipeline;
+	for (const int32 TaskIndex : Group.Tasks)
+	{
+		const TSharedPtr<FTaskListModel>& TaskListModel = TaskListModels[TaskIndex];
+		if (TaskListModel->Task.bUpToDate)
+		{
+			TaskListModel->State = FTaskListModel::EState::Cached;
+			SetTaskLog(TaskListModel, LOCTEXT("CachedTaskLog", "Up to date since the last run, nothing has changed."));
+			continue;
+		}
+
+		Execution->PipelineTaskIndices.Add(TaskIndex);
+
+		FLIPipeline::FStep& Step = Pipeline.Steps.AddDefaulted_GetRef();
+		Step.Name = TaskListModel->Task.Name.ToString();
+		Step.CommandletName = TaskListModel->Task.CommandletName;
+		Step.Arguments = FLICommandletProcess::BuildCommandletArguments(TaskListModel->Task.ScriptPath, TaskListModel->Task.ShouldUseProjectFile);
+		Step.RequiredFile = TaskListModel->Task.RequiredFile;
+	}
+
+	if (Execution->PipelineTaskIndices.Num() == 0)
+	{
+		return;
+	}
+
+	Execution->TaskIndex = Execution->PipelineTaskIndices[0];
+	SelectTask(Execution->TaskIndex);
+
+	// Each group has a pipeline file of its own, since several of them can be running.
+	const FChain& Chain = Chains[Group.ChainIndex];
+	const FString PipelinePath = FLIPipeline::GetDefaultPath(FString::Printf(TEXT("%s.%d"), *Chain.Name, Group.Tasks[0] - Chain.FirstTask));
+	if (Pipeline.SaveToFile(PipelinePath))
+	{
+		Execution->CommandletProcess = FLICommandletProcess::Execute(TEXT("LIPipeline"), PipelinePath, true, TaskListModels[Execution->TaskIndex]->Task.bBackground ? -1 : 0);
+	}
+
+	if (!Execution->CommandletProcess.IsValid())
+	{
+		TaskListModels[Execution->TaskIndex]->State = FTaskListModel::EState::Failed;
+		return;
+	}
+
+	// Every task of the group shares the one process, the pipeline's markers move them along from here.
+	for (const int32 TaskIndex : Execution->PipelineTaskIndices)
+	{
+		TaskListModels[TaskIndex]->ProcessArguments = Execution->CommandletProcess->GetProcessArguments();
+	}
+	MarkTaskStarted(TaskListModels[Execution->TaskIndex]);
+
+	Group.Execution = Execution;
+	StartLogPump(*Execution);
+}
+
+void SLICommandletExecutor::StartLogPump(FExecution& Execution)
+{
+	class FCommandletLogPump : public FRunnable
+	{
+	public:
+		FCommandletLogPump(void* const InReadPipe, const FProcHandle& InCommandletProcessHandle, const uint32 InProcessId, FExecution& InExecution)
+			: ReadPipe(InReadPipe)
+			, CommandletProcessHandle(InCommandletProcessHandle)
+			, ProcessId(InProcessId)
+			, Execution(InExecution)
+			, LogQueue(InExecution.LogQueue)
+			, Usage(InExecution.ProcessUsage)
+		{
+		}
+
+		uint32 Run() override
+		{
+			FLILogQueue::FChunk* Chunk = nullptr;
+			double NextUsageSample = 0.0;
+
+			for(;;)
+			{
+				// Sampled while the process is still around, some platforms forget about it as soon as it has exited.
+				if (FPlatformTime::Seconds() >= NextUsageSample)
+				{
+					FLIProcessUsage::SampleProcess(CommandletProcessHandle, ProcessId, Usage);
+					NextUsageSample = FPlatformTime::Seconds() + LICommandletExecutor::UsageSampleSeconds;
+				}
+
+				// Read from pipe straight into a chunk, which is handed over as is.
+				if (!Chunk)
+				{
+					Chunk = LogQueue.AcquireChunk();
+				}
+
+				const bool bRead = FPlatformProcess::ReadPipeToArray(ReadPipe, *Chunk) && Chunk->Num() > 0;
+				if (bRead)
+				{
+					LogQueue.Push(Chunk);
+					Chunk = nullptr;
+				}
+
+				// If the process isn't running and there's no data in the pipe, we're done.
+				if (!FPlatformProcess::IsProcRunning(CommandletProcessHandle) && !bRead)
+				{
+					break;
+				}
+
+				// Wait for more output, waking up now and then to notice the process exiting.
+				if (!bRead)
+				{
+					LICommandletExecutor::WaitForPipe(ReadPipe);
+				}
+			}
+
+			// Only the consumer hands chunks back to the pool.
+			delete Chunk;
+
+			// Exact where the process can still be asked after exiting, otherwise the last sample stands.
+			FLIProcessUsage::SampleProcess(CommandletProcessHandle, ProcessId, Usage);
+
+			int32 ReturnCode = 0;
+			Execution.PumpReturnCode = FPlatformProcess::GetProcReturnCode(CommandletProcessHandle, &ReturnCode) ? ReturnCode : -1;
+			Execution.bPumpFinished = true;
+			return Execution.PumpReturnCode;
+		}
+
+	private:
+		void* const ReadPipe;
+		FProcHandle CommandletProcessHandle;
+		const uint32 ProcessId;
+		FExecution& Execution;
+		FLILogQueue& LogQueue;
+		FLIProcessUsage& Usage;
+	};
 
-		// Copy the pending data string to the local string
-		{
-			FScopeLock ScopeLock(&PendingLogData.CriticalSection);
-			String = PendingLogData.String;
-			PendingLogData.String.Empty();
-		}
+	// Launch runnable thread.
+	const TSharedPtr<FLICommandletProcess>& CommandletProcess = Execution.CommandletProcess;
+	Execution.ProcessUsage = FLIProcessUsage();
+	Execution.bPumpFinished = false;
+	Execution.Runnable = new FCommandletLogPump(CommandletProcess->GetReadPipe(), CommandletProcess->GetHandle(), CommandletProcess->GetProcessId(), Execution);
+	Execution.RunnableThread = FRunnableThread::Create(Execution.Runnable, TEXT("Localization Commandlet Log Pump Thread"));
+}
 
-		// Forward string to proper log.
-		if (TaskListModels.IsValidIndex(CurrentTaskIndex))
+void SLICommandletExecutor::CancelCommandlet()
+{
+	for (FTaskGroup& Group : TaskGroups)
+	{
+		if (Group.Execution.IsValid())
 		{
-			const TSharedPtr<FTaskListModel> CurrentTaskModel = TaskListModels[CurrentTaskIndex];
-			CurrentTaskModel->LogOutput.Append(String);
+			CleanUpExecution(*Group.Execution);
+			Group.Execution.Reset();
 		}
 	}
 
-	// On Task Completed.
-	if (CommandletProcess.IsValid())
+	// Nothing starts after this, whatever was still to come shows as not run.
+	for (FChain& Chain : Chains)
 	{
-		FProcHandle CurrentProcessHandle = CommandletProcess->GetHandle();
-		int32 ReturnCode;
-		if (CurrentProcessHandle.IsValid() && FPlatformProcess::GetProcReturnCode(CurrentProcessHandle, &ReturnCode))
+		if (Chain.State != FChain::EState::Succeeded)
 		{
-			OnCommandletProcessCompletion(ReturnCode);
+			Chain.State = FChain::EState::Failed;
 		}
 	}
-}
 
-bool SLICommandletExecutor::WasSuccessful() const
-{
-	return HasCompleted() && !TaskListModels.ContainsByPredicate([](const TSharedPtr<FTaskListModel>& TaskListModel){return TaskListModel->State != FTaskListModel::EState::Succeeded;});
+	// A cancelled run still gets its summary, as far as it got.
+	if (RunSummary.IsValid() && !RunSummary->IsFinished())
+	{
+		FinishRun();
+	}
 }
 
-void SLICommandletExecutor::Log(const FString& String)
+void SLICommandletExecutor::CleanUpExecution(FExecution& Execution)
 {
-	FScopeLock ScopeLock(&PendingLogData.CriticalSection);
-	PendingLogData.String += String;
-}
+	// The waits below are on the game thread, the queue's only consumer. A producer that fell a whole queue behind
+	// (the UI stalled during a long gather, say) would otherwise wait for room forever and never finish.
+	Execution.LogQueue.Stop();
 
-void SLICommandletExecutor::OnCommandletProcessCompletion(const int32 ReturnCode)
-{
-	CleanUpProcessAndPump();
+	// Work inside the editor can't be interrupted, but it's short enough to wait for.
+	if (Execution.InEditorResult.IsValid())
+	{
+		Execution.InEditorResult.Wait();
+		Execution.InEditorResult = TFuture<bool>();
+	}
 
-	// Handle return code.
-	TSharedPtr<FTaskListModel> CurrentTaskModel = TaskListModels[CurrentTaskIndex];
+	if (Execution.InEditorLogCapture.IsValid())
+	{
+		GLog->RemoveOutputDevice(Execution.InEditorLogCapture.Get());
+		Execution.InEditorLogCapture.Reset();
+	}
 
-	// Restore engine's source control settings if necessary.
-	if (!CurrentTaskModel->Task.ShouldUseProjectFile)
+	// A terminated process stops the pump as well, once it has read what's left in the pipe.
+	if (Execution.CommandletProcess.IsValid())
 	{
-		const FString& EngineIniFile = SourceControlHelpers::GetGlobalSettingsIni();
-		const FString BackupEngineIniFile = FPaths::EngineSavedDir() / FPaths::GetCleanFilename(EngineIniFile) + TEXT(".bak");
-		if(!IFileManager::Get().Move(*EngineIniFile, *BackupEngineIniFile))
+		FProcHandle CommandletProcessHandle = Execution.CommandletProcess->GetHandle();
+		if (CommandletProcessHandle.IsValid() && FPlatformProcess::IsProcRunning(CommandletProcessHandle))
 		{
-			// (From engine source code) TODO: Error failed to restore engine source control settings INI.
+			FPlatformProcess::TerminateProc(CommandletProcessHandle, true);
 		}
 	}
 
-	// Zero code is successful.
-	if (ReturnCode == 0)
+	// The pump reads from the pipe and asks after the process handle, so it has to be done before the process closes them.
+	if (Execution.RunnableThread)
 	{
-		CurrentTaskModel->State = FTaskListModel::EState::Succeeded;
+		Execution.RunnableThread->WaitForCompletion();
+		delete Execution.RunnableThread;
+		Execution.RunnableThread = nullptr;
+	}
 
-		++CurrentTaskIndex;
+	if (Execution.Runnable)
+	{
+		delete Execution.Runnable;
+		Execution.Runnable = nullptr;
+	}
 
-		// Begin new task if possible.
-		if (TaskListModels.IsValidIndex(CurrentTaskIndex))
-		{
-			CurrentTaskModel = TaskListModels[CurrentTaskIndex];
-			
-			ExecuteCommandlet(CurrentTaskModel.ToSharedRef());
+	Execution.CommandletProcess.Reset();
+}
 
-			if (TaskListView.IsValid())
-			{
-				TaskListView->SetSelection(TaskListModels[CurrentTaskIndex]);
-			}
-		}
-	}
-	// Non-zero is a failure.
-	else
+bool SLICommandletExecutor::IsEditorBusy() const
+{
+	return TaskGroups.ContainsByPredicate([](const FTaskGroup& Group)
 	{
-		CurrentTaskModel->State = FTaskListModel::EState::Failed;
-	}
+		return Group.Execution.IsValid() && Group.Execution->InEditorResult.IsValid();
+	});
+}
+
+bool SLICommandletExecutor::HasCompleted() const
+{
+	return !Chains.ContainsByPredicate([](const FChain& Chain){ return Chain.State != FChain::EState::Succeeded; });
 }
 
-TSharedPtr<FLICommandletProcess> FLICommandletProcess::Execute(const FString& ConfigFilePath, const bool UseProjectFile)
+bool SLICommandletExecutor::IsRunFinished() const
 {
-	// Create pipes.
-	void* ReadPipe;
-	void* WritePipe;
-	if (!FPlatformProcess::CreatePipe(ReadPipe, WritePipe))
+	// A chain that failed, or never started because of one that did, is done too. Chains only settle once nothing of theirs runs.
+	return !Chains.ContainsByPredicate([](const FChain& Chain)
 	{
-		return nullptr;
-	}
+		return Chain.State == FChain::EState::Waiting || Chain.State == FChain::EState::Running;
+	});
+}
 
-	// Create process.
-	const bool isPython = ConfigFilePath.Contains(TEXT("update_translations"));
-	FString CommandletArguments;
-	
-	const FString ConfigFileRelativeToGameDir = LocalizationConfigurationScript::MakePathRelativeForCommandletProcess(ConfigFilePath, UseProjectFile);
-	CommandletArguments = isPython ? FString::Printf(TEXT("-script=\"%s\""), *ConfigFilePath) : FString::Printf( TEXT("-config=\"%s\""), *ConfigFileRelativeToGameDir );
+void SLICommandletExecutor::FinishRun()
+{
+	RunEndTime = FPlatformTime::Seconds();
 
-	if (FLocalizationSourceControlSettings::IsSourceControlEnabled())
+	for (const TSharedPtr<FTaskListModel>& TaskListModel : TaskListModels)
 	{
-		CommandletArguments += TEXT(" -EnableSCC");
+		FLIRunSummary::FStage Stage;
+		Stage.Name = GetTaskDisplayName(*TaskListModel).ToString();
+		Stage.Kind = bSingleProcess ? FLIRunSummary::EStageKind::Step : TaskListModel->Task.Work ? FLIRunSummary::EStageKind::Editor : FLIRunSummary::EStageKind::Process;
+		Stage.Usage = TaskListModel->Usage;
 
-		if (!FLocalizationSourceControlSettings::IsSourceControlAutoSubmitEnabled())
+		switch (TaskListModel->State)
 		{
-			CommandletArguments += TEXT(" -DisableSCCSubmit");
+		case FTaskListModel::EState::Succeeded:
+			Stage.Result = TEXT("Succeeded");
+			break;
+		case FTaskListModel::EState::Failed:
+			Stage.Result = TEXT("Failed");
+			break;
+		case FTaskListModel::EState::Skipped:
+			Stage.Result = TEXT("Skipped");
+			break;
+		case FTaskListModel::EState::Cached:
+			Stage.Result = TEXT("Up to date");
+			break;
+		case FTaskListModel::EState::InProgress:
+			Stage.Result = TEXT("Cancelled");
+			break;
+		default:
+			Stage.Result = TEXT("Not run");
+			break;
+		}
+
+		if (TaskListModel->StartTime > 0.0)
+		{
+			Stage.WallSeconds = (TaskListModel->EndTime > 0.0 ? TaskListModel->EndTime : FPlatformTime::Seconds()) - TaskListModel->StartTime;
 		}
+
+		RunSummary->AddStage(Stage);
 	}
 
-	const FString ProjectFilePath = FString::Printf(TEXT("\"%s\""), *FPaths::ConvertRelativePathToFull(FPaths::GetProjectFilePath()));
-	const FString ProcessArguments = CommandletHelpers::BuildCommandletProcessArguments(isPython ? TEXT("pythonscript") : TEXT("GatherText"), UseProjectFile ? *ProjectFilePath : nullptr, *CommandletArguments);
-	FProcHandle CommandletProcessHandle = FPlatformProcess::CreateProc(*FUnrealEdMisc::Get().GetExecutableForCommandlets(), *ProcessArguments, true, true, true, nullptr, 0, nullptr, WritePipe);
+	RunSummary->Finish(WasSuccessful());
 
-	// Close pipes if process failed.
-	if (!CommandletProcessHandle.IsValid())
+	// Written once for the whole run, the durations were recorded as each task finished.
+	TaskHistory.Save();
+}
+
+FText SLICommandletExecutor::GetRunSummaryText() const
+{
+	const FText WallTime = FText::AsTimespan(FTimespan::FromSeconds(FMath::CeilToDouble(RunSummary->GetWallSeconds())));
+	if (RunSummary->GetPeakResidentBytes() == 0)
 	{
-		FPlatformProcess::ClosePipe(ReadPipe, WritePipe);
-		return nullptr;
+		return FText::Format(LOCTEXT("RunSummary", "Took {0}."), WallTime);
 	}
 
-	return MakeShareable(new FLICommandletProcess(ReadPipe, WritePipe, CommandletProcessHandle, ProcessArguments));
+	return FText::Format(LOCTEXT("RunSummaryWithUsage", "Took {0}, {1} of CPU time, peak memory {2}."),
+		WallTime, FText::AsTimespan(FTimespan::FromSeconds(FMath::CeilToDouble(RunSummary->GetCPUSeconds()))), FText::AsMemory(RunSummary->GetPeakResidentBytes()));
 }
 
-FLICommandletProcess::~FLICommandletProcess()
+FText SLICommandletExecutor::GetTaskDisplayName(const FTaskListModel& TaskListModel) const
 {
-	if (ProcessHandle.IsValid() && FPlatformProcess::IsProcRunning(ProcessHandle))
+	// With several chains in the list, their tasks go by the same names.
+	if (Chains.Num() < 2)
 	{
-		FPlatformProcess::TerminateProc(ProcessHandle);
+		return TaskListModel.Task.Name;
 	}
-	FPlatformProcess::ClosePipe(ReadPipe, WritePipe);
+
+	return FText::Format(LOCTEXT("ChainTaskName", "{0}: {1}"), FText::FromString(Chains[TaskListModel.ChainIndex].Name), TaskListModel.Task.Name);
 }
 
-void SLICommandletExecutor::ExecuteCommandlet(const TSharedRef<FTaskListModel>& TaskListModel)
+FText SLICommandletExecutor::GetProgressMessageText() const
 {
-	// Handle source control settings if not using project file for commandlet executable process.
-	if (!TaskListModel->Task.ShouldUseProjectFile)
+	// The tasks running right now, and the time left for the whole run when every remaining task has something to go on.
+	TArray<FString> RunningTasks;
+	double LongestPathTimeLeft = 0.0;
+	double TotalTimeLeft = 0.0;
+	bool bTimeLeftKnown = true;
+
+	// When each task would be done if nothing held it up but what it depends on.
+	TArray<double> FinishTimes;
+	FinishTimes.Init(0.0, TaskListModels.Num());
+
+	// A chain that succeeded may still have background tasks to go.
+	for (const FChain& Chain : Chains)
 	{
-		const FString& EngineIniFile = SourceControlHelpers::GetGlobalSettingsIni();
+		if (Chain.State == FChain::EState::Failed)
+		{
+			continue;
+		}
 
-		// Backup engine's source control settings.
-		const FString BackupEngineIniFile = FPaths::EngineSavedDir() / FPaths::GetCleanFilename(EngineIniFile) + TEXT(".bak");
-		if (COPY_OK == IFileManager::Get().Copy(*BackupEngineIniFile, *EngineIniFile))
+		double ChainTimeLeft = 0.0;
+		for (int32 TaskIndex = Chain.FirstTask; TaskIndex < Chain.EndTask; ++TaskIndex)
 		{
-			// Replace engine's source control settings with project's.
-			const FString& ProjectIniFile = SourceControlHelpers::GetSettingsIni();
-			if (COPY_OK == IFileManager::Get().Copy(*EngineIniFile, *ProjectIniFile))
+			const FTaskListModel& TaskListModel = *TaskListModels[TaskIndex];
+			if (TaskListModel.State == FTaskListModel::EState::InProgress)
 			{
-				// (From engine source code) TODO: Error failed to overwrite engine source control settings INI.
+				RunningTasks.Add(GetTaskDisplayName(TaskListModel).ToString());
 			}
+
+			const double TaskTimeLeft = GetTaskTimeLeft(TaskListModel);
+			bTimeLeftKnown &= TaskTimeLeft >= 0.0;
+
+			// Tasks only depend on earlier ones, so theirs are already worked out.
+			double StartTime = 0.0;
+			for (const int32 Dependency : TaskListModel.Dependencies)
+			{
+				StartTime = FMath::Max(StartTime, FinishTimes[Dependency]);
+			}
+			FinishTimes[TaskIndex] = StartTime + FMath::Max(TaskTimeLeft, 0.0);
+
+			ChainTimeLeft = FMath::Max(ChainTimeLeft, FinishTimes[TaskIndex]);
+			TotalTimeLeft += FMath::Max(TaskTimeLeft, 0.0);
 		}
-		else
-		{
-			// (From engine source code) TODO: Error failed to backup engine source control settings INI.
-		}
-	}
 
-	CommandletProcess = FLICommandletProcess::Execute(TaskListModel->Task.ScriptPath, TaskListModel->Task.ShouldUseProjectFile);
-	
-	if (CommandletProcess.IsValid())
-	{
-		TaskListModel->State = FTaskListModel::EState::InProgress;
-		TaskListModel->ProcessArguments = CommandletProcess->GetProcessArguments();
+		LongestPathTimeLeft = FMath::Max(LongestPathTimeLeft, ChainTimeLeft);
 	}
-	else
+
+	if (RunningTasks.Num() == 0)
 	{
-		TaskListModel->State = FTaskListModel::EState::Failed;
-		return;
+		return FText::GetEmpty();
 	}
 
-	class FCommandletLogPump : public FRunnable
-	{
-	public:
-		FCommandletLogPump(void* const InReadPipe, const FProcHandle& InCommandletProcessHandle, SLICommandletExecutor& InCommandletWidget)
-			: ReadPipe(InReadPipe)
-			, CommandletProcessHandle(InCommandletProcessHandle)
-			, CommandletWidget(&InCommandletWidget)
-		{
-		}
+	// Tasks run side by side, so the longest path through them decides, unless there's more work than may run at once.
+	const FText TaskNames = FText::FromString(FString::Join(RunningTasks, TEXT(", ")));
+	const double TimeLeft = FMath::Max(LongestPathTimeLeft, TotalTimeLeft / MaxParallelTasks);
+	return !bTimeLeftKnown ? TaskNames : FText::Format(LOCTEXT("ProgressMessageWithTimeLeft", "{0} (about {1} left)"), TaskNames, FText::AsTimespan(FTimespan::FromSeconds(FMath::CeilToDouble(TimeLeft))));
+}
 
-		uint32 Run() override
+TOptional<float> SLICommandletExecutor::GetProgressPercentage() const
+{
+	// Tasks are weighted by how long they usually take, so a long gather isn't worth the same as a short compile.
+	double KnownDurations = 0.0;
+	int32 NumKnown = 0;
+	for (const TSharedPtr<FTaskListModel>& TaskListModel : TaskListModels)
+	{
+		const double Expected = GetExpectedDuration(*TaskListModel);
+		if (Expected > 0.0)
 		{
-			for(;;)
-			{
-				// Read from pipe.
-				const FString PipeString = FPlatformProcess::ReadPipe(ReadPipe);
-
-				// Process buffer.
-				if (!PipeString.IsEmpty())
-				{
-					// Add strings to log.
-					if (CommandletWidget)
-					{
-						CommandletWidget->Log(PipeString);
-					}
-				}
-
-				// If the process isn't running and there's no data in the pipe, we're done.
-				if (!FPlatformProcess::IsProcRunning(CommandletProcessHandle) && PipeString.IsEmpty())
-				{
-					break;
-				}
-
-				// Sleep.
-				FPlatformProcess::Sleep(0.0f);
-			}
-
-			int32 ReturnCode = 0;
-			return FPlatformProcess::GetProcReturnCode(CommandletProcessHandle, &ReturnCode) ? ReturnCode : -1;
+			KnownDurations += Expected;
+			++NumKnown;
 		}
+	}
+	const double DefaultWeight = NumKnown > 0 ? KnownDurations / NumKnown : 1.0;
 
-	private:
-		void* const ReadPipe;
-		FProcHandle CommandletProcessHandle;
-		SLICommandletExecutor* const CommandletWidget;
-	};
+	double Done = 0.0;
+	double Total = 0.0;
+	for (const TSharedPtr<FTaskListModel>& TaskListModel : TaskListModels)
+	{
+		const double Expected = GetExpectedDuration(*TaskListModel);
+		const double Weight = Expected > 0.0 ? Expected : DefaultWeight;
+		Done += Weight * GetTaskFraction(*TaskListModel);
+		Total += Weight;
+	}
 
-	// Launch runnable thread.
-	Runnable = new FCommandletLogPump(CommandletProcess->GetReadPipe(), CommandletProcess->GetHandle(), *this);
-	RunnableThread = FRunnableThread::Create(Runnable, TEXT("Localization Commandlet Log Pump Thread"));
+	return TOptional<float>(Total > 0.0 ? float(Done / Total) : 0.0f);
 }
 
-void SLICommandletExecutor::CancelCommandlet()
+double SLICommandletExecutor::GetExpectedDuration(const FTaskListModel& TaskListModel) const
 {
-	CleanUpProcessAndPump();
+	return TaskHistory.GetDuration(FLITaskHistory::MakeKey(TaskListModel.Task.CommandletName, TaskListModel.Task.ScriptPath));
 }
 
-void SLICommandletExecutor::CleanUpProcessAndPump()
+float SLICommandletExecutor::GetTaskFraction(const FTaskListModel& TaskListModel) const
 {
-	if (CommandletProcess.IsValid())
+	switch (TaskListModel.State)
 	{
-		FProcHandle CommandletProcessHandle = CommandletProcess->GetHandle();
-		if (CommandletProcessHandle.IsValid() && FPlatformProcess::IsProcRunning(CommandletProcessHandle))
-		{
-			FPlatformProcess::TerminateProc(CommandletProcessHandle, true);
-		}
-		CommandletProcess.Reset();
+	case FTaskListModel::EState::Queued:
+		return 0.0f;
+	case FTaskListModel::EState::InProgress:
+		break;
+	default:
+		return 1.0f;
+	}
+
+	const float Reported = TaskListModel.Progress.GetFraction();
+	if (Reported >= 0.0f)
+	{
+		return Reported;
 	}
 
-	if (RunnableThread)
+	// Without progress lines the bar moves with the clock, stopping short of the end in case this run is slower.
+	const double Expected = GetExpectedDuration(TaskListModel);
+	return Expected > 0.0 ? FMath::Min(float((FPlatformTime::Seconds() - TaskListModel.StartTime) / Expected), 0.95f) : 0.0f;
+}
+
+double SLICommandletExecutor::GetTaskTimeLeft(const FTaskListModel& TaskListModel) const
+{
+	const double Expected = GetExpectedDuration(TaskListModel);
+
+	switch (TaskListModel.State)
 	{
-		RunnableThread->WaitForCompletion();
-		delete RunnableThread;
-		RunnableThread = nullptr;
+	case FTaskListModel::EState::Queued:
+		return TaskListModel.Task.bUpToDate ? 0.0 : Expected > 0.0 ? Expected : -1.0;
+	case FTaskListModel::EState::InProgress:
+		break;
+	default:
+		return 0.0;
 	}
 
-	if (Runnable)
+	const double Elapsed = FPlatformTime::Seconds() - TaskListModel.StartTime;
+	const float Reported = TaskListModel.Progress.GetFraction();
+
+	// Extrapolating from very little progress swings around too much to be useful.
+	if (Reported >= 0.05f)
 	{
-		delete Runnable;
-		Runnable = nullptr;
+		return Elapsed / Reported - Elapsed;
 	}
 
+	return Expected > 0.0 ? FMath::Max(Expected - Elapsed, 0.0) : -1.0;
 }
 
-bool SLICommandletExecutor::HasCompleted() const
+FText SLICommandletExecutor::GetTaskProgressText(const FTaskListModel& TaskListModel) const
 {
-	return CurrentTaskIndex == TaskListModels.Num();
+	// Tasks that are done show how long they took.
+	if (TaskListModel.State != FTaskListModel::EState::InProgress)
+	{
+		return TaskListModel.EndTime > TaskListModel.StartTime && TaskListModel.StartTime > 0.0
+			? FText::AsTimespan(FTimespan::FromSeconds(FMath::CeilToDouble(TaskListModel.EndTime - TaskListModel.StartTime)))
+			: FText::GetEmpty();
+	}
+
+	FNumberFormattingOptions PercentFormat;
+	PercentFormat.MaximumFractionalDigits = 0;
+	const FText Percent = FText::AsPercent(GetTaskFraction(TaskListModel), &PercentFormat);
+
+	const double TimeLeft = GetTaskTimeLeft(TaskListModel);
+	return TimeLeft < 0.0 ? Percent : FText::Format(LOCTEXT("TaskProgressWithTimeLeft", "{0}, {1} left"), Percent, FText::AsTimespan(FTimespan::FromSeconds(FMath::CeilToDouble(TimeLeft))));
 }
 
-FText SLICommandletExecutor::GetProgressMessageText() const
+void SLICommandletExecutor::GetTaskTimeline(const FTaskListModel& TaskListModel, float& OutStart, float& OutEnd) const
 {
-	return TaskListModels.IsValidIndex(CurrentTaskIndex) ? TaskListModels[CurrentTaskIndex]->Task.Name : FText::GetEmpty();
+	OutStart = 0.0f;
+	OutEnd = 0.0f;
+	if (TaskListModel.StartTime <= 0.0)
+	{
+		return;
+	}
+
+	const double Now = RunEndTime > 0.0 ? RunEndTime : FPlatformTime::Seconds();
+	const double RunSeconds = Now - RunStartTime;
+	if (RunSeconds <= 0.0)
+	{
+		return;
+	}
+
+	const double EndTime = TaskListModel.EndTime > 0.0 ? TaskListModel.EndTime : Now;
+	OutStart = FMath::Clamp(float((TaskListModel.StartTime - RunStartTime) / RunSeconds), 0.0f, 1.0f);
+	OutEnd = FMath::Clamp(float((EndTime - RunStartTime) / RunSeconds), OutStart, 1.0f);
 }
 
-TOptional<float> SLICommandletExecutor::GetProgressPercentage() const
+FText SLICommandletExecutor::GetTaskUsageText(const FTaskListModel& TaskListModel) const
 {
-	return TOptional<float>(float(CurrentTaskIndex) / float(TaskListModels.Num()));
+	if (!TaskListModel.Usage.IsValid())
+	{
+		return FText::GetEmpty();
+	}
+
+	FNumberFormattingOptions SecondsFormat;
+	SecondsFormat.MaximumFractionalDigits = 1;
+	return FText::Format(LOCTEXT("TaskUsage", "{0} seconds of CPU time, peak memory {1}"),
+		FText::AsNumber(TaskListModel.Usage.CPUSeconds, &SecondsFormat), FText::AsMemory(TaskListModel.Usage.PeakResidentBytes));
 }
 
 #pragma region TaskRow
 class STaskRow : public SMultiColumnTableRow< TSharedPtr<SLICommandletExecutor::FTaskListModel> >
 {
 public:
-	void Construct(const FTableRowArgs& InArgs, const TSharedRef<STableViewBase>& OwnerTableView, const TSharedRef<SLICommandletExecutor::FTaskListModel>& InTaskListModel);
+	void Construct(const FTableRowArgs& InArgs, const TSharedRef<STableViewBase>& OwnerTableView, const TSharedRef<SLICommandletExecutor::FTaskListModel>& InTaskListModel, const SLICommandletExecutor& InExecutor);
 	TSharedRef<SWidget> GenerateWidgetForColumn(const FName& ColumnName);
 
 private:
 	FSlateColor HandleIconColorAndOpacity() const;
+	float HandleTimelineFill(const int32 Part) const;
 	const FSlateBrush* HandleIconImage() const;
 	EVisibility HandleThrobberVisibility() const;
 	
 	TSharedPtr<SLICommandletExecutor::FTaskListModel> TaskListModel;
+
+	// Owns the list this row is in, so it outlives the row.
+	const SLICommandletExecutor* Executor;
 };
 
-void STaskRow::Construct(const FTableRowArgs& InArgs, const TSharedRef<STableViewBase>& OwnerTableView, const TSharedRef<SLICommandletExecutor::FTaskListModel>& InTaskListModel)
+void STaskRow::Construct(const FTableRowArgs& InArgs, const TSharedRef<STableViewBase>& OwnerTableView, const TSharedRef<SLICommandletExecutor::FTaskListModel>& InTaskListModel, const SLICommandletExecutor& InExecutor)
 {
 	TaskListModel = InTaskListModel;
+	Executor = &InExecutor;
 
 	FSuperRowType::Construct(InArgs, OwnerTableView);
 }
@@ -494,10 +1606,77 @@ TSharedRef<SWidget> STaskRow::GenerateWidgetForColumn(const FName& ColumnName)
 			];
 	}
 	else if (ColumnName == "TaskName")
+	{
+		return SNew(SHorizontalBox)
+			+ SHorizontalBox::Slot()
+			.FillWidth(1.0f)
+			[
+				SNew(STextBlock)
+				.Text_Lambda( [this]
+				{
+					return TaskListModel->State == SLICommandletExecutor::FTaskListModel::EState::Cached
+						? FText::Format(LOCTEXT("CachedTaskName", "{0} (up to date)"), Executor->GetTaskDisplayName(*TaskListModel))
+						: Executor->GetTaskDisplayName(*TaskListModel);
+				} )
+				.ToolTipText_Lambda( [this]{ return FText::FromString(TaskListModel->ProcessArguments); } )
+			]
+			// What the task wrote, such as the word count reports, once it's there.
+			+ SHorizontalBox::Slot()
+			.AutoWidth()
+			.Padding(4.0f, 0.0f)
+			[
+				SNew(SHyperlink)
+				.Text(LOCTEXT("OpenTaskOutput", "Show"))
+				.ToolTipText(FText::FromString(TaskListModel->Task.OutputPath))
+				.OnNavigate_Lambda( [this]{ FPlatformProcess::ExploreFolder(*FPaths::ConvertRelativePathToFull(TaskListModel->Task.OutputPath)); } )
+				.Visibility_Lambda( [this]
+				{
+					return TaskListModel->State == SLICommandletExecutor::FTaskListModel::EState::Succeeded && !TaskListModel->Task.OutputPath.IsEmpty()
+						? EVisibility::Visible
+						: EVisibility::Collapsed;
+				} )
+			];
+	}
+	else if (ColumnName == "Timeline")
+	{
+		// Before the task started, while it ran, and after it ended; bars of tasks that ran together line up across rows.
+		return SNew(SHorizontalBox)
+			+ SHorizontalBox::Slot()
+			.FillWidth(TAttribute<float>::Create(TAttribute<float>::FGetter::CreateSP(this, &STaskRow::HandleTimelineFill, 0)))
+			[
+				SNullWidget::NullWidget
+			]
+			+ SHorizontalBox::Slot()
+			.FillWidth(TAttribute<float>::Create(TAttribute<float>::FGetter::CreateSP(this, &STaskRow::HandleTimelineFill, 1)))
+			.Padding(0.0f, 6.0f)
+			[
+				SNew(SImage)
+				.Image(FEditorStyle::GetBrush("WhiteBrush"))
+				.ColorAndOpacity(this, &STaskRow::HandleIconColorAndOpacity)
+			]
+			+ SHorizontalBox::Slot()
+			.FillWidth(TAttribute<float>::Create(TAttribute<float>::FGetter::CreateSP(this, &STaskRow::HandleTimelineFill, 2)))
+			[
+				SNullWidget::NullWidget
+			];
+	}
+	else if (ColumnName == "Progress")
+	{
+		return SNew(STextBlock)
+			.Text_Lambda( [this]{ return Executor->GetTaskProgressText(*TaskListModel); } )
+			.ToolTipText_Lambda( [this]{ return Executor->GetTaskUsageText(*TaskListModel); } );
+	}
+	else if (ColumnName == "Warnings")
+	{
+		return SNew(STextBlock)
+			.ColorAndOpacity(FLinearColor::Yellow)
+			.Text_Lambda( [this]{ return TaskListModel->Log.GetNumWarnings() > 0 ? FText::AsNumber(TaskListModel->Log.GetNumWarnings()) : FText::GetEmpty(); } );
+	}
+	else if (ColumnName == "Errors")
 	{
 		return SNew(STextBlock)
-			.Text(TaskListModel->Task.Name)
-			.ToolTipText_Lambda( [this]{ return FText::FromString(TaskListModel->ProcessArguments); } );
+			.ColorAndOpacity(FLinearColor::Red)
+			.Text_Lambda( [this]{ return TaskListModel->Log.GetNumErrors() > 0 ? FText::AsNumber(TaskListModel->Log.GetNumErrors()) : FText::GetEmpty(); } );
 	}
 	else
 	{
@@ -514,9 +1693,12 @@ FSlateColor STaskRow::HandleIconColorAndOpacity( ) const
 			case SLICommandletExecutor::FTaskListModel::EState::InProgress:
 				return FLinearColor::Yellow;
 			case SLICommandletExecutor::FTaskListModel::EState::Succeeded:
+			case SLICommandletExecutor::FTaskListModel::EState::Cached:
 				return FLinearColor::Green;
 			case SLICommandletExecutor::FTaskListModel::EState::Failed:
 				return FLinearColor::Red;
+			case SLICommandletExecutor::FTaskListModel::EState::Skipped:
+				return FLinearColor::Gray;
 			default:
 				return FSlateColor::UseForeground();
 		}
@@ -525,6 +1707,24 @@ FSlateColor STaskRow::HandleIconColorAndOpacity( ) const
 	return FSlateColor::UseForeground();
 }
 
+float STaskRow::HandleTimelineFill(const int32 Part) const
+{
+	float Start;
+	float End;
+	Executor->GetTaskTimeline(*TaskListModel, Start, End);
+
+	switch (Part)
+	{
+	case 0:
+		return Start;
+	case 1:
+		return End - Start;
+	default:
+		// Keeps a task that never ran from stretching across the whole column.
+		return End > Start ? 1.0f - End : 1.0f;
+	}
+}
+
 const FSlateBrush* STaskRow::HandleIconImage( ) const
 {
 	if (TaskListModel.IsValid())
@@ -532,6 +1732,8 @@ const FSlateBrush* STaskRow::HandleIconImage( ) const
 		switch(TaskListModel->State)
 		{
 			case SLICommandletExecutor::FTaskListModel::EState::Succeeded:
+			case SLICommandletExecutor::FTaskListModel::EState::Skipped:
+			case SLICommandletExecutor::FTaskListModel::EState::Cached:
 				return FEditorStyle::GetBrush("Symbols.Check");
 			case SLICommandletExecutor::FTaskListModel::EState::Failed:
 				return FEditorStyle::GetBrush("Icons.Cross");
@@ -562,7 +1764,7 @@ EVisibility STaskRow::HandleThrobberVisibility( ) const
 
 TSharedRef<ITableRow> SLICommandletExecutor::OnGenerateTaskListRow(TSharedPtr<FTaskListModel> TaskListModel, const TSharedRef<STableViewBase>& Table)
 {
-	return SNew(STaskRow, Table, TaskListModel.ToSharedRef());
+	return SNew(STaskRow, Table, TaskListModel.ToSharedRef(), *this);
 }
 
 TSharedPtr<SLICommandletExecutor::FTaskListModel> SLICommandletExecutor::GetCurrentTaskToView() const
@@ -581,10 +1783,108 @@ FText SLICommandletExecutor::GetCurrentTaskProcessArguments() const
 	return TaskToView.IsValid() ? FText::FromString(TaskToView->ProcessArguments) : FText::GetEmpty();
 }
 
-FText SLICommandletExecutor::GetLogString() const
+FString SLICommandletExecutor::GetLogString() const
 {
 	const TSharedPtr<SLICommandletExecutor::FTaskListModel> TaskToView = GetCurrentTaskToView();
-	return TaskToView.IsValid() ? FText::FromString(TaskToView->LogOutput) : FText::GetEmpty();
+	return TaskToView.IsValid() ? TaskToView->Log.ToString() : FString();
+}
+
+TSharedRef<ITableRow> SLICommandletExecutor::OnGenerateLogRow(TSharedPtr<FLILogBuffer::FLine> Line, const TSharedRef<STableViewBase>& Table)
+{
+	const FString LineText = ViewedTask.IsValid() ? ViewedTask->Log.GetLineText(*Line) : FString();
+
+	return SNew(STableRow< TSharedPtr<FLILogBuffer::FLine> >, Table)
+		.ShowSelection(false)
+		[
+			SNew(STextBlock)
+			.TextStyle(FEditorStyle::Get(), "LocalizationDashboard.CommandletLog.Text")
+			.Text(FText::FromString(LineText))
+		];
+}
+
+void SLICommandletExecutor::OnTaskSelectionChanged(TSharedPtr<FTaskListModel> TaskListModel, ESelectInfo::Type SelectInfo)
+{
+	if (TaskListModel != ViewedTask)
+	{
+		// Categories are numbered per task, so a category filter doesn't carry over.
+		ViewedTask = TaskListModel;
+		LogFilter.Category = INDEX_NONE;
+		RefreshLogView(true);
+	}
+}
+
+TSharedRef<SWidget> SLICommandletExecutor::GenerateCategoryMenu()
+{
+	FMenuBuilder MenuBuilder(true, nullptr);
+
+	auto AddCategory = [this, &MenuBuilder](const FText& Label, const int32 Category)
+	{
+		MenuBuilder.AddMenuEntry(
+			Label,
+			FText::GetEmpty(),
+			FSlateIcon(),
+			FUIAction(
+				FExecuteAction::CreateLambda([this, Category]{ LogFilter.Category = Category; RefreshLogView(false); }),
+				FCanExecuteAction(),
+				FIsActionChecked::CreateLambda([this, Category]{ return LogFilter.Category == Category; })),
+			NAME_None,
+			EUserInterfaceActionType::RadioButton);
+	};
+
+	AddCategory(LOCTEXT("AllCategories", "All Categories"), INDEX_NONE);
+
+	if (ViewedTask.IsValid())
+	{
+		const TArray<FString>& Categories = ViewedTask->Log.GetCategories();
+		for (int32 Category = 0; Category < Categories.Num(); ++Category)
+		{
+			AddCategory(FText::FromString(Categories[Category]), Category);
+		}
+	}
+
+	return MenuBuilder.MakeWidget();
+}
+
+FText SLICommandletExecutor::GetCategoryFilterText() const
+{
+	if (ViewedTask.IsValid() && ViewedTask->Log.GetCategories().IsValidIndex(LogFilter.Category))
+	{
+		return FText::FromString(ViewedTask->Log.GetCategories()[LogFilter.Category]);
+	}
+	return LOCTEXT("AllCategories", "All Categories");
+}
+
+void SLICommandletExecutor::RefreshLogView(const bool bScrollToEnd, const int32 FirstNewLine)
+{
+	if (!LogListView.IsValid())
+	{
+		return;
+	}
+
+	// Without a filter the task's own lines are shown, otherwise the lines the filter lets through, which new lines are added to as they come in.
+	const TArray< TSharedPtr<FLILogBuffer::FLine> >* Lines = &NoLogLines;
+	if (ViewedTask.IsValid() && LogFilter.IsEmpty())
+	{
+		Lines = &ViewedTask->Log.GetLines();
+	}
+	else if (ViewedTask.IsValid())
+	{
+		if (FirstNewLine == 0)
+		{
+			FilteredLogLines.Reset();
+		}
+		ViewedTask->Log.GetFilteredLines(LogFilter, FilteredLogLines, FirstNewLine);
+		Lines = &FilteredLogLines;
+	}
+
+	// Rows are built for the lines they show, so switching tasks has to throw the old ones away.
+	LogListView->SetItemsSource(Lines);
+	LogListView->RequestListRefresh();
+
+	if (bScrollToEnd)
+	{
+		LogListView->ScrollToBottom();
+	}
 }
 
 FReply SLICommandletExecutor::OnCopyLogClicked()
@@ -596,7 +1896,7 @@ FReply SLICommandletExecutor::OnCopyLogClicked()
 
 void SLICommandletExecutor::CopyLogToClipboard()
 {
-	FPlatformApplicationMisc::ClipboardCopy(*(GetLogString().ToString()));
+	FPlatformApplicationMisc::ClipboardCopy(*GetLogString());
 }
 
 FReply SLICommandletExecutor::OnSaveLogClicked()
@@ -633,7 +1933,7 @@ FReply SLICommandletExecutor::OnSaveLogClicked()
 			))
 		{
 			// Save to file.
-			FFileHelper::SaveStringToFile( GetLogString().ToString(), *(SaveFilenames.Last()) );
+			FFileHelper::SaveStringToFile( GetLogString(), *(SaveFilenames.Last()) );
 		}
 	}
 
@@ -642,7 +1942,13 @@ FReply SLICommandletExecutor::OnSaveLogClicked()
 
 FText SLICommandletExecutor::GetCloseButtonText() const
 {
-	return HasCompleted() ? LOCTEXT("OkButtonText", "OK") : LOCTEXT("CancelButtonText", "Cancel");
+	if (!HasCompleted())
+	{
+		return LOCTEXT("CancelButtonText", "Cancel");
+	}
+
+	// Closing stops the background tasks along with the window.
+	return HasBackgroundWork() ? LOCTEXT("StopAndCloseButtonText", "Stop and Close") : LOCTEXT("OkButtonText", "OK");
 }
 
 FReply SLICommandletExecutor::OnCloseButtonClicked()
@@ -0,0 +1,499 @@
+// Copyright (C) 2022 Dakarai Simmons - All Rights Reserved
+
+#include "LIDelimitedReader.h"
+#include "LIImporterSettings.h"
+#include "LocalizationImporter.h"
+#include "Async/MappedFileHandle.h"
+#include "Async/ParallelFor.h"
+#include "HAL/PlatformFilemanager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+
+// SSE2 is part of every x64 CPU; other platforms scan a byte at a time.
+#if PLATFORM_ENABLE_VECTORINTRINSICS && (defined(_M_X64) || defined(__x86_64__))
+#define LIDELIMITED_SSE2 1
+#include <emmintrin.h>
+#else
+#define LIDELIMITED_SSE2 0
+#endif
+
+namespace LIDelimited
+{
+	// Files are cut into chunks of about this size, and up to one chunk per worker is parsed at a time.
+	static const int64 DefaultChunkSize = 8 * 1024 * 1024;
+
+	// Offset is into the file from the chunk's start, or into the chunk's unescaped text.
+	struct FCell
+	{
+		int32 Offset;
+		uint32 Len : 31;
+		uint32 bUnescaped : 1;
+	};
+
+	// Index of the first of up to three characters (repeat one to look for fewer), or End.
+	static int64 FindAny(const ANSICHAR* Data, int64 Pos, const int64 End, const ANSICHAR A, const ANSICHAR B, const ANSICHAR C)
+	{
+#if LIDELIMITED_SSE2
+		const __m128i VectorA = _mm_set1_epi8(A);
+		const __m128i VectorB = _mm_set1_epi8(B);
+		const __m128i VectorC = _mm_set1_epi8(C);
+
+		for(; Pos + 16 <= End; Pos += 16)
+		{
+			const __m128i Block = _mm_loadu_si128((const __m128i*)(Data + Pos));
+			const __m128i Matches = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(Block, VectorA), _mm_cmpeq_epi8(Block, VectorB)), _mm_cmpeq_epi8(Block, VectorC));
+			const uint32 Mask = (uint32)_mm_movemask_epi8(Matches);
+			if(Mask != 0)
+				return Pos + FMath::CountTrailingZeros(Mask);
+		}
+#endif
+
+		for(; Pos < End; ++Pos)
+		{
+			const ANSICHAR Char = Data[Pos];
+			if(Char == A || Char == B || Char == C)
+				return Pos;
+		}
+		return End;
+	}
+
+	// A quote only opens a cell when it's the first character of one.
+	static bool IsCellStart(const ANSICHAR* Data, const int64 Start, const int64 Pos, const ANSICHAR Delimiter)
+	{
+		return Pos == Start || Data[Pos - 1] == Delimiter || Data[Pos - 1] == '\n';
+	}
+
+	// Follows the quotes from Pos to End the way the parser would, and returns whether End falls inside a quoted cell.
+	// Inside one, a doubled quote is text and any other quote closes it. End mustn't come right after a quote.
+	static bool EndsInQuotes(const ANSICHAR* Data, const int64 Start, int64 Pos, const int64 End, const ANSICHAR Delimiter, bool bInQuotes)
+	{
+		for(;;)
+		{
+			Pos = FindAny(Data, Pos, End, '"', '"', '"');
+			if(Pos >= End)
+				return bInQuotes;
+
+			if(!bInQuotes)
+				bInQuotes = IsCellStart(Data, Start, Pos, Delimiter);
+			else if(Pos + 1 < End && Data[Pos + 1] == '"')
+				++Pos;
+			else
+				bInQuotes = false;
+
+			++Pos;
+		}
+	}
+}
+
+struct FLIDelimitedReader::FChunk
+{
+	FChunk()
+		: Begin(0), Cut(0), End(0), ParsedEnd(0), bCutOff(false) {}
+
+	// Rows that start before Cut are parsed, and may run on up to End.
+	int64 Begin;
+	int64 Cut;
+	int64 End;
+
+	// Where the parse stopped, the start of the next row unless the last row was cut off.
+	int64 ParsedEnd;
+
+	// Whether the last row ran into End before the end of the file, so it may go on past it.
+	bool bCutOff;
+
+	// The cells of every row back to back, and the index after each row's last cell.
+	TArray<LIDelimited::FCell> Cells;
+	TArray<int32> RowEnds;
+
+	TArray<ANSICHAR> Unescaped;
+};
+
+FLIDelimitedReader::FLIDelimitedReader()
+	: MappedHandle(nullptr),
+	MappedRegion(nullptr),
+	Data(nullptr),
+	Size(0),
+	Start(0),
+	ChunkSize(LIDelimited::DefaultChunkSize),
+	Delimiter(',')
+{}
+
+FLIDelimitedReader::~FLIDelimitedReader()
+{
+	Close();
+}
+
+bool FLIDelimitedReader::IsDelimitedFile(const FString& Path)
+{
+	const FString Extension = FPaths::GetExtension(Path);
+	return Extension == TEXT("csv") || Extension == TEXT("tsv") || Extension == TEXT("tab");
+}
+
+bool FLIDelimitedReader::Open(const FString& Path)
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(LIDelimitedReader_Open);
+
+	Close();
+	PageName = FPaths::GetBaseFilename(Path);
+
+	IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+	MappedHandle = PlatformFile.OpenMapped(*Path);
+	if(MappedHandle && MappedHandle->GetFileSize() > 0)
+		MappedRegion = MappedHandle->MapRegion();
+
+	if(MappedRegion)
+	{
+		Data = (const ANSICHAR*)MappedRegion->GetMappedPtr();
+		Size = MappedRegion->GetMappedSize();
+	}
+	else
+	{
+		if(!FFileHelper::LoadFileToArray(LoadedData, *Path))
+		{
+			Close();
+			return false;
+		}
+
+		Data = (const ANSICHAR*)LoadedData.GetData();
+		Size = LoadedData.Num();
+	}
+
+	const uint8* Bytes = (const uint8*)Data;
+	if(Size >= 2 && ((Bytes[0] == 0xFF && Bytes[1] == 0xFE) || (Bytes[0] == 0xFE && Bytes[1] == 0xFF)))
+	{
+		// Excel's "Unicode Text" export. The file helper knows both byte orders.
+		FString Text;
+		if(!FFileHelper::LoadFileToString(Text, *Path))
+		{
+			Close();
+			return false;
+		}
+
+		delete MappedRegion;
+		MappedRegion = nullptr;
+		delete MappedHandle;
+		MappedHandle = nullptr;
+
+		const FTCHARToUTF8 Converted(*Text);
+		LoadedData.Reset(Converted.Length());
+		LoadedData.Append((const uint8*)Converted.Get(), Converted.Length());
+		Data = (const ANSICHAR*)LoadedData.GetData();
+		Size = LoadedData.Num();
+	}
+	else if(Size >= 3 && Bytes[0] == 0xEF && Bytes[1] == 0xBB && Bytes[2] == 0xBF)
+	{
+		Start = 3;
+	}
+
+	if(Size <= Start)
+	{
+		UE_LOG(LocalizationImporterPlugin, Warning, TEXT("'%s' is empty."), *Path);
+		Close();
+		return false;
+	}
+
+	Delimiter = DetectDelimiter(FPaths::GetExtension(Path) == TEXT("csv") ? ',' : '\t');
+	return true;
+}
+
+void FLIDelimitedReader::Close()
+{
+	// The region has to go before the handle it was mapped from.
+	delete MappedRegion;
+	MappedRegion = nullptr;
+	delete MappedHandle;
+	MappedHandle = nullptr;
+
+	LoadedData.Empty();
+	Data = nullptr;
+	Size = 0;
+	Start = 0;
+	Delimiter = ',';
+	PageName.Reset();
+}
+
+ANSICHAR FLIDelimitedReader::DetectDelimiter(const ANSICHAR DefaultDelimiter) const
+{
+	static const ANSICHAR Candidates[] = { ',', ';', '\t' };
+	int32 Counts[UE_ARRAY_COUNT(Candidates)] = {};
+
+	// The header row is enough to tell, and it's short.
+	bool bInQuotes = false;
+	for(int64 Pos = Start; Pos < Size; ++Pos)
+	{
+		const ANSICHAR Char = Data[Pos];
+		if(Char == '"')
+			bInQuotes = !bInQuotes;
+		else if(Char == '\n' && !bInQuotes)
+			break;
+		else if(!bInQuotes)
+		{
+			for(int32 i = 0; i < UE_ARRAY_COUNT(Candidates); ++i)
+				Counts[i] += Char == Candidates[i] ? 1 : 0;
+		}
+	}
+
+	ANSICHAR Best = DefaultDelimiter;
+	int32 BestCount = 0;
+	for(int32 i = 0; i < UE_ARRAY_COUNT(Candidates); ++i)
+	{
+		if(Candidates[i] == DefaultDelimiter)
+			BestCount = FMath::Max(BestCount, Counts[i]);
+	}
+	for(int32 i = 0; i < UE_ARRAY_COUNT(Candidates); ++i)
+	{
+		if(Counts[i] > BestCount)
+		{
+			Best = Candidates[i];
+			BestCount = Counts[i];
+		}
+	}
+	return Best;
+}
+
+int64 FLIDelimitedReader::FindRowStart(int64 Pos, bool bInQuotes) const
+{
+	while(Pos < Size)
+	{
+		Pos = LIDelimited::FindAny(Data, Pos, Size, '"', '\n', '\n');
+		if(Pos >= Size)
+			break;
+
+		if(Data[Pos] == '"')
+		{
+			if(!bInQuotes)
+				bInQuotes = LIDelimited::IsCellStart(Data, Start, Pos, Delimiter);
+			else if(Pos + 1 < Size && Data[Pos + 1] == '"')
+				++Pos;
+			else
+				bInQuotes = false;
+		}
+		else if(!bInQuotes)
+			return Pos + 1;
+
+		++Pos;
+	}
+	return Size;
+}
+
+void FLIDelimitedReader::ParseChunk(FChunk& Chunk, const int32 MaxRows) const
+{
+	using namespace LIDelimited;
+
+	const int64 End = Chunk.End;
+	int64 Pos = Chunk.Begin;
+	Chunk.bCutOff = false;
+
+	while(Pos < Chunk.Cut && Pos < End && Chunk.RowEnds.Num() < MaxRows)
+	{
+		const int32 FirstCell = Chunk.Cells.Num();
+
+		for(;;)
+		{
+			FCell Cell;
+			Cell.bUnescaped = 0;
+
+			if(Pos < End && Data[Pos] == '"')
+			{
+				// A quoted cell runs up to the first quote that isn't doubled, line breaks and delimiters included.
+				const int64 ValueStart = Pos + 1;
+				int64 Quote = FindAny(Data, ValueStart, End, '"', '"', '"');
+				bool bDoubled = false;
+				while(Quote + 1 < End && Data[Quote + 1] == '"')
+				{
+					bDoubled = true;
+					Quote = FindAny(Data, Quote + 2, End, '"', '"', '"');
+				}
+
+				if(bDoubled)
+				{
+					Cell.Offset = Chunk.Unescaped.Num();
+					for(int64 i = ValueStart; i < Quote; ++i)
+					{
+						Chunk.Unescaped.Add(Data[i]);
+						if(Data[i] == '"')
+							++i;
+					}
+					Cell.Len = Chunk.Unescaped.Num() - Cell.Offset;
+					Cell.bUnescaped = 1;
+				}
+				else
+				{
+					Cell.Offset = int32(ValueStart - Chunk.Begin);
+					Cell.Len = uint32(Quote - ValueStart);
+				}
+
+				// Anything between the closing quote and the next delimiter isn't valid, and is dropped.
+				Pos = FindAny(Data, FMath::Min(Quote + 1, End), End, Delimiter, '\n', '\n');
+			}
+			else
+			{
+				const int64 CellEnd = FindAny(Data, Pos, End, Delimiter, '\n', '\n');
+				int64 ValueEnd = CellEnd;
+				if(ValueEnd > Pos && Data[ValueEnd - 1] == '\r')
+					--ValueEnd;
+
+				Cell.Offset = int32(Pos - Chunk.Begin);
+				Cell.Len = uint32(ValueEnd - Pos);
+				Pos = CellEnd;
+			}
+
+			Chunk.Cells.Add(Cell);
+
+			if(Pos < End && Data[Pos] == Delimiter)
+			{
+				++Pos;
+				continue;
+			}
+
+			// A line break or the end of the chunk ends the row. Only the end of the file is sure to be the end of one.
+			if(Pos < End)
+				++Pos;
+			else
+				Chunk.bCutOff = End < Size;
+			break;
+		}
+
+		// A blank line comes out as a single empty cell.
+		if(Chunk.Cells.Num() == FirstCell + 1 && Chunk.Cells.Last().Len == 0)
+			Chunk.Cells.Pop(false);
+		else
+			Chunk.RowEnds.Add(Chunk.Cells.Num());
+	}
+
+	Chunk.ParsedEnd = Pos;
+}
+
+bool FLIDelimitedReader::ReadHeaderRow(TArray<FString>& OutHeader) const
+{
+	if(!Data)
+		return false;
+
+	FChunk Chunk;
+	Chunk.Begin = Start;
+	Chunk.Cut = Size;
+	Chunk.End = Size;
+	ParseChunk(Chunk, 1);
+
+	OutHeader.Reset();
+	for(const LIDelimited::FCell& Cell : Chunk.Cells)
+	{
+		const ANSICHAR* CellData = Cell.bUnescaped ? Chunk.Unescaped.GetData() + Cell.Offset : Data + Chunk.Begin + Cell.Offset;
+		OutHeader.Add(FLIUtf8View(CellData, Cell.Len).ToString());
+	}
+	return Chunk.RowEnds.Num() > 0;
+}
+
+bool FLIDelimitedReader::ForEachRow(FRowVisitor Visitor) const
+{
+	using namespace LIDelimited;
+
+	TRACE_CPUPROFILER_EVENT_SCOPE(LIDelimitedReader_ForEachRow);
+
+	if(!Data)
+		return false;
+
+	// A chunk size past the end of the file just means one chunk.
+	const int64 BytesPerChunk = FMath::Min(ChunkSize, Size - Start);
+	const int32 NumChunks = (int32)((Size - Start + BytesPerChunk - 1) / BytesPerChunk);
+
+	// Each cut is moved to the start of the next row, which needs to know whether it falls inside a quoted cell.
+	// That depends on everything before it, so each stretch between cuts is followed both ways it could start
+	// in parallel, and the stretches are chained together afterwards. Cuts never come right after a quote,
+	// so a doubled quote is never split between two stretches.
+	TArray<int64> ChunkStarts;
+	ChunkStarts.Add(Start);
+	if(NumChunks > 1)
+	{
+		TArray<int64> Cuts;
+		Cuts.Add(Start);
+		for(int32 Index = 1; Index < NumChunks; ++Index)
+		{
+			int64 Cut = FMath::Max(Start + Index * BytesPerChunk, Cuts.Last());
+			while(Cut < Size && Data[Cut - 1] == '"')
+				++Cut;
+			Cuts.Add(Cut);
+		}
+
+		// Whether each stretch ends inside a quoted cell, when it starts outside of one and when it starts inside.
+		TArray<bool> EndsInside[2];
+		EndsInside[0].SetNumZeroed(NumChunks - 1);
+		EndsInside[1].SetNumZeroed(NumChunks - 1);
+		ParallelFor(NumChunks - 1, [this, &Cuts, &EndsInside](const int32 Index)
+		{
+			EndsInside[0][Index] = EndsInQuotes(Data, Start, Cuts[Index], Cuts[Index + 1], Delimiter, false);
+			EndsInside[1][Index] = EndsInQuotes(Data, Start, Cuts[Index], Cuts[Index + 1], Delimiter, true);
+		});
+
+		bool bInQuotes = false;
+		for(int32 Index = 1; Index < NumChunks; ++Index)
+		{
+			bInQuotes = EndsInside[bInQuotes ? 1 : 0][Index - 1];
+			const int64 RowStart = FindRowStart(Cuts[Index], bInQuotes);
+			ChunkStarts.Add(FMath::Max(RowStart, ChunkStarts.Last()));
+		}
+	}
+
+	const int32 NumWorkers = FMath::Max(ULIImporterSettings::GetNumWorkers(0, NumChunks), 1);
+	TArray<FChunk> Chunks;
+	Chunks.SetNum(NumWorkers);
+
+	FLISpreadsheetRow Row;
+	int32 RowNumber = 0;
+	int64 NextRowStart = Start;
+
+	for(int32 FirstChunk = 0; FirstChunk < NumChunks; FirstChunk += NumWorkers)
+	{
+		const int32 NumInWave = FMath::Min(NumWorkers, NumChunks - FirstChunk);
+		ParallelFor(NumInWave, [this, &Chunks, &ChunkStarts, FirstChunk, NumChunks](const int32 Index)
+		{
+			const int32 ChunkIndex = FirstChunk + Index;
+			FChunk& Chunk = Chunks[Index];
+			Chunk.Begin = ChunkStarts[ChunkIndex];
+			Chunk.End = ChunkIndex + 1 < NumChunks ? ChunkStarts[ChunkIndex + 1] : Size;
+			Chunk.Cut = Chunk.End;
+			Chunk.Cells.Reset();
+			Chunk.RowEnds.Reset();
+			Chunk.Unescaped.Reset();
+			ParseChunk(Chunk);
+		}, NumInWave == 1);
+
+		for(int32 Index = 0; Index < NumInWave; ++Index)
+		{
+			FChunk& Chunk = Chunks[Index];
+
+			// The cuts follow the same rules as the parser, so every chunk should start where the rows before it ended
+			// and end on a row of its own. If one doesn't, it's parsed again here, in order, from the real start of its first row.
+			if(Chunk.Begin != NextRowStart || Chunk.bCutOff)
+			{
+				Chunk.Begin = NextRowStart;
+				Chunk.Cut = Chunk.End;
+				Chunk.End = Size;
+				Chunk.Cells.Reset();
+				Chunk.RowEnds.Reset();
+				Chunk.Unescaped.Reset();
+				ParseChunk(Chunk);
+			}
+			NextRowStart = Chunk.ParsedEnd;
+
+			int32 CellIndex = 0;
+			for(const int32 RowEnd : Chunk.RowEnds)
+			{
+				Row.RowNumber = ++RowNumber;
+				Row.Cells.Reset();
+				for(; CellIndex < RowEnd; ++CellIndex)
+				{
+					const FCell& Cell = Chunk.Cells[CellIndex];
+					const ANSICHAR* CellData = Cell.bUnescaped ? Chunk.Unescaped.GetData() + Cell.Offset : Data + Chunk.Begin + Cell.Offset;
+					Row.Cells.Add(FLIUtf8View(CellData, Cell.Len));
+				}
+
+				if(!Visitor(Row))
+					return true;
+			}
+		}
+	}
+
+	return true;
+}
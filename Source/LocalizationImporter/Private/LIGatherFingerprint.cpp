@@ -0,0 +1,220 @@
+// Copyright (C) 2022 Dakarai Simmons - All Rights Reserved
+
+#include "LIGatherFingerprint.h"
+#include "LIImportManifest.h"
+#include "LocalizationImporter.h"
+#include "AssetRegistryModule.h"
+#include "Hash/CityHash.h"
+#include "HAL/FileManager.h"
+#include "LocalizationConfigurationScript.h"
+#include "LocalizationSettings.h"
+#include "LocalizationTargetTypes.h"
+#include "Misc/FileHelper.h"
+#include "Misc/PackageName.h"
+#include "Misc/Paths.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+
+namespace LIGatherFingerprint
+{
+	// Order dependent, which is fine as long as everything is folded in in a stable order.
+	struct FHasher
+	{
+		FHasher()
+			: Hash(0) {}
+
+		void Add(const void* Data, const int32 Len)
+		{
+			Hash = CityHash128to64(Uint128_64(Hash, CityHash64((const char*)Data, Len)));
+		}
+
+		void Add(const uint64 Value)
+		{
+			Add(&Value, sizeof(Value));
+		}
+
+		void Add(const FString& String)
+		{
+			Add(*String, String.Len() * sizeof(TCHAR));
+		}
+
+		void AddFileStat(const FString& Filename)
+		{
+			const FFileStatData Stat = IFileManager::Get().GetStatData(*Filename);
+			Add(Filename);
+			Add((uint64)Stat.bIsValid);
+			Add((uint64)Stat.FileSize);
+			Add((uint64)Stat.ModificationTime.GetTicks());
+		}
+
+		uint64 Hash;
+	};
+
+	// Collects files anywhere under Directory that match any of the wildcards, sorted so the hash doesn't depend on directory order.
+	static void FindFiles(const FString& Directory, const TArray<FString>& Wildcards, TArray<FString>& OutFiles)
+	{
+		const int32 FirstFile = OutFiles.Num();
+		for(const FString& Wildcard : Wildcards)
+			IFileManager::Get().FindFilesRecursive(OutFiles, *Directory, *Wildcard, true, false, false);
+
+		TArrayView<FString> NewFiles(OutFiles.GetData() + FirstFile, OutFiles.Num() - FirstFile);
+		NewFiles.Sort();
+	}
+
+	// The manifests the gather config lists as the target's dependencies, found the way LocalizationConfigurationScript finds them.
+	static TArray<FString> FindDependencyManifests(const ULocalizationTarget* Target)
+	{
+		TArray<const ULocalizationTarget*> Candidates;
+		const ULocalizationTargetSet* EngineTargetSet = ULocalizationSettings::GetEngineTargetSet();
+		if(EngineTargetSet && EngineTargetSet != Target->GetOuter())
+		{
+			for(const ULocalizationTarget* Candidate : EngineTargetSet->TargetObjects)
+				Candidates.Add(Candidate);
+		}
+
+		if(const ULocalizationTargetSet* TargetSet = Cast<ULocalizationTargetSet>(Target->GetOuter()))
+		{
+			for(const ULocalizationTarget* Candidate : TargetSet->TargetObjects)
+				Candidates.Add(Candidate);
+		}
+
+		TArray<FString> Manifests;
+		for(const FGuid& Dependency : Target->Settings.TargetDependencies)
+		{
+			const ULocalizationTarget* const* DependencyTarget = Candidates.FindByPredicate([&Dependency](const ULocalizationTarget* Candidate) { return Candidate && Candidate->Settings.Guid == Dependency; });
+			if(DependencyTarget)
+				Manifests.Add(FPaths::ConvertRelativePathToFull(LocalizationConfigurationScript::GetManifestPath(*DependencyTarget)));
+		}
+
+		for(const FFilePath& Path : Target->Settings.AdditionalManifestDependencies)
+			Manifests.Add(FPaths::ConvertRelativePathToFull(FPaths::IsRelative(Path.FilePath) ? FPaths::Combine(FPaths::ProjectDir(), Path.FilePath) : Path.FilePath));
+
+		return Manifests;
+	}
+}
+
+uint64 FLIGatherFingerprint::ComputeInputs(const ULocalizationTarget* Target, const FString& GatherConfigPath)
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(LIGatherFingerprint_ComputeInputs);
+
+	using namespace LIGatherFingerprint;
+
+	FHasher Hasher;
+	Hasher.Add(FLIImportManifest::HashFile(GatherConfigPath));
+
+	// The config only names these, but text already in one of them is left out of this target's manifest.
+	for(const FString& Manifest : FindDependencyManifests(Target))
+		Hasher.AddFileStat(Manifest);
+
+	const FLocalizationTargetSettings& Settings = Target->Settings;
+
+	if(Settings.GatherFromPackages.IsEnabled)
+	{
+		const IAssetRegistry& AssetRegistry = FModuleManager::LoadModuleChecked<FAssetRegistryModule>(TEXT("AssetRegistry")).Get();
+		if(AssetRegistry.IsLoadingAssets())
+			return 0;
+
+		TArray<FAssetData> Assets;
+		AssetRegistry.GetAllAssets(Assets, true);
+
+		TSet<FName> UniquePackageNames;
+		UniquePackageNames.Reserve(Assets.Num());
+		for(const FAssetData& Asset : Assets)
+			UniquePackageNames.Add(Asset.PackageName);
+
+		TArray<FName> PackageNames = UniquePackageNames.Array();
+		PackageNames.Sort(FNameLexicalLess());
+
+		for(const FName PackageName : PackageNames)
+		{
+			// The registry knows each package's save guid, which changes on every save. Only fall back to the disk when it doesn't.
+			const FAssetPackageData* PackageData = AssetRegistry.GetAssetPackageData(PackageName);
+			if(PackageData)
+			{
+				Hasher.Add(PackageName.ToString());
+				Hasher.Add(&PackageData->PackageGuid, sizeof(FGuid));
+				Hasher.Add((uint64)PackageData->DiskSize);
+			}
+			else
+			{
+				FString Filename;
+				if(FPackageName::DoesPackageExist(PackageName.ToString(), nullptr, &Filename))
+					Hasher.AddFileStat(Filename);
+			}
+		}
+	}
+
+	if(Settings.GatherFromTextFiles.IsEnabled)
+	{
+		TArray<FString> Wildcards;
+		for(const FGatherTextFileExtension& Extension : Settings.GatherFromTextFiles.FileExtensions)
+			Wildcards.Add(Extension.Pattern);
+
+		TArray<FString> Files;
+		for(const FGatherTextSearchDirectory& SearchDirectory : Settings.GatherFromTextFiles.SearchDirectories)
+		{
+			const FString Directory = FPaths::IsRelative(SearchDirectory.Path) ? FPaths::Combine(FPaths::ProjectDir(), SearchDirectory.Path) : SearchDirectory.Path;
+			FindFiles(Directory, Wildcards, Files);
+		}
+
+		for(const FString& File : Files)
+			Hasher.AddFileStat(File);
+	}
+
+	// Metadata comes from the compiled classes, so any rebuild of the project's modules may change it.
+	if(Settings.GatherFromMetaData.IsEnabled)
+	{
+		TArray<FString> Wildcards;
+		Wildcards.Add(TEXT("*.dll"));
+		Wildcards.Add(TEXT("*.so"));
+		Wildcards.Add(TEXT("*.dylib"));
+		Wildcards.Add(TEXT("*.modules"));
+
+		TArray<FString> Binaries;
+		FindFiles(FPaths::ProjectDir() / TEXT("Binaries"), Wildcards, Binaries);
+
+		for(const FString& Binary : Binaries)
+			Hasher.AddFileStat(Binary);
+	}
+
+	// Never hand out the value that means "unknown".
+	return Hasher.Hash != 0 ? Hasher.Hash : 1;
+}
+
+uint64 FLIGatherFingerprint::ComputeOutputs(const ULocalizationTarget* Target)
+{
+	LIGatherFingerprint::FHasher Hasher;
+	Hasher.AddFileStat(FPaths::ConvertRelativePathToFull(LocalizationConfigurationScript::GetManifestPath(Target)));
+	return Hasher.Hash;
+}
+
+bool FLIGatherFingerprint::IsUpToDate(const ULocalizationTarget* Target, const uint64 Inputs)
+{
+	if(Inputs == 0)
+		return false;
+
+	FString Contents;
+	if(!FFileHelper::LoadFileToString(Contents, *GetPath(Target)))
+		return false;
+
+	// "<inputs> <outputs>" in hex.
+	FString InputsString;
+	FString OutputsString;
+	if(!Contents.TrimStartAndEnd().Split(TEXT(" "), &InputsString, &OutputsString))
+		return false;
+
+	return FCString::Strtoui64(*InputsString, nullptr, 16) == Inputs && FCString::Strtoui64(*OutputsString, nullptr, 16) == ComputeOutputs(Target);
+}
+
+bool FLIGatherFingerprint::Record(const ULocalizationTarget* Target, const uint64 Inputs)
+{
+	if(Inputs == 0)
+		return false;
+
+	const FString Contents = FString::Printf(TEXT("%016llx %016llx"), Inputs, ComputeOutputs(Target));
+	return FFileHelper::SaveStringToFile(Contents, *GetPath(Target));
+}
+
+FString FLIGatherFingerprint::GetPath(const ULocalizationTarget* Target)
+{
+	return FPaths::ConvertRelativePathToFull(FPaths::ProjectSavedDir() / TEXT("LocalizationImporter") / (Target->Settings.Name + TEXT(".gather")));
+}
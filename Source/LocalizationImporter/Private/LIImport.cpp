@@ -0,0 +1,289 @@
+// Copyright (C) 2022 Dakarai Simmons - All Rights Reserved
+
+#include "LIImport.h"
+#include "LocalizationImporter.h"
+#include "LIGatherFingerprint.h"
+#include "LIImporterSettings.h"
+#include "LIImportManifest.h"
+#include "LIQuickCompile.h"
+#include "LIRunSummary.h"
+#include "LITranslationTable.h"
+#include "LocalizationConfigurationScript.h"
+#include "LocalizationSettings.h"
+#include "LocalizationTargetTypes.h"
+#include "Internationalization/Culture.h"
+#include "Internationalization/TextLocalizationManager.h"
+#include "Misc/Paths.h"
+
+#define LOCTEXT_NAMESPACE "LIImport"
+
+ULocalizationTarget* FLIImport::FindGameTarget(const FString& Name)
+{
+	// From LocalizationCommandletTasks.cpp::GatherTextForTarget() Line 37
+	ULocalizationTargetSet* GameTargetSet = ULocalizationSettings::GetGameTargetSet();
+	if(!GameTargetSet)
+		return nullptr;
+
+	for(ULocalizationTarget* LocalizationTarget : GameTargetSet->TargetObjects)
+	{
+		if(LocalizationTarget && (Name.IsEmpty() || LocalizationTarget->Settings.Name == Name))
+			return LocalizationTarget;
+	}
+	return nullptr;
+}
+
+TArray<ULocalizationTarget*> FLIImport::GetGameTargets()
+{
+	TArray<ULocalizationTarget*> Targets;
+	ULocalizationTargetSet* GameTargetSet = ULocalizationSettings::GetGameTargetSet();
+	if(GameTargetSet)
+	{
+		for(ULocalizationTarget* LocalizationTarget : GameTargetSet->TargetObjects)
+		{
+			if(LocalizationTarget)
+				Targets.Add(LocalizationTarget);
+		}
+	}
+	return Targets;
+}
+
+TArray<int32> FLIImport::FindDependencies(const TArray<ULocalizationTarget*>& Targets, const int32 TargetIndex)
+{
+	// Dependencies outside the list (engine targets, or targets that weren't picked) don't hold anything up.
+	TArray<int32> Dependencies;
+	for(const FGuid& Dependency : Targets[TargetIndex]->Settings.TargetDependencies)
+	{
+		const int32 DependencyIndex = Targets.IndexOfByPredicate([&Dependency](const ULocalizationTarget* Other) { return Other->Settings.Guid == Dependency; });
+		if(DependencyIndex != INDEX_NONE && DependencyIndex != TargetIndex)
+			Dependencies.AddUnique(DependencyIndex);
+	}
+	return Dependencies;
+}
+
+void FLIImport::InvalidateDependentGathers(const TArray<FLIImport*>& Imports, const TArray<ULocalizationTarget*>& Targets)
+{
+	check(Imports.Num() == Targets.Num());
+
+	// Repeated until nothing changes, so it carries down chains of dependencies whatever order the list is in.
+	bool bChanged = true;
+	while(bChanged)
+	{
+		bChanged = false;
+		for(int32 TargetIndex = 0; TargetIndex < Imports.Num(); ++TargetIndex)
+		{
+			FLIImport& Import = *Imports[TargetIndex];
+			if(!Import.IsGatherUpToDate())
+				continue;
+
+			for(const int32 Dependency : FindDependencies(Targets, TargetIndex))
+			{
+				if(Imports[Dependency]->WillGather())
+				{
+					UE_LOG(LocalizationImporterPlugin, Display, TEXT("%s has to be gathered again, %s which it depends on is gathered first."), *Targets[TargetIndex]->Settings.Name, *Targets[Dependency]->Settings.Name);
+					Import.Tasks[Import.GatherTaskIndex].bUpToDate = false;
+					bChanged = true;
+					break;
+				}
+			}
+		}
+	}
+}
+
+bool FLIImport::Prepare(ULocalizationTarget* InTarget, const FLIImportRequest& Request, FLIRunSummary& RunSummary, FText& OutError)
+{
+	check(InTarget);
+	Target = InTarget;
+
+	// Settings for the translation step, which runs after the export
+	ApplySettings = FLIApplySettings();
+	ApplySettings.Target = Target->Settings.Name;
+	ApplySettings.Spreadsheets = Request.Spreadsheets;
+	ApplySettings.Pages = Request.Pages;
+	ApplySettings.bCaseSensitive = Request.bCaseSensitive;
+	ApplySettings.bForceRefresh = Request.bForceRefresh;
+	ApplySettings.bMatchByKey = Request.bMatchByKey;
+	ApplySettings.MaxParallelCultures = GetDefault<ULIImporterSettings>()->MaxParallelCultures;
+
+	TArray<FString> TargetCultures;
+	for(const FCultureStatistics& CultureStats : Target->Settings.SupportedCulturesStatistics)
+		TargetCultures.Add(CultureStats.CultureName);
+
+	for(const FString& Language : Request.Languages)
+	{
+		const FString CultureName = FLIApplySettings::FindCultureForLanguage(Language, TargetCultures);
+		if(CultureName.IsEmpty())
+		{
+			UE_LOG(LocalizationImporterPlugin, Warning, TEXT("%s doesn't match any culture of %s, skipping it."), *Language, *Target->Settings.Name);
+			continue;
+		}
+
+		FLIApplySettings::FCulture& Culture = ApplySettings.Cultures.AddDefaulted_GetRef();
+		Culture.Language = Language;
+		Culture.Culture = CultureName;
+		Culture.POPath = FPaths::ConvertRelativePathToFull(LocalizationConfigurationScript::GetDefaultPOPath(Target, CultureName));
+	}
+
+	// The spreadsheets are read here, once, and the update step maps the saved table instead of reading them again.
+	// Spreadsheets that haven't changed since the last import keep the table that was saved then.
+	// It holds every requested language, not just this target's, so all the targets of one import share it.
+	{
+		TRACE_CPUPROFILER_EVENT_SCOPE(LIImport_BuildTable);
+		FLIRunSummary::FScopedStage Stage(RunSummary, TEXT("Build Translation Table"));
+
+		TArray<FString> Languages;
+		for(const FString& Language : Request.Languages)
+			Languages.AddUnique(Language);
+
+		const FString TablePath = FLITranslationTable::GetDefaultPath();
+		const uint64 SourceHash = FLITranslationTable::HashSource(FLIImportManifest::HashFiles(ApplySettings.Spreadsheets), ApplySettings.Pages, ApplySettings.bCaseSensitive);
+
+		FLITranslationTable Table;
+		if(Table.Load(TablePath, SourceHash) && Table.HasLanguages(Languages))
+		{
+			ApplySettings.TablePath = TablePath;
+		}
+		else if(ApplySettings.Cultures.Num() > 0)
+		{
+			if(!Table.Build(ApplySettings.Spreadsheets, ApplySettings.Pages, Languages, ApplySettings.bCaseSensitive))
+			{
+				OutError = FText::Format(LOCTEXT("TableErrorMsg", "Could not read the translations from {0}"), FText::FromString(FString::Join(ApplySettings.Spreadsheets, TEXT(", "))));
+				return false;
+			}
+
+			if(Table.Save(TablePath, SourceHash))
+				ApplySettings.TablePath = TablePath;
+			else
+				UE_LOG(LocalizationImporterPlugin, Warning, TEXT("Could not write '%s', the spreadsheets will be read again when they're applied."), *TablePath);
+		}
+	}
+
+	const bool bShouldUseProjectFile = true; // True because we're targeting game content separate from engine
+	const FString ApplySettingsPath = FLIApplySettings::GetDefaultPath(Target->Settings.Name);
+	const FString GatherScriptPath = LocalizationConfigurationScript::GetGatherTextConfigPath(Target);
+	const FString ExportPath = FPaths::ConvertRelativePathToFull(LocalizationConfigurationScript::GetDataDirectory(Target));
+	const FString ExportScriptPath = LocalizationConfigurationScript::GetExportTextConfigPath(Target, TOptional<FString>());
+	const FString ImportScriptPath = LocalizationConfigurationScript::GetImportTextConfigPath(Target, TOptional<FString>());
+	const FString ReportScriptPath = LocalizationConfigurationScript::GetWordCountReportConfigPath(Target);
+	const FString CompileScriptPath = LocalizationConfigurationScript::GetCompileTextConfigPath(Target);
+
+	{
+		TRACE_CPUPROFILER_EVENT_SCOPE(LIImport_GenerateConfigs);
+		FLIRunSummary::FScopedStage Stage(RunSummary, TEXT("Generate Configs"));
+
+		if(!ApplySettings.SaveToFile(ApplySettingsPath))
+		{
+			OutError = FText::Format(LOCTEXT("SettingsErrorMsg", "Could not write {0}"), FText::FromString(ApplySettingsPath));
+			return false;
+		}
+
+		if(Request.bQuickCompile)
+		{
+			Tasks.Reset();
+			GatherTaskIndex = INDEX_NONE;
+
+			// Runs inside the editor, the LocalizationImport commandlet runs it through the LIQuickCompile commandlet.
+			const FLIApplySettings TaskSettings = ApplySettings;
+			const FLILocResTarget LocResTarget = FLILocResTarget::FromTarget(Target);
+			CompileTaskIndex = Tasks.Add(FLITask(LOCTEXT("QuickCompileTaskName", "Compile Translations (Quick)"), TEXT("LIQuickCompile"), ApplySettingsPath, [TaskSettings, LocResTarget]()
+			{
+				return FLIQuickCompile::Run(TaskSettings, LocResTarget);
+			}));
+			return true;
+		}
+
+		LocalizationConfigurationScript::GenerateGatherTextConfigFile(Target).WriteWithSCC(GatherScriptPath);
+		LocalizationConfigurationScript::GenerateExportTextConfigFile(Target, TOptional<FString>(), ExportPath).WriteWithSCC(ExportScriptPath);
+		LocalizationConfigurationScript::GenerateImportTextConfigFile(Target, TOptional<FString>(), ExportPath).WriteWithSCC(ImportScriptPath);
+		LocalizationConfigurationScript::GenerateWordCountReportConfigFile(Target).WriteWithSCC(ReportScriptPath);
+		LocalizationConfigurationScript::GenerateCompileTextConfigFile(Target).WriteWithSCC(CompileScriptPath);
+	}
+
+	// Gathering is skipped when none of its inputs changed since the last time it ran
+	{
+		TRACE_CPUPROFILER_EVENT_SCOPE(LIImport_CheckGatherInputs);
+		FLIRunSummary::FScopedStage Stage(RunSummary, TEXT("Check Gather Inputs"));
+		GatherInputs = FLIGatherFingerprint::ComputeInputs(Target, GatherScriptPath);
+	}
+
+	Tasks.Reset();
+	GatherTaskIndex = Tasks.Add(FLITask(LOCTEXT("GatherTaskName", "Gather Text"), TEXT("GatherText"), GatherScriptPath, bShouldUseProjectFile));
+	Tasks[GatherTaskIndex].bUpToDate = FLIGatherFingerprint::IsUpToDate(Target, GatherInputs);
+
+	const int32 ExportTaskIndex = Tasks.Add(FLITask(LOCTEXT("ExportTaskName", "Export Translations"), TEXT("GatherText"), ExportScriptPath, bShouldUseProjectFile));
+	Tasks[ExportTaskIndex].Dependencies.Add(GatherTaskIndex);
+
+	// Fill the exported .po files in from the spreadsheet. This only touches files, so it runs inside the editor.
+	const FLIApplySettings TaskSettings = ApplySettings;
+	const int32 ApplyTaskIndex = Tasks.Add(FLITask(LOCTEXT("ApplyTaskName", "Update Translations"), TEXT("LIApplyTranslations"), ApplySettingsPath, [TaskSettings]()
+	{
+		return FLIApplyTranslations::Run(TaskSettings);
+	}));
+	Tasks[ApplyTaskIndex].Dependencies.Add(ExportTaskIndex);
+
+	const int32 ImportTaskIndex = Tasks.Add(FLITask(LOCTEXT("ImportTaskName", "Import Translations"), TEXT("GatherText"), ImportScriptPath, bShouldUseProjectFile));
+	Tasks[ImportTaskIndex].Dependencies.Add(ApplyTaskIndex);
+
+	// Without a pending manifest the update step found nothing new, so there's nothing to import or compile either
+	Tasks[ImportTaskIndex].RequiredFile = FLIImportManifest::GetPendingPath(Target->Settings.Name);
+
+	CompileTaskIndex = Tasks.Add(FLITask(LOCTEXT("CompileTaskName", "Compile Translations"), TEXT("GatherText"), CompileScriptPath, bShouldUseProjectFile));
+	Tasks[CompileTaskIndex].Dependencies.Add(ImportTaskIndex);
+	Tasks[CompileTaskIndex].RequiredFile = FLIImportManifest::GetPendingPath(Target->Settings.Name);
+
+	// The word counts aren't needed to use the translations, so they're made at low priority once the compile is done
+	if(GetDefault<ULIImporterSettings>()->bGenerateReports)
+	{
+		const int32 ReportTaskIndex = Tasks.Add(FLITask(LOCTEXT("ReportTaskName", "Generate Reports"), TEXT("GatherText"), ReportScriptPath, bShouldUseProjectFile));
+		Tasks[ReportTaskIndex].Dependencies.Add(CompileTaskIndex);
+		Tasks[ReportTaskIndex].bBackground = true;
+		Tasks[ReportTaskIndex].OutputPath = LocalizationConfigurationScript::GetWordCountCSVPath(Target);
+	}
+
+	return true;
+}
+
+void FLIImport::Finish(const bool bSucceeded, const bool bGatherRan) const
+{
+	// A gather that went through is good for next time even if a later step failed.
+	if(bGatherRan)
+		FLIGatherFingerprint::Record(Target, GatherInputs);
+
+	// Only now is it safe for the next import to build on this one.
+	if(bSucceeded)
+		FLIImportManifest::CommitPending(Target->Settings.Name);
+}
+
+void FLIImport::ReloadTranslations(const TArray<FString>& Cultures)
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(LIImport_ReloadTranslations);
+
+	if(Cultures.Num() == 0)
+		return;
+
+	// The editor's own language, and the game's while its localization is being previewed (which PIE uses too).
+	FTextLocalizationManager& TextLocalizationManager = FTextLocalizationManager::Get();
+	TArray<FString> ShownLanguages;
+	ShownLanguages.Add(FInternationalization::Get().GetCurrentLanguage()->GetName());
+	if(TextLocalizationManager.IsGameLocalizationPreviewEnabled())
+		ShownLanguages.Add(TextLocalizationManager.GetConfiguredGameLocalizationPreviewLanguage());
+
+	// A language shows its parent cultures' translations for text it has none for, es-ES falls back on es.
+	bool bAffected = false;
+	for(const FString& Language : ShownLanguages)
+	{
+		for(const FString& CultureName : FInternationalization::Get().GetPrioritizedCultureNames(Language))
+			bAffected |= Cultures.Contains(CultureName);
+	}
+
+	if(!bAffected)
+	{
+		UE_LOG(LocalizationImporterPlugin, Display, TEXT("None of the compiled cultures (%s) are being shown, nothing to reload."), *FString::Join(Cultures, TEXT(", ")));
+		return;
+	}
+
+	const double StartTime = FPlatformTime::Seconds();
+	TextLocalizationManager.RefreshResources();
+	UE_LOG(LocalizationImporterPlugin, Display, TEXT("Reloaded the translations of %s in %.2f seconds."), *FString::Join(ShownLanguages, TEXT(", ")), FPlatformTime::Seconds() - StartTime);
+}
+
+#undef LOCTEXT_NAMESPACE
@@ -0,0 +1,131 @@
+// Copyright (C) 2022 Dakarai Simmons - All Rights Reserved
+
+#include "LIImportManifest.h"
+#include "LocalizationImporter.h"
+#include "Async/MappedFileHandle.h"
+#include "Hash/CityHash.h"
+#include "HAL/FileManager.h"
+#include "HAL/PlatformFilemanager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+
+namespace LIImportManifest
+{
+	static const uint32 Magic = 0x464D494C; // "LIMF"
+	static const uint32 Version = 1;
+}
+
+FArchive& operator<<(FArchive& Ar, FLIImportManifest::FCultureRecord& Record)
+{
+	Ar << Record.SettingsHash;
+	Ar << Record.SpreadsheetHash;
+	Ar << Record.POHash;
+	Ar << Record.Entries;
+	return Ar;
+}
+
+bool FLIImportManifest::Load(const FString& Path)
+{
+	Cultures.Reset();
+
+	TArray<uint8> Data;
+	if(!FFileHelper::LoadFileToArray(Data, *Path, FILEREAD_Silent))
+		return false;
+
+	FMemoryReader Reader(Data);
+	uint32 Magic = 0;
+	uint32 Version = 0;
+	Reader << Magic;
+	Reader << Version;
+
+	// An old or broken manifest just means the next import does everything.
+	if(Magic != LIImportManifest::Magic || Version != LIImportManifest::Version)
+		return false;
+
+	Reader << Cultures;
+	if(Reader.IsError())
+	{
+		Cultures.Reset();
+		return false;
+	}
+
+	return true;
+}
+
+bool FLIImportManifest::Save(const FString& Path) const
+{
+	TArray<uint8> Data;
+	FMemoryWriter Writer(Data);
+
+	uint32 Magic = LIImportManifest::Magic;
+	uint32 Version = LIImportManifest::Version;
+	Writer << Magic;
+	Writer << Version;
+	Writer << const_cast<TMap<FString, FCultureRecord>&>(Cultures);
+
+	return FFileHelper::SaveArrayToFile(Data, *Path);
+}
+
+FString FLIImportManifest::GetPath(const FString& TargetName)
+{
+	return FPaths::ConvertRelativePathToFull(FPaths::ProjectSavedDir() / TEXT("LocalizationImporter") / (TargetName + TEXT(".ImportManifest.bin")));
+}
+
+FString FLIImportManifest::GetPendingPath(const FString& TargetName)
+{
+	return FPaths::ConvertRelativePathToFull(FPaths::ProjectSavedDir() / TEXT("LocalizationImporter") / (TargetName + TEXT(".ImportManifest.pending.bin")));
+}
+
+bool FLIImportManifest::CommitPending(const FString& TargetName)
+{
+	const FString PendingPath = GetPendingPath(TargetName);
+	if(!IFileManager::Get().FileExists(*PendingPath))
+		return false;
+
+	return IFileManager::Get().Move(*GetPath(TargetName), *PendingPath, true);
+}
+
+void FLIImportManifest::DiscardPending(const FString& TargetName)
+{
+	IFileManager::Get().Delete(*GetPendingPath(TargetName), false, false, true);
+}
+
+uint64 FLIImportManifest::HashFile(const FString& Path)
+{
+	IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+	TUniquePtr<IMappedFileHandle> MappedHandle(PlatformFile.OpenMapped(*Path));
+	if(MappedHandle && MappedHandle->GetFileSize() > 0)
+	{
+		TUniquePtr<IMappedFileRegion> MappedRegion(MappedHandle->MapRegion());
+		if(MappedRegion)
+			return CityHash64((const char*)MappedRegion->GetMappedPtr(), (uint32)MappedRegion->GetMappedSize());
+	}
+
+	TArray<uint8> Data;
+	if(!FFileHelper::LoadFileToArray(Data, *Path, FILEREAD_Silent))
+		return 0;
+
+	return CityHash64((const char*)Data.GetData(), Data.Num());
+}
+
+uint64 FLIImportManifest::HashFiles(const TArray<FString>& Paths)
+{
+	// A single file hashes as it always has, so manifests from single spreadsheet imports stay valid.
+	if(Paths.Num() == 1)
+		return HashFile(Paths[0]);
+
+	uint64 Hash = 0;
+	for(const FString& Path : Paths)
+	{
+		const uint64 FileHash = HashFile(Path);
+		Hash = CityHash64WithSeed((const char*)&FileHash, sizeof(FileHash), Hash);
+	}
+	return Hash;
+}
+
+uint64 FLIImportManifest::HashText(const FLIUtf8View& Text)
+{
+	return CityHash64(Text.Data, Text.Len);
+}
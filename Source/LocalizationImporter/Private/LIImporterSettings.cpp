@@ -0,0 +1,25 @@
+// Copyright (C) 2022 Dakarai Simmons - All Rights Reserved
+
+#include "LIImporterSettings.h"
+#include "HAL/PlatformMisc.h"
+
+ULIImporterSettings::ULIImporterSettings(const FObjectInitializer& ObjectInitializer)
+	: Super(ObjectInitializer),
+	bRunInSingleProcess(true),
+	MaxParallelCultures(0),
+	MaxParallelTargets(2),
+	MaxParallelTasks(2),
+	bGenerateReports(true)
+{}
+
+FName ULIImporterSettings::GetCategoryName() const
+{
+	return TEXT("Plugins");
+}
+
+int32 ULIImporterSettings::GetNumWorkers(const int32 Cap, const int32 NumItems)
+{
+	const int32 NumCores = FMath::Max(FPlatformMisc::NumberOfCoresIncludingHyperthreads(), 1);
+	const int32 Limit = Cap > 0 ? Cap : NumCores;
+	return FMath::Clamp(NumItems, 0, Limit);
+}
@@ -0,0 +1,425 @@
+// Copyright (C) 2022 Dakarai Simmons - All Rights Reserved
+
+#include "LILocalizationImportCommandlet.h"
+#include "LIImport.h"
+#include "LIImporterSettings.h"
+#include "LIPipeline.h"
+#include "LIRunSummary.h"
+#include "LISpreadsheet.h"
+#include "LocalizationImporter.h"
+#include "AssetRegistryModule.h"
+#include "LocalizationTargetTypes.h"
+#include "HAL/PlatformProcess.h"
+#include "Misc/Paths.h"
+
+namespace LILocalizationImport
+{
+	/*
+	 * Picks the names asked for out of the ones the spreadsheet has, spelled the way the spreadsheet spells them.
+	 * Nothing asked for means all of them.
+	 */
+	static TArray<FString> SelectNames(const FString& Requested, const TArray<FString>& Available, const TCHAR* What)
+	{
+		if(Requested.IsEmpty())
+			return Available;
+
+		TArray<FString> RequestedNames;
+		Requested.ParseIntoArray(RequestedNames, TEXT(","), true);
+
+		TArray<FString> Names;
+		for(FString& RequestedName : RequestedNames)
+		{
+			RequestedName.TrimStartAndEndInline();
+
+			const FString* Name = Available.FindByPredicate([&RequestedName](const FString& Other) { return Other.Equals(RequestedName, ESearchCase::IgnoreCase); });
+			if(Name)
+			{
+				Names.AddUnique(*Name);
+			}
+			else
+			{
+				UE_LOG(LocalizationImporterPlugin, Warning, TEXT("The spreadsheet has no %s named '%s', skipping it."), What, *RequestedName);
+			}
+		}
+		return Names;
+	}
+
+	// The game targets asked for by name, or all of them.
+	static bool SelectTargets(const FString& Requested, TArray<ULocalizationTarget*>& OutTargets)
+	{
+		if(Requested.IsEmpty() || Requested.Equals(TEXT("all"), ESearchCase::IgnoreCase))
+		{
+			OutTargets = FLIImport::GetGameTargets();
+			if(OutTargets.Num() == 0)
+			{
+				UE_LOG(LocalizationImporterPlugin, Error, TEXT("The project has no game localization targets."));
+				return false;
+			}
+			return true;
+		}
+
+		TArray<FString> RequestedNames;
+		Requested.ParseIntoArray(RequestedNames, TEXT(","), true);
+		for(FString& RequestedName : RequestedNames)
+		{
+			RequestedName.TrimStartAndEndInline();
+
+			ULocalizationTarget* Target = FLIImport::FindGameTarget(RequestedName);
+			if(!Target)
+			{
+				UE_LOG(LocalizationImporterPlugin, Error, TEXT("Could not find the game localization target '%s'."), *RequestedName);
+				return false;
+			}
+			OutTargets.AddUnique(Target);
+		}
+		return OutTargets.Num() > 0;
+	}
+
+	// Every task that isn't up to date becomes a step, the way the executor runs them in a single process.
+	static FLIPipeline MakePipeline(const FLIImport& Import, int32& OutGatherStepIndex)
+	{
+		FLIPipeline Pipeline;
+		OutGatherStepIndex = INDEX_NONE;
+
+		const TArray<FLITask>& Tasks = Import.GetTasks();
+		for(int32 TaskIndex = 0; TaskIndex < Tasks.Num(); ++TaskIndex)
+		{
+			const FLITask& Task = Tasks[TaskIndex];
+			if(Task.bUpToDate)
+			{
+				UE_LOG(LocalizationImporterPlugin, Display, TEXT("%s of %s is up to date since the last run, skipping it."), *Task.Name.ToString(), *Import.GetTarget()->Settings.Name);
+				continue;
+			}
+
+			if(TaskIndex == Import.GetGatherTaskIndex())
+				OutGatherStepIndex = Pipeline.Steps.Num();
+
+			FLIPipeline::FStep& Step = Pipeline.Steps.AddDefaulted_GetRef();
+			Step.Name = Task.Name.ToString();
+			Step.CommandletName = Task.CommandletName;
+			Step.Arguments = FLICommandletProcess::BuildCommandletArguments(Task.ScriptPath, Task.ShouldUseProjectFile);
+			Step.RequiredFile = Task.RequiredFile;
+		}
+		return Pipeline;
+	}
+
+	// One target's import, run as a pipeline in a process of its own when there are several targets.
+	struct FTargetRun
+	{
+		FTargetRun()
+			: GatherStepIndex(INDEX_NONE),
+			bStarted(false),
+			bFinished(false),
+			bSucceeded(false),
+			bGatherRan(false),
+			StartTime(0.0) {}
+
+		FLIImport Import;
+		FLIPipeline Pipeline;
+		int32 GatherStepIndex;
+		TArray<int32> Dependencies;
+
+		TSharedPtr<FLICommandletProcess> Process;
+
+		// Output up to the end of the last whole line is passed on, the rest waits here.
+		FString PendingOutput;
+
+		bool bStarted;
+		bool bFinished;
+		bool bSucceeded;
+		bool bGatherRan;
+		double StartTime;
+	};
+
+	// Passes the process's output on a line at a time, tagged with the target, and notes when the gather went through.
+	static void ForwardOutput(FTargetRun& Run, const FString& Output, const bool bFlush)
+	{
+		Run.PendingOutput += Output;
+		if(bFlush && !Run.PendingOutput.IsEmpty())
+			Run.PendingOutput += TEXT("\n");
+
+		int32 LineEnd;
+		while(Run.PendingOutput.FindChar(TEXT('\n'), LineEnd))
+		{
+			FString Line = Run.PendingOutput.Left(LineEnd);
+			Run.PendingOutput.RemoveAt(0, LineEnd + 1, false);
+			Line.TrimEndInline();
+
+			int32 StepIndex;
+			int32 ReturnCode;
+			FLIProcessUsage Usage;
+			if(FLIPipeline::ParseStepEnd(Line, StepIndex, ReturnCode, Usage) && StepIndex == Run.GatherStepIndex && ReturnCode == 0)
+				Run.bGatherRan = true;
+
+			UE_LOG(LocalizationImporterPlugin, Display, TEXT("[%s] %s"), *Run.Import.GetTarget()->Settings.Name, *Line);
+		}
+	}
+
+	/*
+	 * Runs each target's pipeline in a commandlet process of its own, as many at a time as the settings allow.
+	 * A target starts once the targets it depends on went through, and doesn't start at all if one of them failed.
+	 */
+	static void RunTargets(TArray<FTargetRun>& Runs, FLIRunSummary& RunSummary)
+	{
+		const int32 MaxParallelTargets = ULIImporterSettings::GetNumWorkers(GetDefault<ULIImporterSettings>()->MaxParallelTargets, Runs.Num());
+
+		for(;;)
+		{
+			int32 NumRunning = 0;
+			for(const FTargetRun& Run : Runs)
+			{
+				if(Run.Process.IsValid())
+					++NumRunning;
+			}
+
+			for(FTargetRun& Run : Runs)
+			{
+				if(Run.bStarted)
+					continue;
+
+				const FString& TargetName = Run.Import.GetTarget()->Settings.Name;
+
+				bool bReady = true;
+				const FTargetRun* FailedDependency = nullptr;
+				for(const int32 Dependency : Run.Dependencies)
+				{
+					bReady &= Runs[Dependency].bFinished && Runs[Dependency].bSucceeded;
+					if(Runs[Dependency].bFinished && !Runs[Dependency].bSucceeded)
+						FailedDependency = &Runs[Dependency];
+				}
+
+				if(FailedDependency)
+				{
+					UE_LOG(LocalizationImporterPlugin, Error, TEXT("Not importing %s, %s which it depends on failed."), *TargetName, *FailedDependency->Import.GetTarget()->Settings.Name);
+					Run.bStarted = true;
+					Run.bFinished = true;
+					continue;
+				}
+
+				if(!bReady || NumRunning >= MaxParallelTargets)
+					continue;
+
+				Run.bStarted = true;
+				Run.StartTime = FPlatformTime::Seconds();
+				if(Run.Pipeline.Steps.Num() == 0)
+				{
+					Run.bFinished = true;
+					Run.bSucceeded = true;
+					continue;
+				}
+
+				const FString PipelinePath = FLIPipeline::GetDefaultPath(TargetName);
+				if(Run.Pipeline.SaveToFile(PipelinePath))
+					Run.Process = FLICommandletProcess::Execute(TEXT("LIPipeline"), PipelinePath);
+
+				if(!Run.Process.IsValid())
+				{
+					UE_LOG(LocalizationImporterPlugin, Error, TEXT("Could not start the import of %s."), *TargetName);
+					Run.bFinished = true;
+					continue;
+				}
+
+				UE_LOG(LocalizationImporterPlugin, Display, TEXT("Started importing %s."), *TargetName);
+				++NumRunning;
+			}
+
+			bool bAllFinished = true;
+			for(FTargetRun& Run : Runs)
+			{
+				if(Run.Process.IsValid())
+				{
+					ForwardOutput(Run, FPlatformProcess::ReadPipe(Run.Process->GetReadPipe()), false);
+
+					int32 ReturnCode;
+					if(FPlatformProcess::GetProcReturnCode(Run.Process->GetHandle(), &ReturnCode))
+					{
+						// Whatever the process wrote before exiting is still in the pipe.
+						ForwardOutput(Run, FPlatformProcess::ReadPipe(Run.Process->GetReadPipe()), true);
+						Run.Process.Reset();
+						Run.bFinished = true;
+						Run.bSucceeded = ReturnCode == 0;
+
+						FLIRunSummary::FStage Stage;
+						Stage.Name = FString::Printf(TEXT("LIPipeline (%s)"), *Run.Import.GetTarget()->Settings.Name);
+						Stage.Kind = FLIRunSummary::EStageKind::Process;
+						Stage.Result = Run.bSucceeded ? TEXT("Succeeded") : TEXT("Failed");
+						Stage.WallSeconds = FPlatformTime::Seconds() - Run.StartTime;
+						RunSummary.AddStage(Stage);
+
+						if(Run.bSucceeded)
+						{
+							UE_LOG(LocalizationImporterPlugin, Display, TEXT("Imported %s in %.2f seconds."), *Run.Import.GetTarget()->Settings.Name, Stage.WallSeconds);
+						}
+						else
+						{
+							UE_LOG(LocalizationImporterPlugin, Error, TEXT("Importing %s failed with return code %d."), *Run.Import.GetTarget()->Settings.Name, ReturnCode);
+						}
+					}
+				}
+
+				bAllFinished &= Run.bFinished;
+			}
+
+			if(bAllFinished)
+				break;
+
+			FPlatformProcess::Sleep(0.05f);
+		}
+	}
+}
+
+ULocalizationImportCommandlet::ULocalizationImportCommandlet()
+{
+	IsClient = false;
+	IsEditor = true;
+	IsServer = false;
+	LogToConsole = true;
+}
+
+int32 ULocalizationImportCommandlet::Main(const FString& Params)
+{
+	using namespace LILocalizationImport;
+
+	TArray<FString> Tokens;
+	TArray<FString> Switches;
+	TMap<FString, FString> ParamVals;
+	UCommandlet::ParseCommandLine(*Params, Tokens, Switches, ParamVals);
+
+	// Several spreadsheets are separated by '+', in order of precedence.
+	FLIImportRequest Request;
+	ParamVals.FindRef(TEXT("Spreadsheet")).ParseIntoArray(Request.Spreadsheets, TEXT("+"), true);
+	if(Request.Spreadsheets.Num() == 0)
+	{
+		UE_LOG(LocalizationImporterPlugin, Error, TEXT("No spreadsheet given. Use -Spreadsheet=\"<path>\" or -Spreadsheet=\"<path>+<path>...\"."));
+		return -1;
+	}
+
+	for(FString& Spreadsheet : Request.Spreadsheets)
+	{
+		Spreadsheet.TrimStartAndEndInline();
+		if(FPaths::IsRelative(Spreadsheet))
+			Spreadsheet = FPaths::Combine(FPaths::ProjectDir(), Spreadsheet);
+		Spreadsheet = FPaths::ConvertRelativePathToFull(Spreadsheet);
+	}
+	const FString SpreadsheetNames = FString::Join(Request.Spreadsheets, TEXT(", "));
+
+	Request.bCaseSensitive = Switches.Contains(TEXT("CaseSensitive"));
+	Request.bForceRefresh = Switches.Contains(TEXT("ForceRefresh"));
+	Request.bMatchByKey = !Switches.Contains(TEXT("NoMatchByKey"));
+	Request.bQuickCompile = Switches.Contains(TEXT("Quick"));
+
+	TArray<ULocalizationTarget*> Targets;
+	if(!SelectTargets(ParamVals.FindRef(TEXT("Target")), Targets))
+		return -1;
+
+	TArray<FString> TargetNames;
+	for(const ULocalizationTarget* Target : Targets)
+		TargetNames.Add(Target->Settings.Name);
+
+	// Same listing the dialog shows, so the names given here are checked against what the dialog would offer.
+	TArray<FUpdateTranslationsSettings> Settings;
+	if(!FLISpreadsheet::ImportSpreadsheets(Request.Spreadsheets, Settings))
+	{
+		UE_LOG(LocalizationImporterPlugin, Error, TEXT("Could not read the spreadsheets %s."), *SpreadsheetNames);
+		return -1;
+	}
+
+	TArray<FString> AvailablePages;
+	TArray<FString> AvailableLanguages;
+	for(const FUpdateTranslationsSettings& Setting : Settings)
+	{
+		if(Setting.Checked)
+			AvailableLanguages.Add(Setting.Title);
+		else
+			AvailablePages.Add(Setting.Title);
+	}
+
+	Request.Pages = SelectNames(ParamVals.FindRef(TEXT("Pages")), AvailablePages, TEXT("page"));
+	Request.Languages = SelectNames(ParamVals.FindRef(TEXT("Languages")), AvailableLanguages, TEXT("language"));
+	if(Request.Pages.Num() == 0 || Request.Languages.Num() == 0)
+	{
+		UE_LOG(LocalizationImporterPlugin, Error, TEXT("Nothing to import from %s: %d pages and %d languages selected."), *SpreadsheetNames, Request.Pages.Num(), Request.Languages.Num());
+		return -1;
+	}
+
+	UE_LOG(LocalizationImporterPlugin, Display, TEXT("Importing %s into %s. Pages: %s. Languages: %s."),
+		*SpreadsheetNames, *FString::Join(TargetNames, TEXT(", ")), *FString::Join(Request.Pages, TEXT(", ")), *FString::Join(Request.Languages, TEXT(", ")));
+
+	// The editor scans the asset registry on startup, a commandlet only when asked. The gather's fingerprint needs it.
+	if(Targets.ContainsByPredicate([](const ULocalizationTarget* Target) { return Target->Settings.GatherFromPackages.IsEnabled; }))
+	{
+		IAssetRegistry& AssetRegistry = FModuleManager::LoadModuleChecked<FAssetRegistryModule>(TEXT("AssetRegistry")).Get();
+		AssetRegistry.SearchAllAssets(true);
+	}
+
+	FLIRunSummary RunSummary;
+
+	// Prepared one after another, the first target builds the translation table the others share.
+	TArray<FTargetRun> Runs;
+	for(int32 TargetIndex = 0; TargetIndex < Targets.Num(); ++TargetIndex)
+	{
+		FTargetRun& Run = Runs.AddDefaulted_GetRef();
+		FText Error;
+		if(!Run.Import.Prepare(Targets[TargetIndex], Request, RunSummary, Error))
+		{
+			UE_LOG(LocalizationImporterPlugin, Error, TEXT("%s"), *Error.ToString());
+			RunSummary.Finish(false);
+			return -1;
+		}
+
+		Run.Dependencies = FLIImport::FindDependencies(Targets, TargetIndex);
+	}
+
+	TArray<FLIImport*> Imports;
+	for(FTargetRun& Run : Runs)
+		Imports.Add(&Run.Import);
+	FLIImport::InvalidateDependentGathers(Imports, Targets);
+
+	for(FTargetRun& Run : Runs)
+		Run.Pipeline = MakePipeline(Run.Import, Run.GatherStepIndex);
+
+	// A single target runs its pipeline in this process, several run side by side in processes of their own.
+	int32 ReturnCode = 0;
+	int32 FailedStep = INDEX_NONE;
+	if(Runs.Num() == 1)
+	{
+		FTargetRun& Run = Runs[0];
+		{
+			FLIRunSummary::FScopedStage Stage(RunSummary, TEXT("LIPipeline"));
+			ReturnCode = Run.Pipeline.Run(&FailedStep);
+		}
+
+		Run.bSucceeded = ReturnCode == 0;
+		Run.bGatherRan = Run.GatherStepIndex != INDEX_NONE && (FailedStep == INDEX_NONE || FailedStep > Run.GatherStepIndex);
+	}
+	else
+	{
+		RunTargets(Runs, RunSummary);
+	}
+
+	bool bSucceeded = true;
+	for(const FTargetRun& Run : Runs)
+	{
+		Run.Import.Finish(Run.bSucceeded, Run.bGatherRan);
+		bSucceeded &= Run.bSucceeded;
+	}
+	RunSummary.Finish(bSucceeded);
+
+	if(!bSucceeded)
+	{
+		if(Runs.Num() == 1)
+		{
+			const FLIPipeline& Pipeline = Runs[0].Pipeline;
+			UE_LOG(LocalizationImporterPlugin, Error, TEXT("Import failed at %s with return code %d after %.2f seconds."),
+				Pipeline.Steps.IsValidIndex(FailedStep) ? *Pipeline.Steps[FailedStep].Name : TEXT("an unknown step"), ReturnCode, RunSummary.GetWallSeconds());
+			return ReturnCode;
+		}
+
+		UE_LOG(LocalizationImporterPlugin, Error, TEXT("Import failed for %d of %d targets after %.2f seconds."),
+			Runs.FilterByPredicate([](const FTargetRun& Run) { return !Run.bSucceeded; }).Num(), Runs.Num(), RunSummary.GetWallSeconds());
+		return -1;
+	}
+
+	UE_LOG(LocalizationImporterPlugin, Display, TEXT("Import finished in %.2f seconds."), RunSummary.GetWallSeconds());
+	return 0;
+}
@@ -0,0 +1,305 @@
+// Copyright (C) 2022 Dakarai Simmons - All Rights Reserved
+
+#include "LILogBuffer.h"
+#include "Algo/BinarySearch.h"
+
+namespace LILogBuffer
+{
+	static bool IsCategoryChar(const TCHAR C)
+	{
+		return FChar::IsAlnum(C) || C == TEXT('_');
+	}
+
+	// Matches "<Name>: " at Pos and returns the position after it, or INDEX_NONE.
+	static int32 MatchPrefix(const TCHAR* Text, const int32 Len, const int32 Pos, const TCHAR* Name)
+	{
+		const int32 NameLen = FCString::Strlen(Name);
+		if(Pos + NameLen + 2 > Len || FCString::Strncmp(Text + Pos, Name, NameLen) != 0)
+			return INDEX_NONE;
+
+		return Text[Pos + NameLen] == TEXT(':') && Text[Pos + NameLen + 1] == TEXT(' ') ? Pos + NameLen + 2 : INDEX_NONE;
+	}
+
+	// Reads the verbosity UE_LOG writes after the category (nothing for Log), returning the position after it.
+	static int32 ParseVerbosity(const TCHAR* Text, const int32 Len, const int32 Pos, ELogVerbosity::Type& OutVerbosity)
+	{
+		static const ELogVerbosity::Type Verbosities[] =
+		{
+			ELogVerbosity::Fatal,
+			ELogVerbosity::Error,
+			ELogVerbosity::Warning,
+			ELogVerbosity::Display,
+			ELogVerbosity::Verbose,
+			ELogVerbosity::VeryVerbose
+		};
+
+		for(const ELogVerbosity::Type Verbosity : Verbosities)
+		{
+			const int32 End = MatchPrefix(Text, Len, Pos, ToString(Verbosity));
+			if(End != INDEX_NONE)
+			{
+				OutVerbosity = Verbosity;
+				return End;
+			}
+		}
+
+		OutVerbosity = ELogVerbosity::Log;
+		return Pos;
+	}
+
+	static void MergeSorted(const TArray<int32>& A, const TArray<int32>& B, const int32 FirstLine, TArray<int32>& Out)
+	{
+		int32 IndexA = Algo::LowerBound(A, FirstLine);
+		int32 IndexB = Algo::LowerBound(B, FirstLine);
+		while(IndexA < A.Num() || IndexB < B.Num())
+		{
+			if(IndexB == B.Num() || (IndexA < A.Num() && A[IndexA] < B[IndexB]))
+				Out.Add(A[IndexA++]);
+			else
+				Out.Add(B[IndexB++]);
+		}
+	}
+}
+
+bool FLILogBuffer::FFilter::Matches(const FLine& Line) const
+{
+	if(Category != INDEX_NONE && Line.Category != Category)
+		return false;
+
+	switch(Line.GetSeverity())
+	{
+	case ESeverity::Error:
+		return bErrors;
+	case ESeverity::Warning:
+		return bWarnings;
+	default:
+		return bMessages;
+	}
+}
+
+void FLILogBuffer::Append(const ANSICHAR* Utf8, const int32 Len)
+{
+	int32 LineStart = 0;
+	for(int32 i = 0; i < Len; ++i)
+	{
+		if(Utf8[i] != '\n')
+			continue;
+
+		// Only the first piece of the text can continue a line from an earlier append.
+		if(PartialLine.Num() > 0)
+		{
+			PartialLine.Append(Utf8 + LineStart, i - LineStart);
+			AddLine(PartialLine.GetData(), PartialLine.Num());
+			PartialLine.Reset();
+		}
+		else
+		{
+			AddLine(Utf8 + LineStart, i - LineStart);
+		}
+
+		LineStart = i + 1;
+	}
+
+	if(LineStart < Len)
+		PartialLine.Append(Utf8 + LineStart, Len - LineStart);
+}
+
+void FLILogBuffer::Flush()
+{
+	if(PartialLine.Num() > 0)
+	{
+		AddLine(PartialLine.GetData(), PartialLine.Num());
+		PartialLine.Reset();
+	}
+}
+
+void FLILogBuffer::Reset()
+{
+	Chunks.Reset();
+	Lines.Reset();
+	PartialLine.Reset();
+	Categories.Reset();
+	CategoryLines.Reset();
+	WarningLines.Reset();
+	ErrorLines.Reset();
+}
+
+void FLILogBuffer::GetFilteredLines(const FFilter& Filter, TArray<TSharedPtr<FLine>>& OutLines, const int32 FirstLine) const
+{
+	using namespace LILogBuffer;
+
+	if(Filter.IsEmpty())
+	{
+		for(int32 LineIndex = FirstLine; LineIndex < Lines.Num(); ++LineIndex)
+			OutLines.Add(Lines[LineIndex]);
+		return;
+	}
+
+	// Walk whichever index narrows things down the most, the rest of the filter is checked per line.
+	static const TArray<int32> NoLines;
+	TArray<int32> Candidates;
+	const TArray<int32>* Source = nullptr;
+	if(!Filter.bMessages)
+	{
+		MergeSorted(Filter.bErrors ? ErrorLines : NoLines, Filter.bWarnings ? WarningLines : NoLines, FirstLine, Candidates);
+		Source = &Candidates;
+	}
+	else if(CategoryLines.IsValidIndex(Filter.Category))
+	{
+		Source = &CategoryLines[Filter.Category];
+	}
+
+	if(Source)
+	{
+		for(int32 i = Algo::LowerBound(*Source, FirstLine); i < Source->Num(); ++i)
+		{
+			const TSharedPtr<FLine>& Line = Lines[(*Source)[i]];
+			if(Filter.Matches(*Line))
+				OutLines.Add(Line);
+		}
+		return;
+	}
+
+	// A category nothing was logged to.
+	if(Filter.Category != INDEX_NONE)
+		return;
+
+	for(int32 LineIndex = FirstLine; LineIndex < Lines.Num(); ++LineIndex)
+	{
+		if(Filter.Matches(*Lines[LineIndex]))
+			OutLines.Add(Lines[LineIndex]);
+	}
+}
+
+FString FLILogBuffer::ToString() const
+{
+	int32 TotalLen = PartialLine.Num();
+	for(const TSharedPtr<FLine>& Line : Lines)
+		TotalLen += Line->Len + 1;
+
+	FString Result;
+	Result.Reserve(TotalLen);
+	for(const TSharedPtr<FLine>& Line : Lines)
+	{
+		Result.AppendChars(*Chunks[Line->Chunk] + Line->Offset, Line->Len);
+		Result.AppendChar(TEXT('\n'));
+	}
+
+	if(PartialLine.Num() > 0)
+	{
+		const FUTF8ToTCHAR Converted(PartialLine.GetData(), PartialLine.Num());
+		Result.AppendChars(Converted.Get(), Converted.Length());
+	}
+
+	return Result;
+}
+
+void FLILogBuffer::AddLine(const ANSICHAR* Utf8, int32 Len)
+{
+	// Output from Windows processes comes with CRLF line endings.
+	if(Len > 0 && Utf8[Len - 1] == '\r')
+		--Len;
+
+	const int32 NumChars = FUTF8ToTCHAR_Convert::ConvertedLength(Utf8, Len);
+
+	if(Chunks.Num() == 0 || Chunks.Last().Len() + NumChars > ChunkCapacity)
+	{
+		// Reserved up front so appending never moves the text of earlier lines around.
+		FString& Chunk = Chunks.AddDefaulted_GetRef();
+		Chunk.Reserve(FMath::Max(NumChars, ChunkCapacity));
+	}
+
+	const TSharedRef<FLine> Line = MakeShared<FLine>();
+	Line->Chunk = Chunks.Num() - 1;
+	Line->Offset = Chunks.Last().Len();
+	Line->Len = NumChars;
+
+	// Decoded in place at the end of the chunk, ahead of its terminator.
+	TArray<TCHAR>& Chars = Chunks.Last().GetCharArray();
+	if(Chars.Num() == 0)
+		Chars.Add(TEXT('\0'));
+	Chars.AddUninitialized(NumChars);
+	FUTF8ToTCHAR_Convert::Convert(Chars.GetData() + Line->Offset, NumChars, Utf8, Len);
+	Chars.Last() = TEXT('\0');
+
+	ParseLine(*Line);
+
+	const int32 LineIndex = Lines.Add(Line);
+	if(Line->Category != INDEX_NONE)
+		CategoryLines[Line->Category].Add(LineIndex);
+
+	switch(Line->GetSeverity())
+	{
+	case ESeverity::Error:
+		ErrorLines.Add(LineIndex);
+		break;
+	case ESeverity::Warning:
+		WarningLines.Add(LineIndex);
+		break;
+	default:
+		break;
+	}
+}
+
+void FLILogBuffer::ParseLine(FLine& Line)
+{
+	using namespace LILogBuffer;
+
+	const TCHAR* Text = *Chunks[Line.Chunk] + Line.Offset;
+	const int32 Len = Line.Len;
+
+	Line.Category = INDEX_NONE;
+	Line.MessageOffset = 0;
+	Line.Verbosity = ELogVerbosity::Log;
+
+	// Skip the "[timestamp][frame]" prefix, when the log has one.
+	int32 Pos = 0;
+	while(Pos < Len && Text[Pos] == TEXT('['))
+	{
+		while(Pos < Len && Text[Pos] != TEXT(']'))
+			++Pos;
+		++Pos;
+	}
+
+	if(Pos >= Len)
+		return;
+
+	int32 CategoryEnd = Pos;
+	while(CategoryEnd < Len && IsCategoryChar(Text[CategoryEnd]))
+		++CategoryEnd;
+
+	// Plain output, not a log line.
+	if(CategoryEnd == Pos || CategoryEnd + 1 >= Len || Text[CategoryEnd] != TEXT(':') || Text[CategoryEnd + 1] != TEXT(' '))
+		return;
+
+	// "Warning: " or "Error: " without a category, the way some tools write them.
+	const int32 VerbosityEnd = ParseVerbosity(Text, Len, Pos, Line.Verbosity);
+	if(VerbosityEnd != Pos)
+	{
+		Line.MessageOffset = VerbosityEnd;
+		return;
+	}
+
+	Line.Category = FindOrAddCategory(Text + Pos, CategoryEnd - Pos);
+	Line.MessageOffset = ParseVerbosity(Text, Len, CategoryEnd + 2, Line.Verbosity);
+}
+
+int32 FLILogBuffer::FindOrAddCategory(const TCHAR* Name, const int32 Len)
+{
+	// Runs of lines from the same category are the common case.
+	if(Lines.Num() > 0)
+	{
+		const int32 LastCategory = Lines.Last()->Category;
+		if(Categories.IsValidIndex(LastCategory) && Categories[LastCategory].Len() == Len && FCString::Strncmp(*Categories[LastCategory], Name, Len) == 0)
+			return LastCategory;
+	}
+
+	for(int32 CategoryIndex = 0; CategoryIndex < Categories.Num(); ++CategoryIndex)
+	{
+		if(Categories[CategoryIndex].Len() == Len && FCString::Strncmp(*Categories[CategoryIndex], Name, Len) == 0)
+			return CategoryIndex;
+	}
+
+	CategoryLines.AddDefaulted();
+	return Categories.Add(FString(Len, Name));
+}
@@ -0,0 +1,75 @@
+// Copyright (C) 2022 Dakarai Simmons - All Rights Reserved
+
+#include "LILogQueue.h"
+#include "HAL/PlatformProcess.h"
+
+FLILogQueue::FLILogQueue()
+	: Ready(QueueSize),
+	Free(QueueSize)
+{}
+
+FLILogQueue::~FLILogQueue()
+{
+	Reset();
+
+	FChunk* Chunk;
+	while(Free.Dequeue(Chunk))
+		delete Chunk;
+}
+
+FLILogQueue::FChunk* FLILogQueue::AcquireChunk()
+{
+	FChunk* Chunk;
+	if(Free.Dequeue(Chunk))
+		return Chunk;
+
+	return new FChunk();
+}
+
+void FLILogQueue::Push(FChunk* Chunk)
+{
+	while(!Ready.Enqueue(Chunk))
+	{
+		// Nobody is going to make room any more.
+		if(bStopped)
+		{
+			delete Chunk;
+			return;
+		}
+		FPlatformProcess::Sleep(0.001f);
+	}
+}
+
+void FLILogQueue::Write(const ANSICHAR* Text, const int32 Len)
+{
+	FChunk* Chunk = AcquireChunk();
+	Chunk->Reset();
+	Chunk->Append((const uint8*)Text, Len);
+	Push(Chunk);
+}
+
+bool FLILogQueue::Pop(FChunk*& OutChunk)
+{
+	return Ready.Dequeue(OutChunk);
+}
+
+void FLILogQueue::ReleaseChunk(FChunk* Chunk)
+{
+	// The pool is as big as the queue, anything past that was only needed for a burst.
+	if(!Free.Enqueue(Chunk))
+		delete Chunk;
+}
+
+void FLILogQueue::Stop()
+{
+	bStopped = true;
+}
+
+void FLILogQueue::Reset()
+{
+	FChunk* Chunk;
+	while(Ready.Dequeue(Chunk))
+		ReleaseChunk(Chunk);
+
+	bStopped = false;
+}
@@ -0,0 +1,225 @@
+// Copyright (C) 2022 Dakarai Simmons - All Rights Reserved
+
+#include "LIPipeline.h"
+#include "LocalizationImporter.h"
+#include "Commandlets/Commandlet.h"
+#include "Dom/JsonObject.h"
+#include "Serialization/JsonReader.h"
+#include "Serialization/JsonSerializer.h"
+#include "Serialization/JsonWriter.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "UObject/Package.h"
+#include "UObject/UObjectGlobals.h"
+
+const TCHAR* const FLIPipeline::StepBeginMarker = TEXT("[LIPipeline] Begin ");
+const TCHAR* const FLIPipeline::StepSkipMarker = TEXT("[LIPipeline] Skip ");
+const TCHAR* const FLIPipeline::StepEndMarker = TEXT("[LIPipeline] End ");
+
+namespace LIPipeline
+{
+	// Same lookup the engine does for -run=, which accepts the class name with or without the Commandlet suffix.
+	static UClass* FindCommandletClass(const FString& CommandletName)
+	{
+		UClass* CommandletClass = FindObject<UClass>(ANY_PACKAGE, *(CommandletName + TEXT("Commandlet")), false);
+		if(!CommandletClass)
+			CommandletClass = FindObject<UClass>(ANY_PACKAGE, *CommandletName, false);
+
+		return CommandletClass && CommandletClass->IsChildOf(UCommandlet::StaticClass()) ? CommandletClass : nullptr;
+	}
+
+	// Markers can end up anywhere in a log line (after the category and verbosity), so search rather than compare the start.
+	static const TCHAR* FindAfterMarker(const FString& Line, const TCHAR* Marker)
+	{
+		const int32 MarkerIndex = Line.Find(Marker, ESearchCase::CaseSensitive);
+		return MarkerIndex == INDEX_NONE ? nullptr : *Line + MarkerIndex + FCString::Strlen(Marker);
+	}
+}
+
+bool FLIPipeline::SaveToFile(const FString& Path) const
+{
+	TArray<TSharedPtr<FJsonValue>> StepValues;
+	for(const FStep& Step : Steps)
+	{
+		const TSharedRef<FJsonObject> StepObject = MakeShared<FJsonObject>();
+		StepObject->SetStringField(TEXT("Name"), Step.Name);
+		StepObject->SetStringField(TEXT("Commandlet"), Step.CommandletName);
+		StepObject->SetStringField(TEXT("Arguments"), Step.Arguments);
+		StepObject->SetStringField(TEXT("RequiredFile"), Step.RequiredFile);
+		StepValues.Add(MakeShared<FJsonValueObject>(StepObject));
+	}
+
+	const TSharedRef<FJsonObject> Root = MakeShared<FJsonObject>();
+	Root->SetArrayField(TEXT("Steps"), StepValues);
+
+	FString Json;
+	const TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&Json);
+	return FJsonSerializer::Serialize(Root, Writer) && FFileHelper::SaveStringToFile(Json, *Path, FFileHelper::EEncodingOptions::ForceUTF8WithoutBOM);
+}
+
+bool FLIPipeline::LoadFromFile(const FString& Path)
+{
+	FString Json;
+	if(!FFileHelper::LoadFileToString(Json, *Path))
+		return false;
+
+	TSharedPtr<FJsonObject> Root;
+	const TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(Json);
+	if(!FJsonSerializer::Deserialize(Reader, Root) || !Root.IsValid())
+		return false;
+
+	Steps.Reset();
+	const TArray<TSharedPtr<FJsonValue>>* StepValues;
+	if(Root->TryGetArrayField(TEXT("Steps"), StepValues))
+	{
+		for(const TSharedPtr<FJsonValue>& Value : *StepValues)
+		{
+			const TSharedPtr<FJsonObject> StepObject = Value->AsObject();
+			if(StepObject.IsValid())
+			{
+				FStep& Step = Steps.AddDefaulted_GetRef();
+				Step.Name = StepObject->GetStringField(TEXT("Name"));
+				Step.CommandletName = StepObject->GetStringField(TEXT("Commandlet"));
+				Step.Arguments = StepObject->GetStringField(TEXT("Arguments"));
+				StepObject->TryGetStringField(TEXT("RequiredFile"), Step.RequiredFile);
+			}
+		}
+	}
+
+	return Steps.Num() > 0;
+}
+
+FString FLIPipeline::GetDefaultPath(const FString& Name)
+{
+	return FPaths::ConvertRelativePathToFull(FPaths::ProjectSavedDir() / TEXT("LocalizationImporter") / (Name + TEXT(".Pipeline.json")));
+}
+
+int32 FLIPipeline::Run(int32* OutFailedStep) const
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(LIPipeline_Run);
+
+	if(OutFailedStep)
+		*OutFailedStep = INDEX_NONE;
+
+	for(int32 StepIndex = 0; StepIndex < Steps.Num(); ++StepIndex)
+	{
+		const FStep& Step = Steps[StepIndex];
+
+		if(!Step.RequiredFile.IsEmpty() && !FPaths::FileExists(Step.RequiredFile))
+		{
+			UE_LOG(LocalizationImporterPlugin, Display, TEXT("%s%d"), StepSkipMarker, StepIndex);
+			UE_LOG(LocalizationImporterPlugin, Display, TEXT("Nothing to do for %s."), *Step.Name);
+			continue;
+		}
+
+		UE_LOG(LocalizationImporterPlugin, Display, TEXT("%s%d"), StepBeginMarker, StepIndex);
+
+		FLIProcessUsage StartUsage;
+		FLIProcessUsage::SampleCurrentProcess(StartUsage);
+
+		int32 ReturnCode = -1;
+		UClass* CommandletClass = LIPipeline::FindCommandletClass(Step.CommandletName);
+		if(CommandletClass)
+		{
+			TRACE_CPUPROFILER_EVENT_SCOPE(LIPipeline_Step);
+			const double StartTime = FPlatformTime::Seconds();
+
+			UCommandlet* Commandlet = NewObject<UCommandlet>(GetTransientPackage(), CommandletClass);
+			Commandlet->AddToRoot();
+			ReturnCode = Commandlet->Main(Step.Arguments);
+			Commandlet->RemoveFromRoot();
+
+			// Don't let one step's packages pile up under the next.
+			CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS);
+
+			UE_LOG(LocalizationImporterPlugin, Display, TEXT("%s finished in %.2f seconds."), *Step.Name, FPlatformTime::Seconds() - StartTime);
+		}
+		else
+		{
+			UE_LOG(LocalizationImporterPlugin, Error, TEXT("Could not find a commandlet named '%s'."), *Step.CommandletName);
+		}
+
+		// CPU time is what this step added, peak memory is the process's so far.
+		FLIProcessUsage Usage;
+		if(StartUsage.IsValid() && FLIProcessUsage::SampleCurrentProcess(Usage))
+			Usage.CPUSeconds -= StartUsage.CPUSeconds;
+
+		UE_LOG(LocalizationImporterPlugin, Display, TEXT("%s%d %d %.3f %llu"), StepEndMarker, StepIndex, ReturnCode, Usage.CPUSeconds, Usage.PeakResidentBytes);
+		GLog->Flush();
+
+		if(ReturnCode != 0)
+		{
+			if(OutFailedStep)
+				*OutFailedStep = StepIndex;
+			return ReturnCode;
+		}
+	}
+
+	return 0;
+}
+
+bool FLIPipeline::MayContainMarker(const ANSICHAR* Line, const int32 Len)
+{
+	// The part every marker starts with.
+	static const ANSICHAR Prefix[] = "[LIPipeline] ";
+	static const int32 PrefixLen = sizeof(Prefix) - 1;
+
+	for(int32 i = 0; i + PrefixLen <= Len; ++i)
+	{
+		if(Line[i] == '[' && FMemory::Memcmp(Line + i, Prefix, PrefixLen) == 0)
+			return true;
+	}
+	return false;
+}
+
+bool FLIPipeline::ParseStepBegin(const FString& Line, int32& OutStepIndex)
+{
+	const TCHAR* Remainder = LIPipeline::FindAfterMarker(Line, StepBeginMarker);
+	if(!Remainder || !FChar::IsDigit(*Remainder))
+		return false;
+
+	OutStepIndex = FCString::Atoi(Remainder);
+	return true;
+}
+
+bool FLIPipeline::ParseStepSkip(const FString& Line, int32& OutStepIndex)
+{
+	const TCHAR* Remainder = LIPipeline::FindAfterMarker(Line, StepSkipMarker);
+	if(!Remainder || !FChar::IsDigit(*Remainder))
+		return false;
+
+	OutStepIndex = FCString::Atoi(Remainder);
+	return true;
+}
+
+bool FLIPipeline::ParseStepEnd(const FString& Line, int32& OutStepIndex, int32& OutReturnCode, FLIProcessUsage& OutUsage)
+{
+	const TCHAR* Remainder = LIPipeline::FindAfterMarker(Line, StepEndMarker);
+	if(!Remainder || !FChar::IsDigit(*Remainder))
+		return false;
+
+	TCHAR* ReturnCodeStart = nullptr;
+	OutStepIndex = FCString::Strtoi(Remainder, &ReturnCodeStart, 10);
+	if(!ReturnCodeStart)
+	{
+		OutReturnCode = -1;
+		return true;
+	}
+
+	TCHAR* UsageStart = nullptr;
+	OutReturnCode = FCString::Strtoi(ReturnCodeStart, &UsageStart, 10);
+
+	// A negative CPU time means the platform couldn't measure it.
+	TCHAR* PeakStart = nullptr;
+	OutUsage = FLIProcessUsage();
+	if(UsageStart && *UsageStart == TEXT(' '))
+	{
+		const double CPUSeconds = FCString::Strtod(UsageStart, &PeakStart);
+		if(PeakStart && PeakStart != UsageStart && CPUSeconds >= 0.0)
+		{
+			OutUsage.CPUSeconds = CPUSeconds;
+			OutUsage.PeakResidentBytes = FCString::Strtoui64(PeakStart, nullptr, 10);
+		}
+	}
+	return true;
+}
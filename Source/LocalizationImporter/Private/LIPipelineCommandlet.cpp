@@ -0,0 +1,41 @@
+// Copyright (C) 2022 Dakarai Simmons - All Rights Reserved
+
+#include "LIPipelineCommandlet.h"
+#include "LIPipeline.h"
+#include "LocalizationImporter.h"
+#include "Misc/Paths.h"
+
+ULIPipelineCommandlet::ULIPipelineCommandlet()
+{
+	IsClient = false;
+	IsEditor = true;
+	IsServer = false;
+	LogToConsole = true;
+}
+
+int32 ULIPipelineCommandlet::Main(const FString& Params)
+{
+	TArray<FString> Tokens;
+	TArray<FString> Switches;
+	TMap<FString, FString> ParamVals;
+	UCommandlet::ParseCommandLine(*Params, Tokens, Switches, ParamVals);
+
+	FString ConfigPath = ParamVals.FindRef(TEXT("config"));
+	if(ConfigPath.IsEmpty())
+	{
+		UE_LOG(LocalizationImporterPlugin, Error, TEXT("No pipeline file given. Use -config=\"<path>\"."));
+		return -1;
+	}
+
+	if(FPaths::IsRelative(ConfigPath))
+		ConfigPath = FPaths::Combine(FPaths::ProjectDir(), ConfigPath);
+
+	FLIPipeline Pipeline;
+	if(!Pipeline.LoadFromFile(ConfigPath))
+	{
+		UE_LOG(LocalizationImporterPlugin, Error, TEXT("Could not read the pipeline from '%s'."), *ConfigPath);
+		return -1;
+	}
+
+	return Pipeline.Run();
+}
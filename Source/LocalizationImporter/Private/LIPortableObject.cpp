@@ -0,0 +1,312 @@
+// Copyright (C) 2022 Dakarai Simmons - All Rights Reserved
+
+#include "LIPortableObject.h"
+#include "LocalizationImporter.h"
+#include "Async/MappedFileHandle.h"
+#include "HAL/PlatformFilemanager.h"
+#include "GenericPlatform/GenericPlatformFile.h"
+#include "Misc/FileHelper.h"
+
+namespace LIPortableObject
+{
+	static bool StartsWith(const ANSICHAR* Line, const int32 LineLen, const ANSICHAR* Prefix)
+	{
+		const int32 PrefixLen = FCStringAnsi::Strlen(Prefix);
+		return LineLen >= PrefixLen && FMemory::Memcmp(Line, Prefix, PrefixLen) == 0;
+	}
+
+	// Batches the many small writes of a rewrite into large ones.
+	class FBufferedWriter
+	{
+	public:
+		explicit FBufferedWriter(IFileHandle* InHandle)
+			: Handle(InHandle), bError(false)
+		{
+			Buffer.Reserve(Capacity);
+		}
+
+		~FBufferedWriter()
+		{
+			Flush();
+		}
+
+		void Write(const void* Data, const int32 Len)
+		{
+			if(Buffer.Num() + Len > Capacity)
+			{
+				Flush();
+				if(Len > Capacity)
+				{
+					bError |= !Handle->Write((const uint8*)Data, Len);
+					return;
+				}
+			}
+			Buffer.Append((const uint8*)Data, Len);
+		}
+
+		void Write(const ANSICHAR* Text)
+		{
+			Write(Text, FCStringAnsi::Strlen(Text));
+		}
+
+		bool Flush()
+		{
+			if(Buffer.Num() > 0)
+			{
+				bError |= !Handle->Write(Buffer.GetData(), Buffer.Num());
+				Buffer.Reset();
+			}
+			return !bError;
+		}
+
+	private:
+		static const int32 Capacity = 256 * 1024;
+
+		IFileHandle* Handle;
+		TArray<uint8> Buffer;
+		bool bError;
+	};
+}
+
+FLIPortableObject::FLIPortableObject()
+	: MappedHandle(nullptr),
+	MappedRegion(nullptr),
+	Data(nullptr),
+	Size(0),
+	bCRLF(false)
+{}
+
+FLIPortableObject::~FLIPortableObject()
+{
+	Unload();
+}
+
+bool FLIPortableObject::Load(const FString& Path)
+{
+	Unload();
+
+	IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+	MappedHandle = PlatformFile.OpenMapped(*Path);
+	if(MappedHandle && MappedHandle->GetFileSize() > 0)
+	{
+		MappedRegion = MappedHandle->MapRegion();
+	}
+
+	if(MappedRegion)
+	{
+		Data = (const ANSICHAR*)MappedRegion->GetMappedPtr();
+		Size = (int32)MappedRegion->GetMappedSize();
+	}
+	else
+	{
+		if(!FFileHelper::LoadFileToArray(LoadedData, *Path))
+		{
+			Unload();
+			return false;
+		}
+
+		Data = (const ANSICHAR*)LoadedData.GetData();
+		Size = LoadedData.Num();
+	}
+
+	Parse();
+	return true;
+}
+
+void FLIPortableObject::Unload()
+{
+	// The region has to go before the handle it was mapped from.
+	delete MappedRegion;
+	MappedRegion = nullptr;
+	delete MappedHandle;
+	MappedHandle = nullptr;
+
+	LoadedData.Empty();
+	Entries.Empty();
+	Data = nullptr;
+	Size = 0;
+	bCRLF = false;
+}
+
+void FLIPortableObject::Parse()
+{
+	using namespace LIPortableObject;
+
+	enum class EBlock
+	{
+		None,
+		MsgCtxt,
+		MsgId,
+		MsgStr
+	};
+
+	FEntry Current;
+	EBlock Block = EBlock::None;
+	FSpan* BlockSpan = nullptr;
+
+	auto FinishEntry = [this, &Current, &Block, &BlockSpan]()
+	{
+		if(Current.MsgStr.Len > 0)
+			Entries.Add(Current);
+
+		Current = FEntry();
+		Block = EBlock::None;
+		BlockSpan = nullptr;
+	};
+
+	int32 Pos = 0;
+	while(Pos < Size)
+	{
+		const int32 LineStart = Pos;
+		while(Pos < Size && Data[Pos] != '\n')
+			++Pos;
+
+		if(Pos < Size)
+		{
+			// Replacement lines follow whatever line endings the file started with.
+			if(LineStart == 0)
+				bCRLF = Pos > LineStart && Data[Pos - 1] == '\r';
+			++Pos;
+		}
+
+		const ANSICHAR* Line = Data + LineStart;
+		const int32 LineLen = Pos - LineStart;
+
+		if(LineLen > 0 && Line[0] == '"')
+		{
+			// Continuation of whatever keyword came before.
+			if(BlockSpan)
+				BlockSpan->Len = Pos - BlockSpan->Offset;
+			continue;
+		}
+
+		const bool bMsgCtxt = StartsWith(Line, LineLen, "msgctxt ");
+		const bool bMsgId = StartsWith(Line, LineLen, "msgid ");
+		const bool bMsgStr = StartsWith(Line, LineLen, "msgstr ");
+
+		if(bMsgCtxt || (bMsgId && Block != EBlock::MsgCtxt))
+		{
+			// Start of a new entry, even if there was no blank line before it.
+			FinishEntry();
+		}
+		else if(!bMsgId && !bMsgStr)
+		{
+			// Comments, blank lines and plural forms end an entry once its msgstr has been seen.
+			if(Block == EBlock::MsgStr)
+				FinishEntry();
+
+			BlockSpan = nullptr;
+			continue;
+		}
+
+		if(bMsgCtxt)
+		{
+			Block = EBlock::MsgCtxt;
+			BlockSpan = &Current.MsgCtxt;
+		}
+		else if(bMsgId)
+		{
+			Block = EBlock::MsgId;
+			BlockSpan = &Current.MsgId;
+		}
+		else if(bMsgStr && Current.MsgId.Len > 0)
+		{
+			Block = EBlock::MsgStr;
+			BlockSpan = &Current.MsgStr;
+		}
+		else
+		{
+			BlockSpan = nullptr;
+			continue;
+		}
+
+		BlockSpan->Offset = LineStart;
+		BlockSpan->Len = LineLen;
+	}
+
+	if(Block == EBlock::MsgStr)
+		FinishEntry();
+}
+
+FLIUtf8View FLIPortableObject::GetString(const FSpan& Block, TArray<ANSICHAR>& Scratch) const
+{
+	FLIUtf8View Result;
+	bool bUsingScratch = false;
+
+	int32 Pos = Block.Offset;
+	const int32 End = Block.Offset + Block.Len;
+
+	while(Pos < End)
+	{
+		const int32 LineStart = Pos;
+		while(Pos < End && Data[Pos] != '\n')
+			++Pos;
+		const int32 LineEnd = Pos;
+		++Pos;
+
+		int32 Open = LineStart;
+		while(Open < LineEnd && Data[Open] != '"')
+			++Open;
+
+		int32 Close = LineEnd - 1;
+		while(Close > Open && Data[Close] != '"')
+			--Close;
+
+		if(Close <= Open)
+			continue;
+
+		const FLIUtf8View Part(Data + Open + 1, Close - Open - 1);
+		if(Part.IsEmpty())
+			continue;
+
+		// Most strings fit on one line, in which case the mapping itself is returned.
+		if(Result.Data == nullptr)
+		{
+			Result = Part;
+			continue;
+		}
+
+		if(!bUsingScratch)
+		{
+			Scratch.Reset();
+			Scratch.Append(Result.Data, Result.Len);
+			bUsingScratch = true;
+		}
+		Scratch.Append(Part.Data, Part.Len);
+		Result = FLIUtf8View(Scratch.GetData(), Scratch.Num());
+	}
+
+	return Result;
+}
+
+bool FLIPortableObject::Save(const FString& OutPath, const TArray<FReplacement>& Replacements) const
+{
+	using namespace LIPortableObject;
+
+	TUniquePtr<IFileHandle> FileHandle(FPlatformFileManager::Get().GetPlatformFile().OpenWrite(*OutPath));
+	if(!FileHandle)
+	{
+		UE_LOG(LocalizationImporterPlugin, Error, TEXT("Could not open '%s' for writing."), *OutPath);
+		return false;
+	}
+
+	FBufferedWriter Writer(FileHandle.Get());
+	const ANSICHAR* LineEnding = bCRLF ? "\r\n" : "\n";
+	int32 Cursor = 0;
+
+	for(const FReplacement& Replacement : Replacements)
+	{
+		const FEntry& Entry = Entries[Replacement.EntryIndex];
+
+		Writer.Write(Data + Cursor, Entry.MsgStr.Offset - Cursor);
+		Writer.Write("msgstr \"");
+		Writer.Write(Replacement.MsgStr.Data, Replacement.MsgStr.Len);
+		Writer.Write("\"");
+		Writer.Write(LineEnding);
+
+		Cursor = Entry.MsgStr.Offset + Entry.MsgStr.Len;
+	}
+
+	Writer.Write(Data + Cursor, Size - Cursor);
+	return Writer.Flush();
+}
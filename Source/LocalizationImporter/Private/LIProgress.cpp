@@ -0,0 +1,172 @@
+// Copyright (C) 2022 Dakarai Simmons - All Rights Reserved
+
+#include "LIProgress.h"
+#include "LocalizationImporter.h"
+#include "Dom/JsonObject.h"
+#include "Serialization/JsonReader.h"
+#include "Serialization/JsonSerializer.h"
+#include "Serialization/JsonWriter.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+const TCHAR* const FLIProgress::Marker = TEXT("[LIProgress] ");
+
+namespace LIProgress
+{
+	static const TCHAR GatherStepPrefix[] = TEXT("Executing GatherTextStep");
+
+	// Weight of the newest run in a task's recorded duration.
+	static const double HistoryBlend = 0.5;
+
+	static bool StartsWith(const TCHAR* Text, const int32 Len, const TCHAR* Prefix, const int32 PrefixLen)
+	{
+		return Len >= PrefixLen && FCString::Strncmp(Text, Prefix, PrefixLen) == 0;
+	}
+
+	// Reads a non-negative number (with an optional fraction) at Pos, moving Pos past it.
+	static bool ParseNumber(const TCHAR* Text, const int32 Len, int32& Pos, double& OutValue)
+	{
+		while(Pos < Len && Text[Pos] == TEXT(' '))
+			++Pos;
+
+		const int32 Start = Pos;
+		double Value = 0.0;
+		while(Pos < Len && FChar::IsDigit(Text[Pos]))
+			Value = Value * 10.0 + (Text[Pos++] - TEXT('0'));
+
+		if(Pos < Len && Text[Pos] == TEXT('.'))
+		{
+			double Scale = 0.1;
+			for(++Pos; Pos < Len && FChar::IsDigit(Text[Pos]); ++Pos, Scale *= 0.1)
+				Value += (Text[Pos] - TEXT('0')) * Scale;
+		}
+
+		OutValue = Value;
+		return Pos > Start;
+	}
+}
+
+void FLIProgress::Report(const int32 Done, const int32 Total)
+{
+	UE_LOG(LocalizationImporterPlugin, Display, TEXT("%s%d/%d"), Marker, Done, Total);
+}
+
+int32 FLIProgress::CountGatherSteps(const FString& ConfigPath)
+{
+	TArray<FString> Lines;
+	if(ConfigPath.IsEmpty() || !FFileHelper::LoadFileToStringArray(Lines, *ConfigPath))
+		return 0;
+
+	int32 NumSteps = 0;
+	for(const FString& Line : Lines)
+	{
+		if(Line.StartsWith(TEXT("[GatherTextStep"), ESearchCase::CaseSensitive))
+			++NumSteps;
+	}
+	return NumSteps;
+}
+
+void FLIProgress::ParseMessage(const TCHAR* Message, const int32 Len)
+{
+	using namespace LIProgress;
+
+	static const int32 MarkerLen = FCString::Strlen(Marker);
+	static const int32 GatherStepPrefixLen = FCString::Strlen(GatherStepPrefix);
+
+	// Cheap way out for the vast majority of lines.
+	if(Len == 0 || (Message[0] != TEXT('[') && Message[0] != TEXT('E')))
+		return;
+
+	int32 Pos;
+	double Value;
+
+	if(StartsWith(Message, Len, GatherStepPrefix, GatherStepPrefixLen))
+	{
+		Pos = GatherStepPrefixLen;
+		if(ParseNumber(Message, Len, Pos, Value))
+		{
+			Step = (int32)Value;
+			StepFraction = 0.0f;
+		}
+	}
+	else if(StartsWith(Message, Len, Marker, MarkerLen))
+	{
+		double Total;
+		Pos = MarkerLen;
+		if(ParseNumber(Message, Len, Pos, Value) && Pos < Len && Message[Pos++] == TEXT('/') && ParseNumber(Message, Len, Pos, Total) && Total > 0.0)
+			Fraction = FMath::Clamp((float)(Value / Total), 0.0f, 1.0f);
+	}
+	else if(Message[0] == TEXT('['))
+	{
+		Pos = 1;
+		if(ParseNumber(Message, Len, Pos, Value) && Pos + 1 < Len && Message[Pos] == TEXT('%') && Message[Pos + 1] == TEXT(']'))
+			StepFraction = FMath::Clamp((float)(Value / 100.0), 0.0f, 1.0f);
+	}
+}
+
+float FLIProgress::GetFraction() const
+{
+	if(Fraction >= 0.0f)
+		return Fraction;
+
+	if(NumSteps > 0 && Step != INDEX_NONE)
+		return FMath::Clamp((Step + StepFraction) / NumSteps, 0.0f, 1.0f);
+
+	// Gather commandlets that don't run steps still report percentages.
+	return StepFraction > 0.0f ? StepFraction : -1.0f;
+}
+
+bool FLITaskHistory::Load()
+{
+	FString Json;
+	if(!FFileHelper::LoadFileToString(Json, *GetPath()))
+		return false;
+
+	TSharedPtr<FJsonObject> Root;
+	const TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(Json);
+	if(!FJsonSerializer::Deserialize(Reader, Root) || !Root.IsValid())
+		return false;
+
+	Durations.Reset();
+	for(const TPair<FString, TSharedPtr<FJsonValue>>& Field : Root->Values)
+	{
+		double Seconds;
+		if(Field.Value.IsValid() && Field.Value->TryGetNumber(Seconds) && Seconds > 0.0)
+			Durations.Add(Field.Key, Seconds);
+	}
+
+	return true;
+}
+
+bool FLITaskHistory::Save() const
+{
+	const TSharedRef<FJsonObject> Root = MakeShared<FJsonObject>();
+	for(const TPair<FString, double>& Duration : Durations)
+		Root->SetNumberField(Duration.Key, Duration.Value);
+
+	FString Json;
+	const TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&Json);
+	return FJsonSerializer::Serialize(Root, Writer) && FFileHelper::SaveStringToFile(Json, *GetPath(), FFileHelper::EEncodingOptions::ForceUTF8WithoutBOM);
+}
+
+FString FLITaskHistory::GetPath()
+{
+	return FPaths::ConvertRelativePathToFull(FPaths::ProjectSavedDir() / TEXT("LocalizationImporter") / TEXT("TaskDurations.json"));
+}
+
+FString FLITaskHistory::MakeKey(const FString& CommandletName, const FString& ScriptPath)
+{
+	return CommandletName + TEXT(":") + FPaths::GetBaseFilename(ScriptPath);
+}
+
+double FLITaskHistory::GetDuration(const FString& Key) const
+{
+	const double* Seconds = Durations.Find(Key);
+	return Seconds ? *Seconds : 0.0;
+}
+
+void FLITaskHistory::Record(const FString& Key, const double Seconds)
+{
+	double& Duration = Durations.FindOrAdd(Key);
+	Duration = Duration > 0.0 ? FMath::Lerp(Duration, Seconds, LIProgress::HistoryBlend) : Seconds;
+}
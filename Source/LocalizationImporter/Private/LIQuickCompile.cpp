@@ -0,0 +1,232 @@
+// Copyright (C) 2022 Dakarai Simmons - All Rights Reserved
+
+#include "LIQuickCompile.h"
+#include "LIApplyTranslations.h"
+#include "LIImportManifest.h"
+#include "LIProgress.h"
+#include "LITranslationTable.h"
+#include "LocalizationImporter.h"
+#include "LocalizationConfigurationScript.h"
+#include "LocalizationTargetTypes.h"
+#include "LocTextHelper.h"
+#include "TextLocalizationResourceGenerator.h"
+#include "Internationalization/TextLocalizationResource.h"
+#include "HAL/FileManager.h"
+#include "Misc/Paths.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+
+namespace LIQuickCompile
+{
+	// Escapes text the way Unreal writes it to a .po file, which is the form the table's lookups expect.
+	static void AppendEscaped(TArray<ANSICHAR>& Out, const FString& Text)
+	{
+		const FTCHARToUTF8 Utf8(*Text);
+		const ANSICHAR* Data = Utf8.Get();
+		for(int32 i = 0; i < Utf8.Length(); ++i)
+		{
+			switch(Data[i])
+			{
+			case '\\':
+				Out.Add('\\');
+				Out.Add('\\');
+				break;
+			case '"':
+				Out.Add('\\');
+				Out.Add('"');
+				break;
+			case '\t':
+				Out.Add('\\');
+				Out.Add('t');
+				break;
+			case '\r':
+				Out.Add('\\');
+				Out.Add('r');
+				break;
+			case '\n':
+				Out.Add('\\');
+				Out.Add('n');
+				break;
+			default:
+				Out.Add(Data[i]);
+				break;
+			}
+		}
+	}
+
+	// Turns a translation from the table back into plain text, the way importing the .po file would.
+	static FString Unescape(const FLIUtf8View& Text)
+	{
+		TArray<ANSICHAR, TInlineAllocator<256>> Unescaped;
+		for(int32 i = 0; i < Text.Len; ++i)
+		{
+			ANSICHAR C = Text.Data[i];
+			if(C == '\\' && i + 1 < Text.Len)
+			{
+				switch(Text.Data[i + 1])
+				{
+				case '\\':
+					C = '\\';
+					++i;
+					break;
+				case '"':
+					C = '"';
+					++i;
+					break;
+				case 't':
+					C = '\t';
+					++i;
+					break;
+				case 'r':
+					C = '\r';
+					++i;
+					break;
+				case 'n':
+					C = '\n';
+					++i;
+					break;
+				default:
+					break;
+				}
+			}
+			Unescaped.Add(C);
+		}
+
+		const FUTF8ToTCHAR Converted(Unescaped.GetData(), Unescaped.Num());
+		return FString(Converted.Length(), Converted.Get());
+	}
+
+	// Fills in the culture's archive in memory, returning how many entries changed.
+	static int32 ApplyCulture(FLocTextHelper& LocTextHelper, const FLITranslationTable& Table, const FLIApplySettings& Settings, const FLIApplySettings::FCulture& Culture)
+	{
+		TRACE_CPUPROFILER_EVENT_SCOPE(LIQuickCompile_ApplyCulture);
+
+		const int32 LanguageIndex = Table.GetLanguageIndex(Culture.Language);
+		int32 NumUpdated = 0;
+
+		TArray<ANSICHAR> Escaped;
+		TArray<ANSICHAR> KeyScratch;
+		LocTextHelper.EnumerateSourceTexts([&](TSharedRef<FManifestEntry> ManifestEntry) -> bool
+		{
+			for(const FManifestContext& Context : ManifestEntry->Contexts)
+			{
+				// The msgid and msgstr the export would have written for this entry.
+				FLocItem ExportSource;
+				FLocItem ExportTranslation;
+				LocTextHelper.GetExportText(Culture.Culture, ManifestEntry->Namespace, Context.Key, Context.KeyMetadataObj, ELocTextExportSourceMethod::NativeText, ManifestEntry->Source, ExportSource, ExportTranslation);
+
+				if(!Settings.bForceRefresh && !ExportTranslation.Text.IsEmpty())
+					continue;
+
+				// Same order as the update step: the row with the entry's key first, then its English text.
+				int32 TableIndex = INDEX_NONE;
+				if(Settings.bMatchByKey)
+				{
+					Escaped.Reset();
+					AppendEscaped(Escaped, ManifestEntry->Namespace.GetString() + TEXT(",") + Context.Key.GetString());
+					TableIndex = Table.FindByContext(FLIUtf8View(Escaped.GetData(), Escaped.Num()));
+				}
+
+				if(TableIndex == INDEX_NONE)
+				{
+					Escaped.Reset();
+					AppendEscaped(Escaped, ExportSource.Text);
+					TableIndex = Table.Find(Table.MakeLookupKey(FLIUtf8View(Escaped.GetData(), Escaped.Num()), KeyScratch));
+				}
+
+				// A forced refresh also clears translations the spreadsheet no longer has.
+				const FString Translation = Unescape(Table.GetTranslation(TableIndex, LanguageIndex));
+				if(Translation.Equals(ExportTranslation.Text, ESearchCase::CaseSensitive))
+					continue;
+
+				LocTextHelper.ImportTranslation(Culture.Culture, ManifestEntry->Namespace, Context.Key, Context.KeyMetadataObj, ExportSource, FLocItem(Translation), Context.bIsOptional);
+				++NumUpdated;
+			}
+			return true;
+		}, true);
+
+		return NumUpdated;
+	}
+}
+
+FLILocResTarget FLILocResTarget::FromTarget(const ULocalizationTarget* Target)
+{
+	FLILocResTarget Result;
+	Result.DataDirectory = FPaths::ConvertRelativePathToFull(LocalizationConfigurationScript::GetDataDirectory(Target));
+	Result.ManifestName = LocalizationConfigurationScript::GetManifestFileName(Target);
+	Result.ArchiveName = LocalizationConfigurationScript::GetArchiveFileName(Target);
+	Result.LocResName = LocalizationConfigurationScript::GetLocResFileName(Target);
+
+	if(Target->Settings.SupportedCulturesStatistics.IsValidIndex(Target->Settings.NativeCultureIndex))
+		Result.NativeCulture = Target->Settings.SupportedCulturesStatistics[Target->Settings.NativeCultureIndex].CultureName;
+
+	return Result;
+}
+
+bool FLIQuickCompile::Run(const FLIApplySettings& Settings, const FLILocResTarget& Target)
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(LIQuickCompile_Run);
+
+	const double StartTime = FPlatformTime::Seconds();
+
+	TArray<FString> Languages;
+	TArray<FString> ForeignCultures;
+	for(const FLIApplySettings::FCulture& Culture : Settings.Cultures)
+	{
+		Languages.AddUnique(Culture.Language);
+		if(Culture.Culture != Target.NativeCulture)
+			ForeignCultures.AddUnique(Culture.Culture);
+	}
+
+	if(Settings.Cultures.Num() == 0)
+	{
+		UE_LOG(LocalizationImporterPlugin, Display, TEXT("None of the selected languages are cultures of %s."), *Settings.Target);
+		return true;
+	}
+
+	// The manifest and archives are whatever the last gather and import left, nothing is gathered here.
+	FLocTextHelper LocTextHelper(Target.DataDirectory, Target.ManifestName, Target.ArchiveName, Target.NativeCulture, ForeignCultures, nullptr);
+	FText LoadError;
+	if(!LocTextHelper.LoadAll(ELocTextHelperLoadFlags::Load, &LoadError))
+	{
+		UE_LOG(LocalizationImporterPlugin, Error, TEXT("Could not load the gathered text of %s, it needs a full import first: %s"), *Settings.Target, *LoadError.ToString());
+		return false;
+	}
+
+	FLITranslationTable Table;
+	const uint64 TableSourceHash = FLITranslationTable::HashSource(FLIImportManifest::HashFiles(Settings.Spreadsheets), Settings.Pages, Settings.bCaseSensitive);
+	if(Settings.TablePath.IsEmpty() || !Table.Load(Settings.TablePath, TableSourceHash) || !Table.HasLanguages(Languages))
+	{
+		if(!Table.Build(Settings.Spreadsheets, Settings.Pages, Languages, Settings.bCaseSensitive))
+			return false;
+	}
+
+	const int32 NumCultures = Settings.Cultures.Num();
+	for(int32 Index = 0; Index < NumCultures; ++Index)
+	{
+		const FLIApplySettings::FCulture& Culture = Settings.Cultures[Index];
+		const double CultureStartTime = FPlatformTime::Seconds();
+		const int32 NumUpdated = LIQuickCompile::ApplyCulture(LocTextHelper, Table, Settings, Culture);
+
+		// Platform specific text keeps what the last full import compiled for it.
+		FTextLocalizationResource LocRes;
+		TMap<FName, TSharedRef<FTextLocalizationResource>> PerPlatformLocRes;
+		const FString LocResPath = Target.DataDirectory / Culture.Culture / Target.LocResName;
+		if(!FTextLocalizationResourceGenerator::GenerateLocRes(LocTextHelper, Culture.Culture, EGenerateLocResFlags::None, LocResPath, LocRes, PerPlatformLocRes)
+			|| !LocRes.SaveToFile(LocResPath))
+		{
+			UE_LOG(LocalizationImporterPlugin, Error, TEXT("Could not write '%s'."), *LocResPath);
+			return false;
+		}
+
+		UE_LOG(LocalizationImporterPlugin, Display, TEXT("%s (%s): %d entries updated, wrote '%s' in %.2f seconds."),
+			*Culture.Language, *Culture.Culture, NumUpdated, *LocResPath, FPlatformTime::Seconds() - CultureStartTime);
+		FLIProgress::Report(Index + 1, NumCultures);
+	}
+
+	// The .po files and archives don't have these translations, so the next full import can't build on the last one.
+	FLIImportManifest::DiscardPending(Settings.Target);
+	IFileManager::Get().Delete(*FLIImportManifest::GetPath(Settings.Target), false, false, true);
+
+	UE_LOG(LocalizationImporterPlugin, Display, TEXT("Compiled %d cultures of %s in %.2f seconds."), NumCultures, *Settings.Target, FPlatformTime::Seconds() - StartTime);
+	return true;
+}
@@ -0,0 +1,50 @@
+// Copyright (C) 2022 Dakarai Simmons - All Rights Reserved
+
+#include "LIQuickCompileCommandlet.h"
+#include "LIApplyTranslations.h"
+#include "LIImport.h"
+#include "LIQuickCompile.h"
+#include "LocalizationImporter.h"
+#include "Misc/Paths.h"
+
+ULIQuickCompileCommandlet::ULIQuickCompileCommandlet()
+{
+	IsClient = false;
+	IsEditor = true;
+	IsServer = false;
+	LogToConsole = true;
+}
+
+int32 ULIQuickCompileCommandlet::Main(const FString& Params)
+{
+	TArray<FString> Tokens;
+	TArray<FString> Switches;
+	TMap<FString, FString> ParamVals;
+	UCommandlet::ParseCommandLine(*Params, Tokens, Switches, ParamVals);
+
+	FString ConfigPath = ParamVals.FindRef(TEXT("config"));
+	if(ConfigPath.IsEmpty())
+	{
+		UE_LOG(LocalizationImporterPlugin, Error, TEXT("No settings file given. Use -config=\"<path>\"."));
+		return -1;
+	}
+
+	if(FPaths::IsRelative(ConfigPath))
+		ConfigPath = FPaths::Combine(FPaths::ProjectDir(), ConfigPath);
+
+	FLIApplySettings Settings;
+	if(!Settings.LoadFromFile(ConfigPath))
+	{
+		UE_LOG(LocalizationImporterPlugin, Error, TEXT("Could not read settings from '%s'."), *ConfigPath);
+		return -1;
+	}
+
+	const ULocalizationTarget* Target = FLIImport::FindGameTarget(Settings.Target);
+	if(!Target)
+	{
+		UE_LOG(LocalizationImporterPlugin, Error, TEXT("Could not find the game localization target '%s'."), *Settings.Target);
+		return -1;
+	}
+
+	return FLIQuickCompile::Run(Settings, FLILocResTarget::FromTarget(Target)) ? 0 : -1;
+}
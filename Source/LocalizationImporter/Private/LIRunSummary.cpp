@@ -0,0 +1,236 @@
+// Copyright (C) 2022 Dakarai Simmons - All Rights Reserved
+
+#include "LIRunSummary.h"
+#include "LocalizationImporter.h"
+#include "Dom/JsonObject.h"
+#include "Serialization/JsonSerializer.h"
+#include "Serialization/JsonWriter.h"
+#include "HAL/PlatformProcess.h"
+#include "Misc/DateTime.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+#if PLATFORM_LINUX
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#elif PLATFORM_WINDOWS
+#include "Windows/AllowWindowsPlatformTypes.h"
+#include <windows.h>
+#include <psapi.h>
+#include "Windows/HideWindowsPlatformTypes.h"
+#endif
+
+namespace LIRunSummary
+{
+#if PLATFORM_LINUX
+	// Files under /proc report a size of 0, so they're read with stdio rather than the file manager.
+	static int32 ReadProcFile(const char* Path, char* Buffer, const int32 BufferSize)
+	{
+		FILE* File = fopen(Path, "r");
+		if(!File)
+			return 0;
+
+		const int32 Len = (int32)fread(Buffer, 1, BufferSize - 1, File);
+		fclose(File);
+		Buffer[Len] = 0;
+		return Len;
+	}
+
+	// Reads utime and stime from /proc/<pid>/stat and VmHWM from /proc/<pid>/status.
+	static bool SampleProc(const char* ProcDir, FLIProcessUsage& OutUsage)
+	{
+		char Path[64];
+		char Buffer[4096];
+
+		snprintf(Path, sizeof(Path), "%s/stat", ProcDir);
+		if(ReadProcFile(Path, Buffer, sizeof(Buffer)) == 0)
+			return false;
+
+		// The command name is in parentheses and may contain spaces, so fields are counted from the last ')'.
+		const char* Fields = strrchr(Buffer, ')');
+		if(!Fields)
+			return false;
+
+		// utime and stime are fields 14 and 15, the state right after ')' is field 3.
+		unsigned long long UserTicks = 0;
+		unsigned long long SystemTicks = 0;
+		if(sscanf(Fields + 1, " %*c %*d %*d %*d %*d %*d %*u %*u %*u %*u %*u %llu %llu", &UserTicks, &SystemTicks) != 2)
+			return false;
+
+		const long TicksPerSecond = sysconf(_SC_CLK_TCK);
+		OutUsage.CPUSeconds = double(UserTicks + SystemTicks) / double(TicksPerSecond > 0 ? TicksPerSecond : 100);
+
+		snprintf(Path, sizeof(Path), "%s/status", ProcDir);
+		if(ReadProcFile(Path, Buffer, sizeof(Buffer)) > 0)
+		{
+			const char* PeakLine = strstr(Buffer, "VmHWM:");
+			if(PeakLine)
+				OutUsage.PeakResidentBytes = strtoull(PeakLine + 6, nullptr, 10) * 1024;
+		}
+
+		return true;
+	}
+#elif PLATFORM_WINDOWS
+	static bool SampleHandle(HANDLE Process, FLIProcessUsage& OutUsage)
+	{
+		FILETIME CreationTime, ExitTime, KernelTime, UserTime;
+		if(!::GetProcessTimes(Process, &CreationTime, &ExitTime, &KernelTime, &UserTime))
+			return false;
+
+		// FILETIME counts 100 nanosecond intervals.
+		const auto ToSeconds = [](const FILETIME& Time)
+		{
+			return double((uint64(Time.dwHighDateTime) << 32) | Time.dwLowDateTime) / 10000000.0;
+		};
+		OutUsage.CPUSeconds = ToSeconds(KernelTime) + ToSeconds(UserTime);
+
+		PROCESS_MEMORY_COUNTERS Counters;
+		if(::K32GetProcessMemoryInfo(Process, &Counters, sizeof(Counters)))
+			OutUsage.PeakResidentBytes = Counters.PeakWorkingSetSize;
+
+		return true;
+	}
+#endif
+
+	static const TCHAR* ToString(const FLIRunSummary::EStageKind Kind)
+	{
+		switch(Kind)
+		{
+		case FLIRunSummary::EStageKind::Process:
+			return TEXT("Process");
+		case FLIRunSummary::EStageKind::Step:
+			return TEXT("Step");
+		default:
+			return TEXT("Editor");
+		}
+	}
+}
+
+bool FLIProcessUsage::SampleProcess(const FProcHandle& Handle, const uint32 ProcessId, FLIProcessUsage& OutUsage)
+{
+#if PLATFORM_LINUX
+	char ProcDir[32];
+	snprintf(ProcDir, sizeof(ProcDir), "/proc/%u", ProcessId);
+	return ProcessId != 0 && LIRunSummary::SampleProc(ProcDir, OutUsage);
+#elif PLATFORM_WINDOWS
+	return Handle.IsValid() && LIRunSummary::SampleHandle(Handle.Get(), OutUsage);
+#else
+	return false;
+#endif
+}
+
+bool FLIProcessUsage::SampleCurrentProcess(FLIProcessUsage& OutUsage)
+{
+#if PLATFORM_LINUX
+	return LIRunSummary::SampleProc("/proc/self", OutUsage);
+#elif PLATFORM_WINDOWS
+	return LIRunSummary::SampleHandle(::GetCurrentProcess(), OutUsage);
+#else
+	return false;
+#endif
+}
+
+FLIRunSummary::FScopedStage::FScopedStage(FLIRunSummary& InSummary, const FString& InName)
+	: Summary(InSummary),
+	Name(InName),
+	StartTime(FPlatformTime::Seconds())
+{
+	FLIProcessUsage::SampleCurrentProcess(StartUsage);
+}
+
+FLIRunSummary::FScopedStage::~FScopedStage()
+{
+	FStage Stage;
+	Stage.Name = Name;
+	Stage.Kind = EStageKind::Editor;
+	Stage.WallSeconds = FPlatformTime::Seconds() - StartTime;
+
+	// The whole editor's CPU time, which during these stages is mostly this thread's.
+	if(StartUsage.IsValid() && FLIProcessUsage::SampleCurrentProcess(Stage.Usage))
+		Stage.Usage.CPUSeconds -= StartUsage.CPUSeconds;
+
+	Summary.AddStage(Stage);
+}
+
+FLIRunSummary::FLIRunSummary()
+	: StartTime(FPlatformTime::Seconds()),
+	EndTime(0.0),
+	bSucceeded(false)
+{}
+
+bool FLIRunSummary::Finish(const bool bInSucceeded)
+{
+	EndTime = FPlatformTime::Seconds();
+	bSucceeded = bInSucceeded;
+
+	const FString Path = GetPath();
+	if(!Save(Path))
+	{
+		UE_LOG(LocalizationImporterPlugin, Warning, TEXT("Could not write the run summary to '%s'."), *Path);
+		return false;
+	}
+	return true;
+}
+
+double FLIRunSummary::GetWallSeconds() const
+{
+	return (EndTime > 0.0 ? EndTime : FPlatformTime::Seconds()) - StartTime;
+}
+
+double FLIRunSummary::GetCPUSeconds() const
+{
+	double CPUSeconds = 0.0;
+	for(const FStage& Stage : Stages)
+	{
+		if(Stage.Kind != EStageKind::Step && Stage.Usage.IsValid())
+			CPUSeconds += Stage.Usage.CPUSeconds;
+	}
+	return CPUSeconds;
+}
+
+uint64 FLIRunSummary::GetPeakResidentBytes() const
+{
+	uint64 PeakResidentBytes = 0;
+	for(const FStage& Stage : Stages)
+		PeakResidentBytes = FMath::Max(PeakResidentBytes, Stage.Usage.PeakResidentBytes);
+	return PeakResidentBytes;
+}
+
+FString FLIRunSummary::GetPath()
+{
+	return FPaths::ConvertRelativePathToFull(FPaths::ProjectSavedDir() / TEXT("LocalizationImporter") / TEXT("LastRun.json"));
+}
+
+bool FLIRunSummary::Save(const FString& Path) const
+{
+	TArray<TSharedPtr<FJsonValue>> StageValues;
+	for(const FStage& Stage : Stages)
+	{
+		const TSharedRef<FJsonObject> StageObject = MakeShared<FJsonObject>();
+		StageObject->SetStringField(TEXT("Name"), Stage.Name);
+		StageObject->SetStringField(TEXT("Kind"), LIRunSummary::ToString(Stage.Kind));
+		if(!Stage.Result.IsEmpty())
+			StageObject->SetStringField(TEXT("Result"), Stage.Result);
+		StageObject->SetNumberField(TEXT("WallSeconds"), Stage.WallSeconds);
+		if(Stage.Usage.IsValid())
+		{
+			StageObject->SetNumberField(TEXT("CPUSeconds"), Stage.Usage.CPUSeconds);
+			StageObject->SetNumberField(TEXT("PeakResidentBytes"), Stage.Usage.PeakResidentBytes);
+		}
+		StageValues.Add(MakeShared<FJsonValueObject>(StageObject));
+	}
+
+	const TSharedRef<FJsonObject> Root = MakeShared<FJsonObject>();
+	Root->SetStringField(TEXT("Date"), FDateTime::UtcNow().ToIso8601());
+	Root->SetBoolField(TEXT("Succeeded"), bSucceeded);
+	Root->SetNumberField(TEXT("WallSeconds"), GetWallSeconds());
+	Root->SetNumberField(TEXT("CPUSeconds"), GetCPUSeconds());
+	Root->SetNumberField(TEXT("PeakResidentBytes"), GetPeakResidentBytes());
+	Root->SetArrayField(TEXT("Stages"), StageValues);
+
+	FString Json;
+	const TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&Json);
+	return FJsonSerializer::Serialize(Root, Writer) && FFileHelper::SaveStringToFile(Json, *Path, FFileHelper::EEncodingOptions::ForceUTF8WithoutBOM);
+}
@@ -0,0 +1,115 @@
+// Copyright (C) 2022 Dakarai Simmons - All Rights Reserved
+
+#include "LISpreadsheet.h"
+#include "LIDelimitedReader.h"
+#include "LIXlsxReader.h"
+#include "LocalizationImporter.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+
+bool FLISpreadsheet::IsTranslationPageHeader(const TArray<FString>& HeaderRow)
+{
+	return HeaderRow.Num() >= 2 && HeaderRow[0].Equals(TEXT("Keys"), ESearchCase::CaseSensitive) && HeaderRow[1].Equals(TEXT("English"), ESearchCase::CaseSensitive);
+}
+
+bool FLISpreadsheet::ImportSpreadsheet(const FString& Path, TArray<FUpdateTranslationsSettings>& OutSettings, const FThreadSafeBool* CancelFlag)
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(LISpreadsheet_ImportSpreadsheet);
+
+	if(FLIDelimitedReader::IsDelimitedFile(Path))
+		return ImportDelimitedFile(Path, OutSettings);
+
+	FLIXlsxReader Reader;
+	Reader.SetCancelFlag(CancelFlag);
+	TArray<TArray<FString>> Headers;
+
+	if(!Reader.Open(Path) || !Reader.ReadHeaderRows(Headers))
+	{
+		if(Reader.IsCancelled())
+			return false;
+
+		UE_LOG(LocalizationImporterPlugin, Error, TEXT("Failed to read spreadsheet '%s'."), *Path);
+		return false;
+	}
+
+	// Pages start out unchecked, and the languages are taken from the last page that had translations.
+	const TArray<FLIXlsxReader::FSheet>& Sheets = Reader.GetSheets();
+	int32 LanguagePage = INDEX_NONE;
+
+	for(int32 i = 0; i < Sheets.Num(); ++i)
+	{
+		if(IsTranslationPageHeader(Headers[i]))
+		{
+			OutSettings.Add(FUpdateTranslationsSettings(Sheets[i].Name, false));
+			LanguagePage = i;
+		}
+	}
+
+	if(LanguagePage == INDEX_NONE)
+	{
+		UE_LOG(LocalizationImporterPlugin, Warning, TEXT("No page in '%s' starts with a \"Keys\" and \"English\" column."), *Path);
+		return false;
+	}
+
+	AddLanguages(Headers[LanguagePage], OutSettings);
+	return true;
+}
+
+bool FLISpreadsheet::ImportSpreadsheets(const TArray<FString>& Paths, TArray<FUpdateTranslationsSettings>& OutSettings, const FThreadSafeBool* CancelFlag)
+{
+	// Pages are matched case-sensitively when they're read, so they're told apart the same way here.
+	auto AddName = [](TArray<FString>& Names, const FString& Name)
+	{
+		if(!Names.ContainsByPredicate([&Name](const FString& Other) { return Other.Equals(Name, ESearchCase::CaseSensitive); }))
+			Names.Add(Name);
+	};
+
+	TArray<FString> Pages;
+	TArray<FString> Languages;
+	for(const FString& Path : Paths)
+	{
+		TArray<FUpdateTranslationsSettings> Settings;
+		if(!ImportSpreadsheet(Path, Settings, CancelFlag))
+			return false;
+
+		for(const FUpdateTranslationsSettings& Setting : Settings)
+			AddName(Setting.Checked ? Languages : Pages, Setting.Title);
+	}
+
+	for(const FString& Page : Pages)
+		OutSettings.Add(FUpdateTranslationsSettings(Page, false));
+	for(const FString& Language : Languages)
+		OutSettings.Add(FUpdateTranslationsSettings(Language, true));
+
+	return Paths.Num() > 0;
+}
+
+bool FLISpreadsheet::ImportDelimitedFile(const FString& Path, TArray<FUpdateTranslationsSettings>& OutSettings)
+{
+	FLIDelimitedReader Reader;
+	TArray<FString> Header;
+
+	if(!Reader.Open(Path) || !Reader.ReadHeaderRow(Header))
+	{
+		UE_LOG(LocalizationImporterPlugin, Error, TEXT("Failed to read spreadsheet '%s'."), *Path);
+		return false;
+	}
+
+	if(!IsTranslationPageHeader(Header))
+	{
+		UE_LOG(LocalizationImporterPlugin, Warning, TEXT("'%s' doesn't start with a \"Keys\" and \"English\" column."), *Path);
+		return false;
+	}
+
+	OutSettings.Add(FUpdateTranslationsSettings(Reader.GetPageName(), false));
+	AddLanguages(Header, OutSettings);
+	return true;
+}
+
+void FLISpreadsheet::AddLanguages(const TArray<FString>& HeaderRow, TArray<FUpdateTranslationsSettings>& OutSettings)
+{
+	for(const FString& Cell : HeaderRow)
+	{
+		if(!Cell.IsEmpty() && !Cell.Equals(TEXT("Keys"), ESearchCase::CaseSensitive) && !Cell.Equals(TEXT("English"), ESearchCase::CaseSensitive))
+			OutSettings.Add(FUpdateTranslationsSettings(Cell, true));
+	}
+}
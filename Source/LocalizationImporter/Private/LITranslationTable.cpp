@@ -0,0 +1,829 @@
+// Copyright (C) 2022 Dakarai Simmons - All Rights Reserved
+
+#include "LITranslationTable.h"
+#include "LIDelimitedReader.h"
+#include "LIXlsxReader.h"
+#include "LocalizationImporter.h"
+#include "Async/MappedFileHandle.h"
+#include "Hash/CityHash.h"
+#include "HAL/FileManager.h"
+#include "HAL/PlatformFilemanager.h"
+#include "HAL/PlatformProcess.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+
+#if PLATFORM_WINDOWS
+#include "Windows/AllowWindowsPlatformTypes.h"
+#include <windows.h>
+#include "Windows/HideWindowsPlatformTypes.h"
+#elif PLATFORM_LINUX || PLATFORM_MAC
+#include <stdio.h>
+#endif
+
+namespace LITranslation
+{
+	// U+2060 (word joiner) in UTF-8. Pairs of these mark the phrases a cell gets split into in game.
+	static const ANSICHAR SegmentMarker[] = { (ANSICHAR)0xE2, (ANSICHAR)0x81, (ANSICHAR)0xA0 };
+	static const int32 SegmentMarkerLen = 3;
+
+	// Column A holds the keys and column B the English text.
+	static const int32 KeyColumn = 0;
+	static const int32 EnglishColumn = 1;
+	static const int32 FirstLanguageColumn = 2;
+
+	static bool IsSpace(const ANSICHAR C)
+	{
+		return C == ' ' || C == '\t' || C == '\r' || C == '\n' || C == '\v' || C == '\f';
+	}
+
+	static FLIUtf8View Trim(const FLIUtf8View& Text)
+	{
+		int32 Start = 0;
+		int32 End = Text.Len;
+		while(Start < End && IsSpace(Text.Data[Start]))
+			++Start;
+		while(End > Start && IsSpace(Text.Data[End - 1]))
+			--End;
+		return FLIUtf8View(Text.Data + Start, End - Start);
+	}
+
+	static int32 FindMarker(const FLIUtf8View& Text, const int32 From)
+	{
+		for(int32 i = From; i + SegmentMarkerLen <= Text.Len; ++i)
+		{
+			if(Text.Data[i] == SegmentMarker[0] && FMemory::Memcmp(Text.Data + i, SegmentMarker, SegmentMarkerLen) == 0)
+				return i;
+		}
+		return INDEX_NONE;
+	}
+
+	// A trailing unpaired marker yields an empty segment so positions still line up between languages.
+	static void SplitSegments(const FLIUtf8View& Text, TArray<FLIUtf8View, TInlineAllocator<8>>& OutSegments)
+	{
+		int32 Start = FindMarker(Text, 0);
+		while(Start != INDEX_NONE)
+		{
+			const int32 End = FindMarker(Text, Start + SegmentMarkerLen);
+			if(End == INDEX_NONE)
+			{
+				OutSegments.Add(FLIUtf8View());
+				break;
+			}
+
+			OutSegments.Add(FLIUtf8View(Text.Data + Start + SegmentMarkerLen, End - Start - SegmentMarkerLen));
+			Start = FindMarker(Text, End + SegmentMarkerLen);
+		}
+	}
+
+	static bool IsAscii(const FLIUtf8View& Text)
+	{
+		for(int32 i = 0; i < Text.Len; ++i)
+		{
+			if((uint8)Text.Data[i] >= 0x80)
+				return false;
+		}
+		return true;
+	}
+
+	template<typename AllocatorType>
+	static void AppendLowercase(TArray<ANSICHAR, AllocatorType>& Out, const FLIUtf8View& Text)
+	{
+		if(IsAscii(Text))
+		{
+			const int32 Start = Out.AddUninitialized(Text.Len);
+			for(int32 i = 0; i < Text.Len; ++i)
+				Out[Start + i] = FCharAnsi::ToLower(Text.Data[i]);
+		}
+		else
+		{
+			const FString Lowercase = Text.ToString().ToLower();
+			const FTCHARToUTF8 Converted(*Lowercase);
+			Out.Append(Converted.Get(), Converted.Length());
+		}
+	}
+
+	static uint32 HashKey(const FLIUtf8View& Key)
+	{
+		return CityHash32(Key.Data, Key.Len);
+	}
+
+	// Index of the comma separating namespace and key in an escaped msgctxt, skipping escaped characters.
+	static int32 FindNamespaceSeparator(const FLIUtf8View& Context)
+	{
+		for(int32 i = 0; i < Context.Len; ++i)
+		{
+			if(Context.Data[i] == '\\')
+				++i;
+			else if(Context.Data[i] == ',')
+				return i;
+		}
+		return INDEX_NONE;
+	}
+
+	/*
+	 * Puts the new file in place of the old one in a single step, so a reader opens one or the other and never finds
+	 * neither. IFileManager::Move deletes the old file first. On POSIX the old file lives on for whoever has it mapped.
+	 * Windows refuses while another process has it mapped.
+	 */
+	static bool MoveIntoPlace(const FString& NewPath, const FString& Path)
+	{
+#if PLATFORM_WINDOWS
+		return ::MoveFileExW(*NewPath, *Path, MOVEFILE_REPLACE_EXISTING) != 0;
+#elif PLATFORM_LINUX || PLATFORM_MAC
+		return rename(TCHAR_TO_UTF8(*NewPath), TCHAR_TO_UTF8(*Path)) == 0;
+#else
+		return IFileManager::Get().Move(*Path, *NewPath, true, true);
+#endif
+	}
+
+	static const uint32 TableMagic = 0x5454494C; // "LITT"
+	static const uint32 TableVersion = 1;
+
+	/*
+	 * A saved table is this header followed by the table's arrays exactly as they are in memory:
+	 * entries, translations, the two indices' buckets, the string pool and finally the language
+	 * titles, each null terminated. Every array starts 8 byte aligned so it can be used in place.
+	 */
+	struct FTableHeader
+	{
+		uint32 Magic;
+		uint32 Version;
+		uint64 SourceHash;
+		uint32 bCaseSensitive;
+		int32 NumLanguages;
+		int32 NumEntries;
+		int32 NumSourceBuckets;
+		int32 NumKeyBuckets;
+		int32 NumKeys;
+		int32 PoolSize;
+		int32 LanguagesSize;
+	};
+
+	static_assert(sizeof(FTableHeader) % 8 == 0, "The first array after the header must stay aligned.");
+
+	struct FTableLayout
+	{
+		int64 Entries;
+		int64 Translations;
+		int64 SourceBuckets;
+		int64 KeyBuckets;
+		int64 Pool;
+		int64 Languages;
+		int64 Size;
+	};
+
+	// The table's entry and span types are private, so it passes them in.
+	template<typename EntryType, typename SpanType>
+	static FTableLayout GetTableLayout(const FTableHeader& Header)
+	{
+		FTableLayout Layout;
+		Layout.Entries = sizeof(FTableHeader);
+		Layout.Translations = Align(Layout.Entries + int64(Header.NumEntries) * sizeof(EntryType), 8);
+		Layout.SourceBuckets = Align(Layout.Translations + int64(Header.NumEntries) * Header.NumLanguages * sizeof(SpanType), 8);
+		Layout.KeyBuckets = Align(Layout.SourceBuckets + int64(Header.NumSourceBuckets) * sizeof(int32), 8);
+		Layout.Pool = Align(Layout.KeyBuckets + int64(Header.NumKeyBuckets) * sizeof(int32), 8);
+		Layout.Languages = Align(Layout.Pool + Header.PoolSize, 8);
+		Layout.Size = Layout.Languages + Header.LanguagesSize;
+		return Layout;
+	}
+}
+
+FLITranslationTable::FLITranslationTable()
+	: bCaseSensitive(false),
+	FirstSpreadsheetEntry(0),
+	MappedHandle(nullptr),
+	MappedRegion(nullptr)
+{}
+
+FLITranslationTable::~FLITranslationTable()
+{
+	Reset();
+}
+
+void FLITranslationTable::Reset()
+{
+	// The region has to go before the handle it was mapped from.
+	delete MappedRegion;
+	MappedRegion = nullptr;
+	delete MappedHandle;
+	MappedHandle = nullptr;
+	LoadedData.Empty();
+
+	Languages.Reset();
+	bCaseSensitive = false;
+	Pool.Reset();
+	Entries.Reset();
+	Translations.Reset();
+	SourceIndex = FIndex();
+	KeyIndex = FIndex();
+	FirstSpreadsheetEntry = 0;
+	Data = FData();
+}
+
+void FLITranslationTable::UpdateData()
+{
+	Data.Pool = Pool.GetData();
+	Data.Entries = Entries.GetData();
+	Data.Translations = Translations.GetData();
+	Data.SourceBuckets = SourceIndex.Buckets.GetData();
+	Data.KeyBuckets = KeyIndex.Buckets.GetData();
+	Data.NumEntries = Entries.Num();
+	Data.NumSourceBuckets = SourceIndex.Buckets.Num();
+	Data.NumKeyBuckets = KeyIndex.Buckets.Num();
+	Data.NumKeys = KeyIndex.NumUsed;
+}
+
+bool FLITranslationTable::Build(const TArray<FString>& Spreadsheets, const TArray<FString>& Pages, const TArray<FString>& InLanguages, const bool bInCaseSensitive)
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(LITranslationTable_Build);
+
+	Reset();
+	Languages = InLanguages;
+	bCaseSensitive = bInCaseSensitive;
+	Rehash(SourceIndex, &FEntry::SourceHash, 1024);
+	Rehash(KeyIndex, &FEntry::KeyHash, 1024);
+
+	TArray<bool> PagesFound;
+	PagesFound.Init(false, Pages.Num());
+
+	for(const FString& Spreadsheet : Spreadsheets)
+	{
+		FirstSpreadsheetEntry = Entries.Num();
+
+		const bool bRead = FLIDelimitedReader::IsDelimitedFile(Spreadsheet) ? AddDelimitedFile(Spreadsheet, Pages, PagesFound) : AddWorkbook(Spreadsheet, Pages, PagesFound);
+		if(!bRead)
+			return false;
+	}
+
+	for(int32 PageIndex = 0; PageIndex < Pages.Num(); ++PageIndex)
+	{
+		if(!PagesFound[PageIndex])
+		{
+			UE_LOG(LocalizationImporterPlugin, Error, TEXT("Page '%s' wasn't found in '%s'."), *Pages[PageIndex], *FString::Join(Spreadsheets, TEXT("', '")));
+			return false;
+		}
+	}
+
+	FirstSpreadsheetEntry = 0;
+	UpdateData();
+	return true;
+}
+
+bool FLITranslationTable::AddWorkbook(const FString& Path, const TArray<FString>& Pages, TArray<bool>& OutPagesFound)
+{
+	FLIXlsxReader Reader;
+	if(!Reader.Open(Path))
+	{
+		UE_LOG(LocalizationImporterPlugin, Error, TEXT("Failed to open spreadsheet '%s'."), *Path);
+		return false;
+	}
+
+	const TArray<FLIXlsxReader::FSheet>& Sheets = Reader.GetSheets();
+	for(int32 PageIndex = 0; PageIndex < Pages.Num(); ++PageIndex)
+	{
+		const FString& Page = Pages[PageIndex];
+		const int32 SheetIndex = Sheets.IndexOfByPredicate([&Page](const FLIXlsxReader::FSheet& Sheet)
+		{
+			return Sheet.Name.Equals(Page, ESearchCase::CaseSensitive);
+		});
+
+		if(SheetIndex == INDEX_NONE)
+			continue;
+
+		TArray<int32> ColumnLanguages;
+		const bool bRead = Reader.ForEachRow(SheetIndex, [this, &ColumnLanguages](const FLISpreadsheetRow& Row)
+		{
+			if(Row.RowNumber == 1)
+				MapLanguageColumns(Row, ColumnLanguages);
+			else
+				AddRow(Row, ColumnLanguages);
+			return true;
+		});
+
+		if(!bRead)
+		{
+			UE_LOG(LocalizationImporterPlugin, Error, TEXT("Failed to read page '%s' from '%s'."), *Page, *Path);
+			return false;
+		}
+		OutPagesFound[PageIndex] = true;
+	}
+	return true;
+}
+
+bool FLITranslationTable::AddDelimitedFile(const FString& Path, const TArray<FString>& Pages, TArray<bool>& OutPagesFound)
+{
+	FLIDelimitedReader Reader;
+	if(!Reader.Open(Path))
+	{
+		UE_LOG(LocalizationImporterPlugin, Error, TEXT("Failed to open spreadsheet '%s'."), *Path);
+		return false;
+	}
+
+	// A delimited file has a single page, named after the file.
+	bool bSelected = false;
+	for(int32 PageIndex = 0; PageIndex < Pages.Num(); ++PageIndex)
+	{
+		if(Pages[PageIndex].Equals(Reader.GetPageName(), ESearchCase::CaseSensitive))
+		{
+			OutPagesFound[PageIndex] = true;
+			bSelected = true;
+		}
+	}
+
+	if(!bSelected)
+		return true;
+
+	TArray<int32> ColumnLanguages;
+	const bool bRead = Reader.ForEachRow([this, &ColumnLanguages](const FLISpreadsheetRow& Row)
+	{
+		if(Row.RowNumber == 1)
+			MapLanguageColumns(Row, ColumnLanguages);
+		else
+			AddRow(Row, ColumnLanguages);
+		return true;
+	});
+
+	if(!bRead)
+	{
+		UE_LOG(LocalizationImporterPlugin, Error, TEXT("Failed to read '%s'."), *Path);
+		return false;
+	}
+	return true;
+}
+
+uint64 FLITranslationTable::HashSource(const uint64 SpreadsheetHash, const TArray<FString>& Pages, const bool bInCaseSensitive)
+{
+	FString Key = FString::Join(Pages, TEXT("\n"));
+	Key += FString::Printf(TEXT("\n%d"), bInCaseSensitive ? 1 : 0);
+	return CityHash64WithSeed((const char*)*Key, Key.Len() * sizeof(TCHAR), SpreadsheetHash);
+}
+
+bool FLITranslationTable::Save(const FString& Path, const uint64 SourceHash) const
+{
+	using namespace LITranslation;
+
+	TRACE_CPUPROFILER_EVENT_SCOPE(LITranslationTable_Save);
+
+	// Only a built table has its arrays at hand; a loaded one is already saved.
+	if(MappedRegion || LoadedData.Num() > 0)
+		return false;
+
+	TArray<ANSICHAR> LanguageTitles;
+	for(const FString& Language : Languages)
+	{
+		const FTCHARToUTF8 Converted(*Language);
+		LanguageTitles.Append(Converted.Get(), Converted.Length());
+		LanguageTitles.Add(0);
+	}
+
+	FTableHeader Header;
+	FMemory::Memzero(Header);
+	Header.Magic = TableMagic;
+	Header.Version = TableVersion;
+	Header.SourceHash = SourceHash;
+	Header.bCaseSensitive = bCaseSensitive ? 1 : 0;
+	Header.NumLanguages = Languages.Num();
+	Header.NumEntries = Data.NumEntries;
+	Header.NumSourceBuckets = Data.NumSourceBuckets;
+	Header.NumKeyBuckets = Data.NumKeyBuckets;
+	Header.NumKeys = Data.NumKeys;
+	Header.PoolSize = Pool.Num();
+	Header.LanguagesSize = LanguageTitles.Num();
+
+	const FTableLayout Layout = GetTableLayout<FEntry, FSpan>(Header);
+
+	TArray<uint8> Buffer;
+	Buffer.AddZeroed(Layout.Size);
+	FMemory::Memcpy(Buffer.GetData(), &Header, sizeof(Header));
+	FMemory::Memcpy(Buffer.GetData() + Layout.Entries, Data.Entries, Header.NumEntries * sizeof(FEntry));
+	FMemory::Memcpy(Buffer.GetData() + Layout.Translations, Data.Translations, Header.NumEntries * Header.NumLanguages * sizeof(FSpan));
+	FMemory::Memcpy(Buffer.GetData() + Layout.SourceBuckets, Data.SourceBuckets, Header.NumSourceBuckets * sizeof(int32));
+	FMemory::Memcpy(Buffer.GetData() + Layout.KeyBuckets, Data.KeyBuckets, Header.NumKeyBuckets * sizeof(int32));
+	FMemory::Memcpy(Buffer.GetData() + Layout.Pool, Data.Pool, Header.PoolSize);
+	FMemory::Memcpy(Buffer.GetData() + Layout.Languages, LanguageTitles.GetData(), Header.LanguagesSize);
+
+	// Another process (the LocalizationImport commandlet, or a pipeline) may have the table mapped, and truncating it
+	// under that mapping would crash it, so a new file replaces the old one. Where that fails (on Windows, while the old
+	// one is mapped) the table isn't saved, and the update step reads the spreadsheets itself.
+	const FString TempPath = Path + FString::Printf(TEXT(".%u.tmp"), FPlatformProcess::GetCurrentProcessId());
+	if(!FFileHelper::SaveArrayToFile(Buffer, *TempPath))
+	{
+		IFileManager::Get().Delete(*TempPath);
+		return false;
+	}
+
+	if(!MoveIntoPlace(TempPath, Path))
+	{
+		IFileManager::Get().Delete(*TempPath);
+		return false;
+	}
+	return true;
+}
+
+bool FLITranslationTable::Load(const FString& Path, const uint64 SourceHash)
+{
+	using namespace LITranslation;
+
+	TRACE_CPUPROFILER_EVENT_SCOPE(LITranslationTable_Load);
+
+	Reset();
+
+	IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+	if(!PlatformFile.FileExists(*Path))
+		return false;
+
+	MappedHandle = PlatformFile.OpenMapped(*Path);
+	if(MappedHandle && MappedHandle->GetFileSize() > 0)
+		MappedRegion = MappedHandle->MapRegion();
+
+	const uint8* FileData;
+	int64 FileSize;
+	if(MappedRegion)
+	{
+		FileData = MappedRegion->GetMappedPtr();
+		FileSize = MappedRegion->GetMappedSize();
+	}
+	else
+	{
+		if(!FFileHelper::LoadFileToArray(LoadedData, *Path, FILEREAD_Silent))
+		{
+			Reset();
+			return false;
+		}
+
+		FileData = LoadedData.GetData();
+		FileSize = LoadedData.Num();
+	}
+
+	FTableHeader Header;
+	if(FileSize < (int64)sizeof(Header))
+	{
+		Reset();
+		return false;
+	}
+	FMemory::Memcpy(&Header, FileData, sizeof(Header));
+
+	// The sizes first, so the arrays are known to be inside the file before they're looked at.
+	const FTableLayout Layout = GetTableLayout<FEntry, FSpan>(Header);
+	const bool bValid = Header.Magic == TableMagic && Header.Version == TableVersion && Header.SourceHash == SourceHash
+		&& Header.NumEntries >= 0 && Header.NumLanguages >= 0 && Header.PoolSize >= 0 && Header.LanguagesSize >= 0
+		&& Header.NumSourceBuckets >= 0 && Header.NumKeyBuckets >= 0
+		&& FMath::IsPowerOfTwo(Header.NumSourceBuckets) && FMath::IsPowerOfTwo(Header.NumKeyBuckets)
+		&& Layout.Size <= FileSize;
+
+	if(!bValid)
+	{
+		Reset();
+		return false;
+	}
+
+	bCaseSensitive = Header.bCaseSensitive != 0;
+
+	const ANSICHAR* Title = (const ANSICHAR*)(FileData + Layout.Languages);
+	const ANSICHAR* TitlesEnd = Title + Header.LanguagesSize;
+	while(Title < TitlesEnd && Languages.Num() < Header.NumLanguages)
+	{
+		// A title without its terminator would run past the end of the file.
+		const ANSICHAR* TitleEnd = Title;
+		while(TitleEnd < TitlesEnd && *TitleEnd != 0)
+			++TitleEnd;
+
+		if(TitleEnd == TitlesEnd)
+			break;
+
+		Languages.Add(FLIUtf8View(Title, int32(TitleEnd - Title)).ToString());
+		Title = TitleEnd + 1;
+	}
+
+	if(Languages.Num() != Header.NumLanguages)
+	{
+		Reset();
+		return false;
+	}
+
+	Data.Pool = (const ANSICHAR*)(FileData + Layout.Pool);
+	Data.Entries = (const FEntry*)(FileData + Layout.Entries);
+	Data.Translations = (const FSpan*)(FileData + Layout.Translations);
+	Data.SourceBuckets = (const int32*)(FileData + Layout.SourceBuckets);
+	Data.KeyBuckets = (const int32*)(FileData + Layout.KeyBuckets);
+	Data.NumEntries = Header.NumEntries;
+	Data.NumSourceBuckets = Header.NumSourceBuckets;
+	Data.NumKeyBuckets = Header.NumKeyBuckets;
+	Data.NumKeys = Header.NumKeys;
+
+	// A damaged file gets rebuilt rather than read out of bounds.
+	if(!IsDataValid(Header.PoolSize))
+	{
+		UE_LOG(LocalizationImporterPlugin, Warning, TEXT("'%s' is damaged, the translation table will be built again."), *Path);
+		Reset();
+		return false;
+	}
+
+	return true;
+}
+
+bool FLITranslationTable::IsDataValid(const int32 PoolSize) const
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(LITranslationTable_IsDataValid);
+
+	const auto IsValidSpan = [PoolSize](const FSpan& Span)
+	{
+		return Span.Offset >= 0 && Span.Len >= 0 && Span.Offset <= PoolSize - Span.Len;
+	};
+
+	// Lookups probe until they reach an empty bucket, so an index needs at least one.
+	const auto IsValidIndex = [this](const int32* Buckets, const int32 NumBuckets)
+	{
+		bool bHasEmpty = NumBuckets == 0;
+		for(int32 Slot = 0; Slot < NumBuckets; ++Slot)
+		{
+			if(Buckets[Slot] == INDEX_NONE)
+				bHasEmpty = true;
+			else if(Buckets[Slot] < 0 || Buckets[Slot] >= Data.NumEntries)
+				return false;
+		}
+		return bHasEmpty;
+	};
+
+	for(int32 EntryIndex = 0; EntryIndex < Data.NumEntries; ++EntryIndex)
+	{
+		if(!IsValidSpan(Data.Entries[EntryIndex].Source) || !IsValidSpan(Data.Entries[EntryIndex].Key))
+			return false;
+	}
+
+	const int64 NumTranslations = int64(Data.NumEntries) * Languages.Num();
+	for(int64 Index = 0; Index < NumTranslations; ++Index)
+	{
+		if(!IsValidSpan(Data.Translations[Index]))
+			return false;
+	}
+
+	return IsValidIndex(Data.SourceBuckets, Data.NumSourceBuckets) && IsValidIndex(Data.KeyBuckets, Data.NumKeyBuckets);
+}
+
+FString FLITranslationTable::GetDefaultPath()
+{
+	return FPaths::ConvertRelativePathToFull(FPaths::ProjectSavedDir() / TEXT("LocalizationImporter") / TEXT("TranslationTable.bin"));
+}
+
+bool FLITranslationTable::HasLanguages(const TArray<FString>& InLanguages) const
+{
+	for(const FString& Language : InLanguages)
+	{
+		if(!Languages.Contains(Language))
+			return false;
+	}
+	return true;
+}
+
+void FLITranslationTable::MapLanguageColumns(const FLISpreadsheetRow& HeaderRow, TArray<int32>& OutColumnLanguages) const
+{
+	OutColumnLanguages.Init(INDEX_NONE, HeaderRow.Cells.Num());
+
+	for(int32 Column = LITranslation::FirstLanguageColumn; Column < HeaderRow.Cells.Num(); ++Column)
+	{
+		const FString Title = HeaderRow.Cells[Column].ToString();
+		OutColumnLanguages[Column] = Languages.IndexOfByPredicate([&Title](const FString& Language)
+		{
+			return Language.Equals(Title, ESearchCase::CaseSensitive);
+		});
+	}
+}
+
+void FLITranslationTable::AddRow(const FLISpreadsheetRow& Row, const TArray<int32>& ColumnLanguages)
+{
+	using namespace LITranslation;
+
+	const FLIUtf8View English = Row.GetCell(EnglishColumn);
+	if(English.IsEmpty())
+		return;
+
+	TArray<FLIUtf8View, TInlineAllocator<8>> Segments;
+	TArray<int32, TInlineAllocator<8>> RowEntries;
+
+	if(FindMarker(English, 0) != INDEX_NONE)
+	{
+		SplitSegments(English, Segments);
+		for(const FLIUtf8View& Segment : Segments)
+			RowEntries.Add(AddEntry(Segment, FLIUtf8View()));
+	}
+	else
+	{
+		RowEntries.Add(AddEntry(English, Row.GetCell(KeyColumn)));
+	}
+
+	for(int32 Column = FirstLanguageColumn; Column < ColumnLanguages.Num(); ++Column)
+	{
+		const int32 LanguageIndex = ColumnLanguages[Column];
+		const FLIUtf8View Cell = Row.GetCell(Column);
+
+		if(LanguageIndex == INDEX_NONE || Cell.IsEmpty())
+			continue;
+
+		if(FindMarker(Cell, 0) != INDEX_NONE)
+		{
+			Segments.Reset();
+			SplitSegments(Cell, Segments);
+
+			const int32 NumPairs = FMath::Min(Segments.Num(), RowEntries.Num());
+			for(int32 i = 0; i < NumPairs; ++i)
+				SetTranslation(RowEntries[i], LanguageIndex, Segments[i]);
+		}
+		else
+		{
+			SetTranslation(RowEntries[0], LanguageIndex, Cell);
+		}
+	}
+}
+
+int32 FLITranslationTable::AddEntry(const FLIUtf8View& SourceText, const FLIUtf8View& KeyText)
+{
+	// Every row gets its own entry, so rows sharing their English text keep their own translations
+	// and can still be told apart by key. Looking them up by English finds the last one.
+	FEntry Entry;
+	Entry.Source = AddEscaped(SourceText, !bCaseSensitive);
+	Entry.SourceHash = LITranslation::HashKey(FLIUtf8View(Pool.GetData() + Entry.Source.Offset, Entry.Source.Len));
+
+	// Keys are identifiers, so they are never lowercased.
+	Entry.Key = AddEscaped(KeyText, false);
+	Entry.KeyHash = LITranslation::HashKey(FLIUtf8View(Pool.GetData() + Entry.Key.Offset, Entry.Key.Len));
+
+	const int32 EntryIndex = Entries.Add(Entry);
+	Translations.AddZeroed(Languages.Num());
+
+	const int32 SameSource = AddToIndex(SourceIndex, &FEntry::Source, &FEntry::SourceHash, EntryIndex);
+	const int32 SameKey = Entry.Key.Len > 0 ? AddToIndex(KeyIndex, &FEntry::Key, &FEntry::KeyHash, EntryIndex) : INDEX_NONE;
+
+	// A row replacing one from an earlier spreadsheet starts out with its translations,
+	// so the languages it leaves empty keep what the earlier spreadsheet had.
+	const int32 Replaced = Entry.Key.Len > 0 ? SameKey : SameSource;
+	const int32 NumLanguages = Languages.Num();
+	if(Replaced != INDEX_NONE && Replaced < FirstSpreadsheetEntry && NumLanguages > 0)
+		FMemory::Memcpy(&Translations[EntryIndex * NumLanguages], &Translations[Replaced * NumLanguages], NumLanguages * sizeof(FSpan));
+
+	return EntryIndex;
+}
+
+int32 FLITranslationTable::AddToIndex(FIndex& Index, FSpan FEntry::*Text, uint32 FEntry::*Hash, const int32 EntryIndex)
+{
+	const FEntry& Entry = Entries[EntryIndex];
+	const FSpan& EntryText = Entry.*Text;
+	const int32 Slot = FindSlot(Index.Buckets.GetData(), Index.Buckets.Num(), Entries.GetData(), Pool.GetData(),
+		Text, Hash, FLIUtf8View(Pool.GetData() + EntryText.Offset, EntryText.Len), Entry.*Hash);
+
+	// A repeated text takes the slot over, so lookups find the last row that had it.
+	const int32 Previous = Index.Buckets[Slot];
+	if(Previous == INDEX_NONE)
+		++Index.NumUsed;
+	Index.Buckets[Slot] = EntryIndex;
+
+	// Keep the load factor under a half so probe chains stay short.
+	if(Index.NumUsed * 2 > Index.Buckets.Num())
+		Rehash(Index, Hash, Index.Buckets.Num() * 2);
+
+	return Previous;
+}
+
+void FLITranslationTable::SetTranslation(const int32 EntryIndex, const int32 LanguageIndex, const FLIUtf8View& Text)
+{
+	Translations[EntryIndex * Languages.Num() + LanguageIndex] = AddEscaped(Text, false);
+}
+
+FLITranslationTable::FSpan FLITranslationTable::AddEscaped(const FLIUtf8View& Text, const bool bLowercase)
+{
+	using namespace LITranslation;
+
+	const FLIUtf8View Trimmed = Trim(Text);
+
+	TArray<ANSICHAR, TInlineAllocator<256>> Lowercase;
+	FLIUtf8View Source = Trimmed;
+	if(bLowercase)
+	{
+		AppendLowercase(Lowercase, Trimmed);
+		Source = FLIUtf8View(Lowercase.GetData(), Lowercase.Num());
+	}
+
+	FSpan Span;
+	Span.Offset = Pool.Num();
+
+	// Only quotes and line breaks are escaped; anything else a translator typed
+	// (including backslash escapes of their own) goes into the .po file untouched.
+	for(int32 i = 0; i < Source.Len; ++i)
+	{
+		const ANSICHAR C = Source.Data[i];
+		switch(C)
+		{
+		case '"':
+			Pool.Add('\\');
+			Pool.Add('"');
+			break;
+		case '\r':
+			Pool.Add('\\');
+			Pool.Add('r');
+			break;
+		case '\n':
+			Pool.Add('\\');
+			Pool.Add('n');
+			break;
+		default:
+			Pool.Add(C);
+			break;
+		}
+	}
+
+	Span.Len = Pool.Num() - Span.Offset;
+	return Span;
+}
+
+FLIUtf8View FLITranslationTable::MakeLookupKey(const FLIUtf8View& EscapedText, TArray<ANSICHAR>& Scratch) const
+{
+	const FLIUtf8View Trimmed = LITranslation::Trim(EscapedText);
+	if(bCaseSensitive)
+		return Trimmed;
+
+	Scratch.Reset();
+	LITranslation::AppendLowercase(Scratch, Trimmed);
+	return FLIUtf8View(Scratch.GetData(), Scratch.Num());
+}
+
+int32 FLITranslationTable::Find(const FLIUtf8View& LookupKey) const
+{
+	return FindInIndex(Data.SourceBuckets, Data.NumSourceBuckets, &FEntry::Source, &FEntry::SourceHash, LookupKey, LITranslation::HashKey(LookupKey));
+}
+
+int32 FLITranslationTable::FindByContext(const FLIUtf8View& EscapedContext) const
+{
+	using namespace LITranslation;
+
+	const FLIUtf8View Context = Trim(EscapedContext);
+	if(Context.IsEmpty() || Data.NumKeys == 0)
+		return INDEX_NONE;
+
+	const int32 EntryIndex = FindInIndex(Data.KeyBuckets, Data.NumKeyBuckets, &FEntry::Key, &FEntry::KeyHash, Context, HashKey(Context));
+	if(EntryIndex != INDEX_NONE)
+		return EntryIndex;
+
+	const int32 Separator = FindNamespaceSeparator(Context);
+	if(Separator == INDEX_NONE)
+		return INDEX_NONE;
+
+	const FLIUtf8View Key(Context.Data + Separator + 1, Context.Len - Separator - 1);
+	return FindInIndex(Data.KeyBuckets, Data.NumKeyBuckets, &FEntry::Key, &FEntry::KeyHash, Key, HashKey(Key));
+}
+
+FLIUtf8View FLITranslationTable::GetTranslation(const int32 EntryIndex, const int32 LanguageIndex) const
+{
+	if(EntryIndex < 0 || EntryIndex >= Data.NumEntries || !Languages.IsValidIndex(LanguageIndex))
+		return FLIUtf8View();
+
+	return GetView(Data.Translations[EntryIndex * Languages.Num() + LanguageIndex]);
+}
+
+int32 FLITranslationTable::FindInIndex(const int32* Buckets, const int32 NumBuckets, FSpan FEntry::*Text, uint32 FEntry::*Hash, const FLIUtf8View& Key, const uint32 KeyHash) const
+{
+	if(NumBuckets == 0)
+		return INDEX_NONE;
+
+	return Buckets[FindSlot(Buckets, NumBuckets, Data.Entries, Data.Pool, Text, Hash, Key, KeyHash)];
+}
+
+int32 FLITranslationTable::FindSlot(const int32* Buckets, const int32 NumBuckets, const FEntry* InEntries, const ANSICHAR* InPool,
+	FSpan FEntry::*Text, uint32 FEntry::*Hash, const FLIUtf8View& Key, const uint32 KeyHash)
+{
+	const int32 Mask = NumBuckets - 1;
+	int32 Slot = KeyHash & Mask;
+
+	for(;;)
+	{
+		const int32 EntryIndex = Buckets[Slot];
+		if(EntryIndex == INDEX_NONE)
+			return Slot;
+
+		const FEntry& Entry = InEntries[EntryIndex];
+		const FSpan& EntryText = Entry.*Text;
+		if(Entry.*Hash == KeyHash && EntryText.Len == Key.Len && FMemory::Memcmp(InPool + EntryText.Offset, Key.Data, Key.Len) == 0)
+			return Slot;
+
+		Slot = (Slot + 1) & Mask;
+	}
+}
+
+void FLITranslationTable::Rehash(FIndex& Index, uint32 FEntry::*Hash, const int32 NewBucketCount)
+{
+	// Only the entries the old buckets point at are carried over; the ones they replaced stay unreachable.
+	TArray<int32> OldBuckets = MoveTemp(Index.Buckets);
+	Index.Buckets.Init(INDEX_NONE, FMath::RoundUpToPowerOfTwo(NewBucketCount));
+
+	const int32 Mask = Index.Buckets.Num() - 1;
+	for(const int32 EntryIndex : OldBuckets)
+	{
+		if(EntryIndex == INDEX_NONE)
+			continue;
+
+		int32 Slot = Entries[EntryIndex].*Hash & Mask;
+		while(Index.Buckets[Slot] != INDEX_NONE)
+			Slot = (Slot + 1) & Mask;
+		Index.Buckets[Slot] = EntryIndex;
+	}
+}
@@ -0,0 +1,801 @@
+// Copyright (C) 2022 Dakarai Simmons - All Rights Reserved
+
+#include "LIXlsxReader.h"
+#include "LocalizationImporter.h"
+
+namespace LIXlsx
+{
+	struct FTag
+	{
+		FLIUtf8View Name;
+		FLIUtf8View Attributes;
+		bool bEnd = false;
+		bool bEmpty = false;
+
+		bool Is(const ANSICHAR* LocalName) const
+		{
+			return Name.Equals(LocalName);
+		}
+
+		bool GetAttribute(const ANSICHAR* LocalName, FLIUtf8View& OutValue) const;
+		FString GetAttributeString(const ANSICHAR* LocalName) const;
+	};
+
+	static bool IsSpace(const ANSICHAR C)
+	{
+		return C == ' ' || C == '\t' || C == '\r' || C == '\n';
+	}
+
+	static int32 HexValue(const ANSICHAR C)
+	{
+		if(C >= '0' && C <= '9') return C - '0';
+		if(C >= 'a' && C <= 'f') return C - 'a' + 10;
+		if(C >= 'A' && C <= 'F') return C - 'A' + 10;
+		return -1;
+	}
+
+	// Drops the namespace prefix ("x:row" -> "row") since writers don't agree on one.
+	static FLIUtf8View LocalName(const ANSICHAR* Data, const int32 Len)
+	{
+		for(int32 i = Len - 1; i >= 0; --i)
+		{
+			if(Data[i] == ':')
+				return FLIUtf8View(Data + i + 1, Len - i - 1);
+		}
+		return FLIUtf8View(Data, Len);
+	}
+
+	static void AppendCodepoint(TArray<ANSICHAR>& Out, const uint32 Codepoint)
+	{
+		if(Codepoint < 0x80)
+		{
+			Out.Add((ANSICHAR)Codepoint);
+		}
+		else if(Codepoint < 0x800)
+		{
+			Out.Add((ANSICHAR)(0xC0 | (Codepoint >> 6)));
+			Out.Add((ANSICHAR)(0x80 | (Codepoint & 0x3F)));
+		}
+		else if(Codepoint < 0x10000)
+		{
+			Out.Add((ANSICHAR)(0xE0 | (Codepoint >> 12)));
+			Out.Add((ANSICHAR)(0x80 | ((Codepoint >> 6) & 0x3F)));
+			Out.Add((ANSICHAR)(0x80 | (Codepoint & 0x3F)));
+		}
+		else
+		{
+			Out.Add((ANSICHAR)(0xF0 | (Codepoint >> 18)));
+			Out.Add((ANSICHAR)(0x80 | ((Codepoint >> 12) & 0x3F)));
+			Out.Add((ANSICHAR)(0x80 | ((Codepoint >> 6) & 0x3F)));
+			Out.Add((ANSICHAR)(0x80 | (Codepoint & 0x3F)));
+		}
+	}
+
+	/*
+	 * Appends text with XML entities decoded. Cell text additionally uses Excel's
+	 * "_xHHHH_" escapes for characters XML can't carry (e.g. _x000D_ for a carriage return).
+	 */
+	static void AppendDecoded(TArray<ANSICHAR>& Out, const ANSICHAR* Text, const int32 Len, const bool bEscaped, const bool bExcelEscapes)
+	{
+		int32 i = 0;
+		while(i < Len)
+		{
+			const ANSICHAR C = Text[i];
+
+			if(bEscaped && C == '&')
+			{
+				int32 End = i + 1;
+				while(End < Len && End - i < 12 && Text[End] != ';')
+					++End;
+
+				if(End < Len && Text[End] == ';')
+				{
+					const FLIUtf8View Entity(Text + i + 1, End - i - 1);
+					bool bKnown = true;
+
+					if(Entity.Equals("lt")) Out.Add('<');
+					else if(Entity.Equals("gt")) Out.Add('>');
+					else if(Entity.Equals("amp")) Out.Add('&');
+					else if(Entity.Equals("quot")) Out.Add('"');
+					else if(Entity.Equals("apos")) Out.Add('\'');
+					else if(Entity.Len > 1 && Entity.Data[0] == '#')
+					{
+						uint32 Codepoint = 0;
+						const bool bHex = Entity.Data[1] == 'x' || Entity.Data[1] == 'X';
+						for(int32 j = bHex ? 2 : 1; j < Entity.Len; ++j)
+						{
+							const int32 Digit = bHex ? HexValue(Entity.Data[j]) : (FCharAnsi::IsDigit(Entity.Data[j]) ? Entity.Data[j] - '0' : -1);
+							if(Digit < 0)
+							{
+								bKnown = false;
+								break;
+							}
+							Codepoint = Codepoint * (bHex ? 16 : 10) + Digit;
+						}
+
+						if(bKnown)
+							AppendCodepoint(Out, Codepoint);
+					}
+					else
+					{
+						bKnown = false;
+					}
+
+					if(bKnown)
+					{
+						i = End + 1;
+						continue;
+					}
+				}
+			}
+			else if(bExcelEscapes && C == '_' && i + 6 < Len && Text[i + 1] == 'x' && Text[i + 6] == '_')
+			{
+				const int32 D0 = HexValue(Text[i + 2]), D1 = HexValue(Text[i + 3]), D2 = HexValue(Text[i + 4]), D3 = HexValue(Text[i + 5]);
+				if(D0 >= 0 && D1 >= 0 && D2 >= 0 && D3 >= 0)
+				{
+					AppendCodepoint(Out, (D0 << 12) | (D1 << 8) | (D2 << 4) | D3);
+					i += 7;
+					continue;
+				}
+			}
+
+			Out.Add(C);
+			++i;
+		}
+	}
+
+	bool FTag::GetAttribute(const ANSICHAR* InLocalName, FLIUtf8View& OutValue) const
+	{
+		const ANSICHAR* Ptr = Attributes.Data;
+		const ANSICHAR* const End = Attributes.Data + Attributes.Len;
+
+		while(Ptr < End)
+		{
+			while(Ptr < End && IsSpace(*Ptr))
+				++Ptr;
+
+			const ANSICHAR* NameStart = Ptr;
+			while(Ptr < End && *Ptr != '=' && !IsSpace(*Ptr))
+				++Ptr;
+			const FLIUtf8View AttributeName = LocalName(NameStart, Ptr - NameStart);
+
+			while(Ptr < End && *Ptr != '"' && *Ptr != '\'')
+				++Ptr;
+			if(Ptr >= End)
+				return false;
+
+			const ANSICHAR Quote = *Ptr++;
+			const ANSICHAR* ValueStart = Ptr;
+			while(Ptr < End && *Ptr != Quote)
+				++Ptr;
+
+			if(AttributeName.Equals(InLocalName))
+			{
+				OutValue = FLIUtf8View(ValueStart, Ptr - ValueStart);
+				return true;
+			}
+			++Ptr;
+		}
+
+		return false;
+	}
+
+	FString FTag::GetAttributeString(const ANSICHAR* InLocalName) const
+	{
+		FLIUtf8View Value;
+		if(!GetAttribute(InLocalName, Value))
+			return FString();
+
+		TArray<ANSICHAR> Decoded;
+		AppendDecoded(Decoded, Value.Data, Value.Len, true, false);
+		return FLIUtf8View(Decoded.GetData(), Decoded.Num()).ToString();
+	}
+
+	/*
+	 * Push parser over a stream of XML bytes. Only keeps the unconsumed tail of the
+	 * input (at most one partial tag or text node), so memory doesn't grow with the document.
+	 */
+	class FXmlScanner
+	{
+	public:
+		// Return false from either callback to stop scanning.
+		typedef TFunctionRef<bool(const FTag& Tag)> FTagCallback;
+		typedef TFunctionRef<bool(const FLIUtf8View& Text, bool bEscaped)> FTextCallback;
+
+		FXmlScanner(FTagCallback InOnTag, FTextCallback InOnText)
+			: OnTag(InOnTag), OnText(InOnText) {}
+
+		bool Feed(const uint8* Data, const int32 Size)
+		{
+			Buffer.Append((const ANSICHAR*)Data, Size);
+
+			int32 Cursor = 0;
+			const bool bContinue = Scan(Cursor);
+			Buffer.RemoveAt(0, Cursor, false);
+
+			return bContinue;
+		}
+
+	private:
+		int32 Find(const int32 From, const ANSICHAR* Needle) const
+		{
+			const int32 NeedleLen = FCStringAnsi::Strlen(Needle);
+			for(int32 i = From; i + NeedleLen <= Buffer.Num(); ++i)
+			{
+				if(FMemory::Memcmp(Buffer.GetData() + i, Needle, NeedleLen) == 0)
+					return i;
+			}
+			return INDEX_NONE;
+		}
+
+		bool StartsWith(const int32 At, const ANSICHAR* Prefix) const
+		{
+			const int32 PrefixLen = FCStringAnsi::Strlen(Prefix);
+			return At + PrefixLen <= Buffer.Num() && FMemory::Memcmp(Buffer.GetData() + At, Prefix, PrefixLen) == 0;
+		}
+
+		bool Scan(int32& Cursor)
+		{
+			const ANSICHAR* const Data = Buffer.GetData();
+			const int32 Num = Buffer.Num();
+
+			while(Cursor < Num)
+			{
+				if(Data[Cursor] != '<')
+				{
+					int32 TextEnd = Cursor;
+					while(TextEnd < Num && Data[TextEnd] != '<')
+						++TextEnd;
+
+					if(TextEnd == Num)
+						return true; // Wait for the rest of the text node.
+
+					if(!OnText(FLIUtf8View(Data + Cursor, TextEnd - Cursor), true))
+						return false;
+
+					Cursor = TextEnd;
+					continue;
+				}
+
+				// Wait until we can tell a comment or CDATA section from any other tag.
+				if(Num - Cursor < 2 || (Data[Cursor + 1] == '!' && Num - Cursor < 9))
+					return true;
+
+				if(StartsWith(Cursor, "<!--"))
+				{
+					const int32 End = Find(Cursor + 4, "-->");
+					if(End == INDEX_NONE)
+						return true;
+					Cursor = End + 3;
+					continue;
+				}
+
+				if(StartsWith(Cursor, "<![CDATA["))
+				{
+					const int32 End = Find(Cursor + 9, "]]>");
+					if(End == INDEX_NONE)
+						return true;
+					if(!OnText(FLIUtf8View(Data + Cursor + 9, End - Cursor - 9), false))
+						return false;
+					Cursor = End + 3;
+					continue;
+				}
+
+				// Find the closing bracket, ignoring any inside quoted attribute values.
+				int32 Close = Cursor + 1;
+				ANSICHAR Quote = 0;
+				for(; Close < Num; ++Close)
+				{
+					const ANSICHAR C = Data[Close];
+					if(Quote)
+					{
+						if(C == Quote)
+							Quote = 0;
+					}
+					else if(C == '"' || C == '\'')
+					{
+						Quote = C;
+					}
+					else if(C == '>')
+					{
+						break;
+					}
+				}
+
+				if(Close >= Num)
+					return true;
+
+				const int32 TagStart = Cursor;
+				Cursor = Close + 1;
+
+				// Declarations and processing instructions.
+				if(Data[TagStart + 1] == '?' || Data[TagStart + 1] == '!')
+					continue;
+
+				FTag Tag;
+				int32 NameStart = TagStart + 1;
+				if(Data[NameStart] == '/')
+				{
+					Tag.bEnd = true;
+					++NameStart;
+				}
+
+				int32 ContentEnd = Close;
+				if(Data[Close - 1] == '/')
+				{
+					Tag.bEmpty = true;
+					--ContentEnd;
+				}
+
+				int32 NameEnd = NameStart;
+				while(NameEnd < ContentEnd && !IsSpace(Data[NameEnd]))
+					++NameEnd;
+
+				Tag.Name = LocalName(Data + NameStart, NameEnd - NameStart);
+				Tag.Attributes = FLIUtf8View(Data + NameEnd, ContentEnd - NameEnd);
+
+				if(!OnTag(Tag))
+					return false;
+			}
+
+			return true;
+		}
+
+		FTagCallback OnTag;
+		FTextCallback OnText;
+		TArray<ANSICHAR> Buffer;
+	};
+
+	static bool ScanEntry(FLIZipReader& Zip, const FLIZipReader::FEntry& Entry, FXmlScanner::FTagCallback OnTag, FXmlScanner::FTextCallback OnText)
+	{
+		FXmlScanner Scanner(OnTag, OnText);
+		return Zip.ReadEntry(Entry, [&Scanner](const uint8* Data, const int32 Size)
+		{
+			return Scanner.Feed(Data, Size);
+		});
+	}
+
+	static bool IgnoreText(const FLIUtf8View&, bool)
+	{
+		return true;
+	}
+
+	// "AB12" -> 27 (0-based column)
+	static int32 ParseColumn(const FLIUtf8View& Reference)
+	{
+		int32 Column = 0;
+		int32 i = 0;
+		for(; i < Reference.Len && FCharAnsi::IsAlpha(Reference.Data[i]); ++i)
+			Column = Column * 26 + (FCharAnsi::ToUpper(Reference.Data[i]) - 'A' + 1);
+
+		return i > 0 ? Column - 1 : INDEX_NONE;
+	}
+
+	static int32 ParseInt(const FLIUtf8View& Text)
+	{
+		int32 Value = 0;
+		for(int32 i = 0; i < Text.Len; ++i)
+		{
+			if(FCharAnsi::IsDigit(Text.Data[i]))
+				Value = Value * 10 + (Text.Data[i] - '0');
+		}
+		return Value;
+	}
+
+	/*
+	 * Walks <sheetData> and hands back one row at a time.
+	 * Shared string cells are left unresolved (as an index) so the caller decides how
+	 * much of the shared string table it actually needs.
+	 */
+	class FSheetParser
+	{
+	public:
+		struct FCell
+		{
+			int32 Column;
+			int32 SharedIndex;
+			int32 Offset;
+			int32 Len;
+		};
+
+		typedef TFunctionRef<bool(int32 RowNumber, const TArray<FCell>& Cells, const TArray<ANSICHAR>& Text)> FRowCallback;
+
+		explicit FSheetParser(FRowCallback InOnRow)
+			: OnRow(InOnRow) {}
+
+		bool OnTag(const FTag& Tag)
+		{
+			if(Tag.Is("row"))
+			{
+				if(!Tag.bEnd)
+				{
+					FLIUtf8View Reference;
+					RowNumber = Tag.GetAttribute("r", Reference) ? ParseInt(Reference) : RowNumber + 1;
+					NextColumn = 0;
+					Cells.Reset();
+					Text.Reset();
+				}
+
+				if(Tag.bEnd || Tag.bEmpty)
+					return OnRow(RowNumber, Cells, Text);
+			}
+			else if(Tag.Is("c"))
+			{
+				if(!Tag.bEnd)
+				{
+					FLIUtf8View Value;
+					CellColumn = Tag.GetAttribute("r", Value) ? ParseColumn(Value) : INDEX_NONE;
+					if(CellColumn == INDEX_NONE)
+						CellColumn = NextColumn;
+
+					CellType = ECellType::Other;
+					if(Tag.GetAttribute("t", Value))
+					{
+						if(Value.Equals("s"))
+							CellType = ECellType::Shared;
+						else if(Value.Equals("b"))
+							CellType = ECellType::Boolean;
+					}
+					CellStart = Text.Num();
+				}
+
+				if(Tag.bEnd || Tag.bEmpty)
+					FinishCell();
+			}
+			else if(Tag.Is("v") || (Tag.Is("t") && !bInPhonetic))
+			{
+				bCapture = !Tag.bEnd && !Tag.bEmpty;
+			}
+			else if(Tag.Is("rPh"))
+			{
+				bInPhonetic = !Tag.bEnd && !Tag.bEmpty;
+			}
+
+			return true;
+		}
+
+		bool OnText(const FLIUtf8View& InText, const bool bEscaped)
+		{
+			if(bCapture)
+				AppendDecoded(Text, InText.Data, InText.Len, bEscaped, true);
+			return true;
+		}
+
+	private:
+		void FinishCell()
+		{
+			FCell Cell;
+			Cell.Column = CellColumn;
+			Cell.SharedIndex = INDEX_NONE;
+			Cell.Offset = CellStart;
+			Cell.Len = Text.Num() - CellStart;
+
+			if(CellType == ECellType::Shared)
+			{
+				Cell.SharedIndex = Cell.Len > 0 ? ParseInt(FLIUtf8View(Text.GetData() + CellStart, Cell.Len)) : INDEX_NONE;
+				Cell.Len = 0;
+				Text.SetNum(CellStart, false);
+			}
+			else if(CellType == ECellType::Boolean && Cell.Len == 1)
+			{
+				const bool bValue = Text[CellStart] == '1';
+				Text.SetNum(CellStart, false);
+				const ANSICHAR* BoolText = bValue ? "TRUE" : "FALSE";
+				Text.Append(BoolText, FCStringAnsi::Strlen(BoolText));
+				Cell.Len = Text.Num() - CellStart;
+			}
+
+			if(Cell.SharedIndex != INDEX_NONE || Cell.Len > 0)
+				Cells.Add(Cell);
+
+			NextColumn = CellColumn + 1;
+			bCapture = false;
+		}
+
+		enum class ECellType
+		{
+			Other,
+			Shared,
+			Boolean
+		};
+
+		FRowCallback OnRow;
+		TArray<FCell> Cells;
+		TArray<ANSICHAR> Text;
+		ECellType CellType = ECellType::Other;
+		int32 RowNumber = 0;
+		int32 NextColumn = 0;
+		int32 CellColumn = 0;
+		int32 CellStart = 0;
+		bool bCapture = false;
+		bool bInPhonetic = false;
+	};
+
+	/*
+	 * Walks the shared string part. Each <si> can be a single <t> or a list of
+	 * rich text runs; phonetic guides (<rPh>) aren't part of the value.
+	 * The callback gets each decoded item and returns false once it has seen enough.
+	 */
+	static bool ScanSharedStrings(FLIZipReader& Zip, const FLIZipReader::FEntry& Entry, TArray<ANSICHAR>& Pool, TFunctionRef<bool(int32 Index, int32 Offset, int32 Len)> OnItem)
+	{
+		int32 Index = 0;
+		int32 ItemStart = 0;
+		bool bCapture = false;
+		bool bInPhonetic = false;
+
+		return ScanEntry(Zip, Entry,
+			[&](const FTag& Tag)
+			{
+				if(Tag.Is("si"))
+				{
+					if(!Tag.bEnd)
+						ItemStart = Pool.Num();
+
+					if(Tag.bEnd || Tag.bEmpty)
+					{
+						if(!OnItem(Index++, ItemStart, Pool.Num() - ItemStart))
+							return false;
+					}
+				}
+				else if(Tag.Is("t") && !bInPhonetic)
+				{
+					bCapture = !Tag.bEnd && !Tag.bEmpty;
+				}
+				else if(Tag.Is("rPh"))
+				{
+					bInPhonetic = !Tag.bEnd && !Tag.bEmpty;
+				}
+				return true;
+			},
+			[&](const FLIUtf8View& Text, const bool bEscaped)
+			{
+				if(bCapture)
+					AppendDecoded(Pool, Text.Data, Text.Len, bEscaped, true);
+				return true;
+			});
+	}
+
+	static FString ResolveTarget(const FString& Target)
+	{
+		// Relationship targets are relative to the xl/ folder unless absolute.
+		return Target.StartsWith(TEXT("/")) ? Target.Mid(1) : TEXT("xl/") + Target;
+	}
+}
+
+bool FLIXlsxReader::Open(const FString& Path)
+{
+	Sheets.Reset();
+	SharedStringsPath.Reset();
+	SharedStringPool.Reset();
+	SharedStrings.Reset();
+	bSharedStringsLoaded = false;
+
+	if(!Zip.Open(Path))
+		return false;
+
+	if(!ReadWorkbook())
+	{
+		UE_LOG(LocalizationImporterPlugin, Warning, TEXT("'%s' doesn't look like an Excel workbook."), *Path);
+		return false;
+	}
+
+	return true;
+}
+
+bool FLIXlsxReader::ReadWorkbook()
+{
+	using namespace LIXlsx;
+
+	const FLIZipReader::FEntry* WorkbookEntry = Zip.FindEntry(TEXT("xl/workbook.xml"));
+	const FLIZipReader::FEntry* RelationshipsEntry = Zip.FindEntry(TEXT("xl/_rels/workbook.xml.rels"));
+
+	if(!WorkbookEntry || !RelationshipsEntry)
+		return false;
+
+	TMap<FString, FString> Targets;
+	const bool bReadRelationships = ScanEntry(Zip, *RelationshipsEntry, [this, &Targets](const FTag& Tag)
+	{
+		if(Tag.Is("Relationship") && !Tag.bEnd)
+		{
+			const FString Target = ResolveTarget(Tag.GetAttributeString("Target"));
+			Targets.Add(Tag.GetAttributeString("Id"), Target);
+
+			if(Tag.GetAttributeString("Type").EndsWith(TEXT("/sharedStrings")))
+				SharedStringsPath = Target;
+		}
+		return true;
+	}, &IgnoreText);
+
+	TArray<TPair<FString, FString>> SheetIds;
+	const bool bReadWorkbook = ScanEntry(Zip, *WorkbookEntry, [&SheetIds](const FTag& Tag)
+	{
+		// Both the sheet id and relationship id are called "id" once the prefix is dropped,
+		// but sheetId keeps its own name so there's no ambiguity.
+		if(Tag.Is("sheet") && !Tag.bEnd)
+			SheetIds.Emplace(Tag.GetAttributeString("name"), Tag.GetAttributeString("id"));
+		return true;
+	}, &IgnoreText);
+
+	if(!bReadRelationships || !bReadWorkbook)
+		return false;
+
+	for(const TPair<FString, FString>& SheetId : SheetIds)
+	{
+		const FString* Target = Targets.Find(SheetId.Value);
+		if(Target)
+		{
+			FSheet Sheet;
+			Sheet.Name = SheetId.Key;
+			Sheet.EntryPath = *Target;
+			Sheets.Add(MoveTemp(Sheet));
+		}
+	}
+
+	if(SharedStringsPath.IsEmpty())
+		SharedStringsPath = TEXT("xl/sharedStrings.xml");
+
+	return true;
+}
+
+bool FLIXlsxReader::ReadHeaderRows(TArray<TArray<FString>>& OutHeaders)
+{
+	using namespace LIXlsx;
+
+	struct FHeader
+	{
+		TArray<FSheetParser::FCell> Cells;
+		TArray<ANSICHAR> Text;
+	};
+
+	TArray<FHeader> Headers;
+	Headers.SetNum(Sheets.Num());
+
+	TMap<int32, FString> NeededStrings;
+	int32 LastNeededString = INDEX_NONE;
+
+	for(int32 SheetIndex = 0; SheetIndex < Sheets.Num(); ++SheetIndex)
+	{
+		if(IsCancelled())
+			return false;
+
+		const FLIZipReader::FEntry* Entry = Zip.FindEntry(Sheets[SheetIndex].EntryPath);
+		if(!Entry)
+			continue;
+
+		FHeader& Header = Headers[SheetIndex];
+		FSheetParser Parser([&Header](const int32 RowNumber, const TArray<FSheetParser::FCell>& Cells, const TArray<ANSICHAR>& Text)
+		{
+			// Rows are written in order, so the first one tells us if row 1 exists at all.
+			if(RowNumber == 1)
+			{
+				Header.Cells = Cells;
+				Header.Text = Text;
+			}
+			return false;
+		});
+
+		if(!ScanEntry(Zip, *Entry,
+			[&Parser](const FTag& Tag) { return Parser.OnTag(Tag); },
+			[&Parser](const FLIUtf8View& Text, const bool bEscaped) { return Parser.OnText(Text, bEscaped); }))
+		{
+			return false;
+		}
+
+		for(const FSheetParser::FCell& Cell : Header.Cells)
+		{
+			if(Cell.SharedIndex != INDEX_NONE)
+			{
+				NeededStrings.Add(Cell.SharedIndex);
+				LastNeededString = FMath::Max(LastNeededString, Cell.SharedIndex);
+			}
+		}
+	}
+
+	if(NeededStrings.Num() > 0)
+	{
+		const FLIZipReader::FEntry* Entry = Zip.FindEntry(SharedStringsPath);
+		if(!Entry)
+			return false;
+
+		TArray<ANSICHAR> Pool;
+		const bool bRead = ScanSharedStrings(Zip, *Entry, Pool, [&](const int32 Index, const int32 Offset, const int32 Len)
+		{
+			if(FString* Needed = NeededStrings.Find(Index))
+				*Needed = FLIUtf8View(Pool.GetData() + Offset, Len).ToString();
+
+			// Only the current item is kept; headers tend to sit near the start of the table.
+			Pool.Reset();
+			return Index < LastNeededString && !IsCancelled();
+		});
+
+		if(!bRead || IsCancelled())
+			return false;
+	}
+
+	OutHeaders.Reset(Headers.Num());
+	for(const FHeader& Header : Headers)
+	{
+		TArray<FString>& Row = OutHeaders.AddDefaulted_GetRef();
+		for(const FSheetParser::FCell& Cell : Header.Cells)
+		{
+			if(Row.Num() <= Cell.Column)
+				Row.SetNum(Cell.Column + 1);
+
+			if(Cell.SharedIndex != INDEX_NONE)
+				Row[Cell.Column] = NeededStrings.FindRef(Cell.SharedIndex);
+			else
+				Row[Cell.Column] = FLIUtf8View(Header.Text.GetData() + Cell.Offset, Cell.Len).ToString();
+		}
+	}
+
+	return true;
+}
+
+bool FLIXlsxReader::LoadSharedStrings()
+{
+	using namespace LIXlsx;
+
+	if(bSharedStringsLoaded)
+		return true;
+
+	const FLIZipReader::FEntry* Entry = Zip.FindEntry(SharedStringsPath);
+
+	// Workbooks with nothing but numbers or inline strings don't have a shared string part.
+	if(!Entry)
+	{
+		bSharedStringsLoaded = true;
+		return true;
+	}
+
+	SharedStringPool.Reset();
+	SharedStrings.Reset();
+
+	bSharedStringsLoaded = ScanSharedStrings(Zip, *Entry, SharedStringPool, [this](const int32 Index, const int32 Offset, const int32 Len)
+	{
+		SharedStrings.Add({ Offset, Len });
+		return true;
+	});
+
+	return bSharedStringsLoaded;
+}
+
+bool FLIXlsxReader::ForEachRow(const int32 SheetIndex, FRowVisitor Visitor)
+{
+	using namespace LIXlsx;
+
+	if(!Sheets.IsValidIndex(SheetIndex) || !LoadSharedStrings())
+		return false;
+
+	const FLIZipReader::FEntry* Entry = Zip.FindEntry(Sheets[SheetIndex].EntryPath);
+	if(!Entry)
+		return false;
+
+	FLISpreadsheetRow Row;
+	FSheetParser Parser([this, &Row, &Visitor](const int32 RowNumber, const TArray<FSheetParser::FCell>& Cells, const TArray<ANSICHAR>& Text)
+	{
+		Row.RowNumber = RowNumber;
+		Row.Cells.Reset();
+
+		for(const FSheetParser::FCell& Cell : Cells)
+		{
+			if(Row.Cells.Num() <= Cell.Column)
+				Row.Cells.SetNumZeroed(Cell.Column + 1, false);
+
+			if(Cell.SharedIndex == INDEX_NONE)
+			{
+				Row.Cells[Cell.Column] = FLIUtf8View(Text.GetData() + Cell.Offset, Cell.Len);
+			}
+			else if(SharedStrings.IsValidIndex(Cell.SharedIndex))
+			{
+				const FSpan& Span = SharedStrings[Cell.SharedIndex];
+				Row.Cells[Cell.Column] = FLIUtf8View(SharedStringPool.GetData() + Span.Offset, Span.Len);
+			}
+		}
+
+		return Visitor(Row);
+	});
+
+	return ScanEntry(Zip, *Entry,
+		[&Parser](const FTag& Tag) { return Parser.OnTag(Tag); },
+		[&Parser](const FLIUtf8View& Text, const bool bEscaped) { return Parser.OnText(Text, bEscaped); });
+}
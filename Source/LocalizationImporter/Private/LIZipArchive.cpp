@@ -0,0 +1,263 @@
+// Copyright (C) 2022 Dakarai Simmons - All Rights Reserved
+
+#include "LIZipArchive.h"
+#include "LocalizationImporter.h"
+#include "HAL/PlatformFilemanager.h"
+#include "GenericPlatform/GenericPlatformFile.h"
+
+THIRD_PARTY_INCLUDES_START
+#include "zlib.h"
+THIRD_PARTY_INCLUDES_END
+
+namespace LIZip
+{
+	static const uint32 EndOfCentralDirectorySignature = 0x06054b50;
+	static const uint32 CentralDirectorySignature = 0x02014b50;
+	static const uint32 LocalHeaderSignature = 0x04034b50;
+	static const int32 EndOfCentralDirectorySize = 22;
+	static const int32 CentralDirectoryHeaderSize = 46;
+	static const int32 LocalHeaderSize = 30;
+	static const uint16 MethodStored = 0;
+	static const uint16 MethodDeflate = 8;
+
+	static uint16 ReadU16(const uint8* Ptr)
+	{
+		return uint16(Ptr[0]) | (uint16(Ptr[1]) << 8);
+	}
+
+	static uint32 ReadU32(const uint8* Ptr)
+	{
+		return uint32(Ptr[0]) | (uint32(Ptr[1]) << 8) | (uint32(Ptr[2]) << 16) | (uint32(Ptr[3]) << 24);
+	}
+}
+
+FLIZipReader::FLIZipReader()
+{}
+
+FLIZipReader::~FLIZipReader()
+{
+	Close();
+}
+
+bool FLIZipReader::Open(const FString& Path)
+{
+	using namespace LIZip;
+
+	Close();
+
+	FileHandle.Reset(FPlatformFileManager::Get().GetPlatformFile().OpenRead(*Path));
+	if(!FileHandle)
+		return false;
+
+	const int64 FileSize = FileHandle->Size();
+	if(FileSize < EndOfCentralDirectorySize)
+	{
+		Close();
+		return false;
+	}
+
+	// The end of central directory record is at the very end of the file,
+	// followed only by an optional comment of up to 64KB.
+	const int64 TailSize = FMath::Min<int64>(FileSize, EndOfCentralDirectorySize + 0xFFFF);
+	TArray<uint8> Tail;
+	Tail.SetNumUninitialized(TailSize);
+
+	if(!FileHandle->Seek(FileSize - TailSize) || !FileHandle->Read(Tail.GetData(), TailSize))
+	{
+		Close();
+		return false;
+	}
+
+	int32 RecordIndex = INDEX_NONE;
+	for(int32 i = TailSize - EndOfCentralDirectorySize; i >= 0; --i)
+	{
+		if(ReadU32(&Tail[i]) == EndOfCentralDirectorySignature)
+		{
+			RecordIndex = i;
+			break;
+		}
+	}
+
+	if(RecordIndex == INDEX_NONE)
+	{
+		UE_LOG(LocalizationImporterPlugin, Warning, TEXT("'%s' is not a zip archive."), *Path);
+		Close();
+		return false;
+	}
+
+	const uint8* Record = &Tail[RecordIndex];
+	const uint16 NumEntries = ReadU16(Record + 10);
+	const uint32 DirectorySize = ReadU32(Record + 12);
+	const uint32 DirectoryOffset = ReadU32(Record + 16);
+
+	if(NumEntries == 0xFFFF || DirectoryOffset == 0xFFFFFFFF || int64(DirectoryOffset) + DirectorySize > FileSize)
+	{
+		// Zip64 archives only show up past 4GB, which no workbook we read gets near.
+		UE_LOG(LocalizationImporterPlugin, Warning, TEXT("'%s' uses an unsupported zip layout."), *Path);
+		Close();
+		return false;
+	}
+
+	TArray<uint8> Directory;
+	Directory.SetNumUninitialized(DirectorySize);
+	if(!FileHandle->Seek(DirectoryOffset) || !FileHandle->Read(Directory.GetData(), DirectorySize))
+	{
+		Close();
+		return false;
+	}
+
+	Entries.Reserve(NumEntries);
+	uint32 Offset = 0;
+	for(int32 i = 0; i < NumEntries; ++i)
+	{
+		if(Offset + CentralDirectoryHeaderSize > DirectorySize || ReadU32(&Directory[Offset]) != CentralDirectorySignature)
+			break;
+
+		const uint8* Header = &Directory[Offset];
+		const uint16 NameLength = ReadU16(Header + 28);
+		const uint16 ExtraLength = ReadU16(Header + 30);
+		const uint16 CommentLength = ReadU16(Header + 32);
+
+		if(Offset + CentralDirectoryHeaderSize + NameLength > DirectorySize)
+			break;
+
+		FEntry Entry;
+		Entry.Method = ReadU16(Header + 10);
+		Entry.CompressedSize = ReadU32(Header + 20);
+		Entry.UncompressedSize = ReadU32(Header + 24);
+		Entry.LocalHeaderOffset = ReadU32(Header + 42);
+
+		const FUTF8ToTCHAR Name((const ANSICHAR*)(Header + CentralDirectoryHeaderSize), NameLength);
+		Entry.Name = FString(Name.Length(), Name.Get());
+
+		EntryIndices.Add(Entry.Name, Entries.Add(MoveTemp(Entry)));
+		Offset += CentralDirectoryHeaderSize + NameLength + ExtraLength + CommentLength;
+	}
+
+	return true;
+}
+
+void FLIZipReader::Close()
+{
+	FileHandle.Reset();
+	Entries.Reset();
+	EntryIndices.Reset();
+}
+
+const FLIZipReader::FEntry* FLIZipReader::FindEntry(const FString& Name) const
+{
+	const int32* Index = EntryIndices.Find(Name);
+	return Index ? &Entries[*Index] : nullptr;
+}
+
+bool FLIZipReader::ReadEntry(const FEntry& Entry, FBlockVisitor Visitor)
+{
+	using namespace LIZip;
+
+	if(!FileHandle)
+		return false;
+
+	uint8 LocalHeader[LocalHeaderSize];
+	if(!FileHandle->Seek(Entry.LocalHeaderOffset) || !FileHandle->Read(LocalHeader, LocalHeaderSize) || ReadU32(LocalHeader) != LocalHeaderSignature)
+		return false;
+
+	// The local header repeats the name and may carry a different extra field than the central directory.
+	const int64 DataOffset = int64(Entry.LocalHeaderOffset) + LocalHeaderSize + ReadU16(LocalHeader + 26) + ReadU16(LocalHeader + 28);
+	if(!FileHandle->Seek(DataOffset))
+		return false;
+
+	TArray<uint8> Input;
+	Input.SetNumUninitialized(BlockSize);
+	uint32 Remaining = Entry.CompressedSize;
+
+	if(Entry.Method == MethodStored)
+	{
+		while(Remaining > 0)
+		{
+			const int32 ReadSize = FMath::Min<uint32>(Remaining, BlockSize);
+			if(!FileHandle->Read(Input.GetData(), ReadSize))
+				return false;
+
+			Remaining -= ReadSize;
+			if(!Visitor(Input.GetData(), ReadSize))
+				break;
+		}
+		return true;
+	}
+
+	if(Entry.Method != MethodDeflate)
+	{
+		UE_LOG(LocalizationImporterPlugin, Warning, TEXT("Zip entry '%s' uses unsupported compression method %d."), *Entry.Name, Entry.Method);
+		return false;
+	}
+
+	TArray<uint8> Output;
+	Output.SetNumUninitialized(BlockSize);
+
+	z_stream Stream;
+	FMemory::Memzero(Stream);
+
+	// Negative window bits: zip entries are raw deflate streams without the zlib header.
+	if(inflateInit2(&Stream, -MAX_WBITS) != Z_OK)
+		return false;
+
+	bool bSuccess = true;
+	for(;;)
+	{
+		if(Stream.avail_in == 0 && Remaining > 0)
+		{
+			const int32 ReadSize = FMath::Min<uint32>(Remaining, BlockSize);
+			if(!FileHandle->Read(Input.GetData(), ReadSize))
+			{
+				bSuccess = false;
+				break;
+			}
+
+			Remaining -= ReadSize;
+			Stream.next_in = Input.GetData();
+			Stream.avail_in = ReadSize;
+		}
+
+		Stream.next_out = Output.GetData();
+		Stream.avail_out = BlockSize;
+
+		const int Result = inflate(&Stream, Z_NO_FLUSH);
+		if(Result != Z_OK && Result != Z_STREAM_END)
+		{
+			bSuccess = false;
+			break;
+		}
+
+		const int32 Produced = BlockSize - Stream.avail_out;
+		if(Produced > 0 && !Visitor(Output.GetData(), Produced))
+			break;
+
+		if(Result == Z_STREAM_END)
+			break;
+
+		// Ran out of input before the end of the stream.
+		if(Produced == 0 && Stream.avail_in == 0 && Remaining == 0)
+		{
+			bSuccess = false;
+			break;
+		}
+	}
+
+	inflateEnd(&Stream);
+
+	if(!bSuccess)
+		UE_LOG(LocalizationImporterPlugin, Warning, TEXT("Failed to inflate zip entry '%s'."), *Entry.Name);
+
+	return bSuccess;
+}
+
+bool FLIZipReader::ReadEntryToArray(const FEntry& Entry, TArray<uint8>& OutData)
+{
+	OutData.Reset((int32)Entry.UncompressedSize);
+
+	return ReadEntry(Entry, [&OutData](const uint8* Data, int32 Size)
+	{
+		OutData.Append(Data, Size);
+		return true;
+	});
+}
@@ -0,0 +1,89 @@
+// Copyright (C) 2022 Dakarai Simmons - All Rights Reserved
+
+#include "LIDelimitedReader.h"
+#include "HAL/FileManager.h"
+#include "Misc/AutomationTest.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace LIDelimitedReaderTests
+{
+	static bool ReadRows(const FString& Path, const int64 ChunkSize, TArray<TArray<FString>>& OutRows)
+	{
+		FLIDelimitedReader Reader;
+		if(!Reader.Open(Path))
+			return false;
+
+		Reader.SetChunkSize(ChunkSize);
+		OutRows.Reset();
+		return Reader.ForEachRow([&OutRows](const FLISpreadsheetRow& Row)
+		{
+			TArray<FString>& Cells = OutRows.AddDefaulted_GetRef();
+			for(const FLIUtf8View& Cell : Row.Cells)
+				Cells.Add(Cell.ToString());
+			return true;
+		});
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FLIDelimitedReaderChunksTest, "LocalizationImporter.DelimitedReader.Chunks", EAutomationTestFlags::EditorContext | EAutomationTestFlags::ProductFilter)
+
+bool FLIDelimitedReaderChunksTest::RunTest(const FString& Parameters)
+{
+	using namespace LIDelimitedReaderTests;
+
+	// Stray quotes in unquoted cells aren't quotes to the parser, so the cuts mustn't take them as such, and the
+	// multi-line quoted cells are where a misplaced cut goes wrong. Whatever the chunk size, the rows have to come out
+	// the same as reading the file in one chunk.
+	FString Text = TEXT("Keys\tEnglish\tFrench\n");
+	for(int32 Index = 0; Index < 64; ++Index)
+	{
+		switch(Index % 5)
+		{
+		case 0:
+			Text += FString::Printf(TEXT("Key%d\t12\" screen\tEcran 12\"\n"), Index);
+			break;
+		case 1:
+			Text += FString::Printf(TEXT("Key%d\t\"Line one\nline \"\"two\"\"\n\"\t\"Ligne une\nligne \"\"deux\"\"\n\"\n"), Index);
+			break;
+		case 2:
+			Text += FString::Printf(TEXT("Key%d\t\"Tab\tinside\"\t\"\n\n\"\r\n\n"), Index);
+			break;
+		case 3:
+			Text += FString::Printf(TEXT("Key%d\"\tHe said \"\"hi\"\"\t\"Il a dit\n\"\"salut\"\"\"\n"), Index);
+			break;
+		default:
+			Text += FString::Printf(TEXT("Key%d\tPlain\tSimple\n"), Index);
+			break;
+		}
+	}
+
+	const FString Path = FPaths::ConvertRelativePathToFull(FPaths::AutomationTransientDir() / TEXT("LIDelimitedReaderChunks.tsv"));
+	if(!TestTrue(TEXT("Write the test file"), FFileHelper::SaveStringToFile(Text, *Path, FFileHelper::EEncodingOptions::ForceUTF8WithoutBOM)))
+		return false;
+
+	TArray<TArray<FString>> Expected;
+	if(TestTrue(TEXT("Read in one chunk"), ReadRows(Path, MAX_int64, Expected)))
+	{
+		TestEqual(TEXT("Rows read in one chunk"), Expected.Num(), 65);
+
+		const int64 FileSize = IFileManager::Get().FileSize(*Path);
+		for(int64 ChunkSize = 1; ChunkSize <= FileSize; ChunkSize = ChunkSize < 64 ? ChunkSize + 1 : ChunkSize * 3 / 2)
+		{
+			TArray<TArray<FString>> Rows;
+			const bool bRead = ReadRows(Path, ChunkSize, Rows);
+			if(!bRead || Rows != Expected)
+			{
+				AddError(FString::Printf(TEXT("Reading in chunks of %lld bytes gave different rows than reading in one chunk."), ChunkSize));
+				break;
+			}
+		}
+	}
+
+	IFileManager::Get().Delete(*Path);
+	return true;
+}
+
+#endif
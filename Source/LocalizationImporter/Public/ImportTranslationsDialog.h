@@ -6,6 +6,8 @@
 #include "Widgets/SCompoundWidget.h"
 #include "Styling/SlateTypes.h"
 #include "Widgets/Views/STableRow.h"
+#include "Async/Future.h"
+#include "HAL/ThreadSafeBool.h"
 #include "LocalizationImporterTypes.h"
 
 class SImportTranslationsDialog : public SCompoundWidget
@@ -16,8 +18,23 @@ public:
 	SLATE_END_ARGS()
 
 	void Construct(const FArguments &InArgs);
+	virtual ~SImportTranslationsDialog();
+
+	// Picks up the spreadsheet's pages and languages once they've been read.
+	virtual void Tick(const FGeometry& AllottedGeometry, const double InCurrentTime, const float InDeltaTime) override;
 
 private:
+	/*
+	 * Spreadsheets being read on a background thread. The thread holds a reference too,
+	 * so the dialog can drop a load it no longer wants without waiting for it.
+	 */
+	struct FSpreadsheetLoad
+	{
+		TArray<FString> Paths;
+		FThreadSafeBool bCancelled;
+		TArray<FUpdateTranslationsSettings> Settings;
+	};
+
 	// Callback for when the 'Proceed' button is clicked
 	FReply OnAcceptSettings();
 
@@ -25,6 +42,13 @@ private:
 	FReply OnCancelSettings();
 
 	FReply ChooseFile();
+
+	// Lists the spreadsheets' pages and languages in the background, cancelling any load still running.
+	void LoadSpreadsheets(const TArray<FString>& Paths);
+	void CancelLoad();
+	FReply OnCancelLoadClicked();
+	bool IsLoading() const;
+	EVisibility GetLoadingVisibility() const;
 	
 	// Delegate to determine 'Proceed' button enabled state
 	bool IsProceedButtonEnabled() const;
@@ -32,20 +56,27 @@ private:
 	// Delegate to determine visibility of excel settings
 	EVisibility GetSettingsVisibility() const;
 
+	TSharedRef<SWidget> GenerateTargetSelector();
 	TSharedRef<SWidget> GeneratePageSelector();
 	TSharedRef<SWidget> GenerateLanguageSelector();
+	bool IsTargetButtonEnabled() const;
 	bool IsPageButtonEnabled() const;
 	bool IsLangButtonEnabled() const;
+	FText GetTargetButtonText() const;
 	FText GetPageButtonText() const;
 	FText GetLangButtonText() const;
 	FText GetFileButtonText() const;
+	FText GetFileButtonTooltip() const;
 	void OnCaseChecked(ECheckBoxState State);
 	void OnForceRefreshChecked(ECheckBoxState State);
+	void OnMatchByKeyChecked(ECheckBoxState State);
+	void OnQuickCompileChecked(ECheckBoxState State);
 
 	// Source Control Checking (taken from Engine source)
 	bool CheckOutOrAddFile(const FString &File, bool ForceSourceControlUpdate = false, bool ShowErrorInNotification = true, FText *OutErrorMsg = nullptr);
 	bool MakeWritable(const FString &File, bool ShowErrorInNotification = true, FText *OutErrorMsg = nullptr);
 
+	TSharedRef<ITableRow> OnGenerateTargetsRow(TSharedPtr<FUpdateTranslationsSettings> Item, const TSharedRef<STableViewBase> &Table);
 	TSharedRef<ITableRow> OnGeneratePagesRow(TSharedPtr<FUpdateTranslationsSettings> Item, const TSharedRef<STableViewBase> &Table);
 	TSharedRef<ITableRow> OnGenerateLanguagesRow(TSharedPtr<FUpdateTranslationsSettings> Item, const TSharedRef<STableViewBase> &Table);
 	ECheckBoxState IsPageSettingChecked(const TSharedPtr<FUpdateTranslationsSettings> Item) const;
@@ -54,9 +85,19 @@ private:
 	void OnUpdateLanguageSettings(const TSharedPtr<FUpdateTranslationsSettings> Item, const ECheckBoxState State);
 
 	TWeakPtr<SWindow> ParentWindowPtr;
+
+	// The game localization targets by name, every one of them picked to begin with
+	TArray<TSharedPtr<FUpdateTranslationsSettings>> SelectedTargets;
 	TArray<TSharedPtr<FUpdateTranslationsSettings>> SelectedPages;
 	TArray<TSharedPtr<FUpdateTranslationsSettings>> SelectedLanguages;
 	bool IsCaseSensitive = false;
 	bool bForceRefresh = false;
-	FString SpreadsheetPath = "";
+	bool bMatchByKey = true;
+	bool bQuickCompile = false;
+
+	// In order of precedence, the last one wins
+	TArray<FString> SpreadsheetPaths;
+
+	TSharedPtr<FSpreadsheetLoad, ESPMode::ThreadSafe> SpreadsheetLoad;
+	TFuture<bool> SpreadsheetLoadResult;
 };
@@ -0,0 +1,100 @@
+// Copyright (C) 2022 Dakarai Simmons - All Rights Reserved
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "LIImportManifest.h"
+
+class FLITranslationTable;
+
+/*
+ * Everything the translation step needs, written by the import dialog
+ * and read back by the LIApplyTranslations commandlet.
+ */
+struct FLIApplySettings
+{
+	struct FCulture
+	{
+		// Column title in the spreadsheet, e.g. "Spanish (Spain)"
+		FString Language;
+
+		// Culture code of the localization target, e.g. "es-ES"
+		FString Culture;
+
+		FString POPath;
+	};
+
+	FLIApplySettings()
+		: bCaseSensitive(false),
+		bForceRefresh(false),
+		bMatchByKey(true),
+		MaxParallelCultures(0) {}
+
+	bool SaveToFile(const FString& Path) const;
+	bool LoadFromFile(const FString& Path);
+
+	// Each localization target's settings are kept apart, so targets can be imported at the same time.
+	static FString GetDefaultPath(const FString& TargetName);
+
+	// Changes whenever a setting that affects what goes into the culture's .po file changes.
+	uint64 GetCultureSettingsHash(const FCulture& Culture) const;
+
+	// Maps a spreadsheet language title onto one of the target's cultures, or returns an empty string.
+	static FString FindCultureForLanguage(const FString& Language, const TArray<FString>& TargetCultures);
+
+	// Name of the localization target, which picks the import manifest
+	FString Target;
+
+	// In order of precedence, the last one wins
+	TArray<FString> Spreadsheets;
+
+	// The spreadsheets' translation table, saved when the import was prepared. Built from the spreadsheet when it doesn't match.
+	FString TablePath;
+
+	TArray<FString> Pages;
+	bool bCaseSensitive;
+	bool bForceRefresh;
+
+	// Match .po entries to rows by msgctxt and the Keys column first, falling back to the English text
+	bool bMatchByKey;
+
+	// How many cultures are applied at once, 0 means one per core
+	int32 MaxParallelCultures;
+
+	TArray<FCulture> Cultures;
+};
+
+struct FLIApplyResult
+{
+	FLIApplyResult()
+		: NumEntries(0), NumMatched(0), NumUpdated(0), Seconds(0.0) {}
+
+	// Entries looked at; on an incremental run only those whose key or English text changed in the spreadsheet
+	int32 NumEntries;
+	int32 NumMatched;
+	int32 NumUpdated;
+	double Seconds;
+};
+
+/*
+ * Joins the spreadsheet against each culture's .po file and writes the translations back.
+ * Without a forced refresh only entries with an empty msgstr are filled in.
+ * The table is built once and shared read-only, so cultures are applied in parallel.
+ *
+ * Runs are incremental: a culture whose .po file, spreadsheet and settings all match the import
+ * manifest is skipped, and one where only the spreadsheet changed only visits the entries whose
+ * translation changed. When every culture is up to date no pending manifest is written, which
+ * is what the import and compile tasks check to skip themselves.
+ */
+class FLIApplyTranslations
+{
+public:
+	static bool Run(const FLIApplySettings& Settings);
+
+	/*
+	 * Previous is the manifest's record for a .po file that hasn't changed since, or null to go over every entry.
+	 * OutRecord comes in with the settings and hashes of this run filled in and leaves with the entries.
+	 */
+	static bool ApplyCulture(const FLITranslationTable& Table, const FLIApplySettings& Settings, const FLIApplySettings::FCulture& Culture,
+		const FLIImportManifest::FCultureRecord* Previous, FLIImportManifest::FCultureRecord& OutRecord, FLIApplyResult& OutResult);
+};
@@ -0,0 +1,22 @@
+// Copyright (C) 2022 Dakarai Simmons - All Rights Reserved
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "LIApplyTranslationsCommandlet.generated.h"
+
+/**
+ * Writes the spreadsheet's translations into the exported .po files.
+ * Usage: -run=LIApplyTranslations -config="<path to the settings written by the import dialog>"
+ */
+UCLASS()
+class ULIApplyTranslationsCommandlet : public UCommandlet
+{
+    GENERATED_BODY()
+
+public:
+    ULIApplyTranslationsCommandlet();
+
+    virtual int32 Main(const FString& Params) override;
+};
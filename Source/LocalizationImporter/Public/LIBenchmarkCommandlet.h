@@ -0,0 +1,23 @@
+// Copyright (C) 2022 Dakarai Simmons - All Rights Reserved
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "LIBenchmarkCommandlet.generated.h"
+
+/**
+ * Times the import on a generated workbook and .po files, and writes the results as JSON.
+ * Usage: -run=LIBenchmark [-Rows=<rows per page>] [-Pages=<n>] [-Cultures=<n>] [-SegmentDensity=<0..1>]
+ *        [-Iterations=<n>] [-Seed=<n>] [-Output="<path to the results>"] [-KeepData]
+ */
+UCLASS()
+class ULIBenchmarkCommandlet : public UCommandlet
+{
+    GENERATED_BODY()
+
+public:
+    ULIBenchmarkCommandlet();
+
+    virtual int32 Main(const FString& Params) override;
+};
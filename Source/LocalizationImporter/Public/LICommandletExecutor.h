@@ -3,22 +3,105 @@
 #pragma once
 
 #include "CoreMinimal.h"
-#include "LocalizationCommandletExecution.h"
 #include "Widgets/DeclarativeSyntaxSupport.h"
 #include "Widgets/Views/STableRow.h"
+#include "Widgets/Views/SListView.h"
 #include "Widgets/Notifications/SProgressBar.h"
 #include "HAL/Runnable.h"
+#include "HAL/ThreadSafeBool.h"
+#include "Async/Future.h"
+#include "LILogBuffer.h"
+#include "LILogQueue.h"
+#include "LIProgress.h"
+#include "LIRunSummary.h"
+
+/*
+ * One step of the import, run as its own commandlet process.
+ * A task with Work set runs it on a background thread in the editor instead, which saves
+ * booting a second editor for steps that don't need one. When the whole import runs inside
+ * a single pipeline process the commandlet is used anyway, since that process is already up.
+ * A task starts as soon as the tasks it depends on are done, alongside any other task that's ready.
+ */
+struct FLITask
+{
+	FLITask()
+		: ShouldUseProjectFile(true),
+		bUpToDate(false),
+		bBackground(false) {}
+
+	FLITask(const FText& InName, const FString& InCommandletName, const FString& InScriptPath, const bool InShouldUseProjectFile = true)
+		: Name(InName),
+		CommandletName(InCommandletName),
+		ScriptPath(InScriptPath),
+		ShouldUseProjectFile(InShouldUseProjectFile),
+		bUpToDate(false),
+		bBackground(false) {}
+
+	FLITask(const FText& InName, const FString& InCommandletName, const FString& InScriptPath, TFunction<bool()>&& InWork)
+		: Name(InName),
+		CommandletName(InCommandletName),
+		ScriptPath(InScriptPath),
+		ShouldUseProjectFile(true),
+		bUpToDate(false),
+		bBackground(false),
+		Work(MoveTemp(InWork)) {}
+
+	FText Name;
+	FString CommandletName;
+	FString ScriptPath;
+	bool ShouldUseProjectFile;
+
+	// When set, the task is skipped if this file doesn't exist by the time it's reached (an earlier task found nothing for it to do).
+	FString RequiredFile;
+
+	// Set when the task's output from an earlier run is known to still be current; it's shown as succeeded without running.
+	bool bUpToDate;
+
+	// Returns whether it succeeded. Anything it logs to LocalizationImporterPlugin shows up in the task's log.
+	TFunction<bool()> Work;
+
+	// Indices of earlier tasks in the same list that have to succeed, be skipped or be up to date first; none means it starts right away.
+	TArray<int32> Dependencies;
+
+	/*
+	 * Runs in a low priority process of its own, and only when no other task is waiting for a slot.
+	 * Its chain counts as done without it, so nothing may depend on it.
+	 */
+	bool bBackground;
+
+	// A file the task writes, linked from its row once it succeeded
+	FString OutputPath;
+};
+
+/*
+ * The tasks of one job, such as the import of one localization target, ordered by their dependencies.
+ * Chains that don't depend on each other run at the same time, each with processes of its own.
+ */
+struct FLITaskChain
+{
+	// Shown before the names of its tasks when there are several chains, and names its pipeline file
+	FString Name;
+	TArray<FLITask> Tasks;
+
+	// Indices of the chains that have to succeed before this one starts
+	TArray<int32> Dependencies;
+};
 
 class FLICommandletProcess : public TSharedFromThis<FLICommandletProcess>
 {
 public:
-	static TSharedPtr<FLICommandletProcess> Execute(const FString &ConfigFilePath, const bool UseProjectFile = true);
+	// A negative priority modifier runs the process below normal priority (-1 low, -2 idle).
+	static TSharedPtr<FLICommandletProcess> Execute(const FString &CommandletName, const FString &ConfigFilePath, const bool UseProjectFile = true, const int32 PriorityModifier = 0);
+
+	// The arguments a localization commandlet is given for a config file (-config plus source control switches).
+	static FString BuildCommandletArguments(const FString &ConfigFilePath, const bool UseProjectFile = true);
 
 private:
-	FLICommandletProcess(void* const InReadPipe, void* const InWritePipe, const FProcHandle InProcessHandle, const FString &InProcessArguments)
+	FLICommandletProcess(void* const InReadPipe, void* const InWritePipe, const FProcHandle InProcessHandle, const uint32 InProcessId, const FString &InProcessArguments)
 		: ReadPipe(InReadPipe),
 	WritePipe(InWritePipe),
 	ProcessHandle(InProcessHandle),
+	ProcessId(InProcessId),
 	ProcessArguments(InProcessArguments)
 	{}
 
@@ -35,6 +118,11 @@ public:
 		return ProcessHandle;
 	}
 
+	uint32 GetProcessId() const
+	{
+		return ProcessId;
+	}
+
 	const FString& GetProcessArguments() const
 	{
 		return ProcessArguments;
@@ -44,6 +132,7 @@ private:
 	void* ReadPipe;
 	void* WritePipe;
 	FProcHandle ProcessHandle;
+	uint32 ProcessId;
 	FString ProcessArguments;
 };
 
@@ -56,7 +145,21 @@ private:
 class SLICommandletExecutor : public SCompoundWidget
 {
 public:
-	SLATE_BEGIN_ARGS(SLICommandletExecutor) {}
+	SLATE_BEGIN_ARGS(SLICommandletExecutor)
+		: _SingleProcess(false)
+		, _MaxParallelChains(1)
+		, _MaxParallelTasks(1)
+		{}
+		// Run tasks that follow one another inside one LIPipeline commandlet process instead of one process per task
+		SLATE_ARGUMENT(bool, SingleProcess)
+		// How many chains run at the same time
+		SLATE_ARGUMENT(int32, MaxParallelChains)
+		// How many processes (or tasks inside the editor) run at the same time, across all chains
+		SLATE_ARGUMENT(int32, MaxParallelTasks)
+		// Stages the caller already went through; the tasks are added to it and it's written out once the run is over
+		SLATE_ARGUMENT(TSharedPtr<FLIRunSummary>, RunSummary)
+		// Called once every chain is done or stopped, without waiting for background tasks
+		SLATE_EVENT(FSimpleDelegate, OnCompleted)
 	SLATE_END_ARGS()
 
 private:
@@ -67,16 +170,110 @@ private:
 			Queued,
 			InProgress,
 			Failed,
-			Succeeded
+			Succeeded,
+			Skipped,
+			Cached
 		};
 
 		FTaskListModel()
-			: State(EState::Queued) {}
+			: ChainIndex(INDEX_NONE), GroupIndex(INDEX_NONE), State(EState::Queued), StartTime(0.0), EndTime(0.0) {}
 
-		LocalizationCommandletExecution::FTask Task;
+		FLITask Task;
+		int32 ChainIndex;
+		int32 GroupIndex;
+
+		// The task's dependencies as indices into the task list
+		TArray<int32> Dependencies;
 		EState State;
-		FString LogOutput;
+		FLILogBuffer Log;
 		FString ProcessArguments;
+		FLIProgress Progress;
+		double StartTime;
+		double EndTime;
+
+		// The task's process, or its share of the pipeline process or the editor
+		FLIProcessUsage Usage;
+	};
+
+	/*
+	 * A process (or work inside the editor) the executor is waiting on, with the thread pumping its output.
+	 * In single process mode it's a pipeline running a group of tasks, otherwise a single task.
+	 */
+	struct FExecution
+	{
+		FExecution()
+			: GroupIndex(INDEX_NONE), TaskIndex(INDEX_NONE), bPipeline(false), Runnable(nullptr), RunnableThread(nullptr), PumpReturnCode(-1) {}
+
+		int32 GroupIndex;
+
+		// The task its output goes to
+		int32 TaskIndex;
+		bool bPipeline;
+
+		TSharedPtr<FLICommandletProcess> CommandletProcess;
+		FRunnable* Runnable;
+		FRunnableThread* RunnableThread;
+
+		// Sampled by the log pump while the process runs, safe to read once the pump has stopped
+		FLIProcessUsage ProcessUsage;
+
+		// Set by the log pump once the process has exited and all of its output is queued, which is when the task is done.
+		// The return code is written first.
+		FThreadSafeBool bPumpFinished;
+		int32 PumpReturnCode;
+
+		// Output on its way from the log pump (or a task running in the editor) to the task logs.
+		FLILogQueue LogQueue;
+
+		// Pipeline output is handled a line at a time, this holds the last incomplete line.
+		TArray<ANSICHAR> PendingPipelineLine;
+
+		// Task index of each pipeline step, tasks that are already up to date aren't part of the pipeline.
+		TArray<int32> PipelineTaskIndices;
+
+		// State of a task running inside the editor, and the editor's usage when it started
+		TFuture<bool> InEditorResult;
+		TUniquePtr<FOutputDevice> InEditorLogCapture;
+		FLIProcessUsage InEditorStartUsage;
+	};
+
+	struct FChain
+	{
+		enum class EState
+		{
+			Waiting,
+			Running,
+			Succeeded,
+			// Also a chain that never started because one it depends on failed, or the run was cancelled
+			Failed
+		};
+
+		FChain()
+			: FirstTask(0), EndTask(0), State(EState::Waiting) {}
+
+		FString Name;
+		TArray<int32> Dependencies;
+
+		// Its tasks in the task list
+		int32 FirstTask;
+		int32 EndTask;
+		EState State;
+	};
+
+	/*
+	 * Tasks that are started together: a single task, or in single process mode a run of tasks
+	 * that each only wait for the one before, which go through one pipeline process in order.
+	 * The group starts once the first task's dependencies are done.
+	 */
+	struct FTaskGroup
+	{
+		FTaskGroup()
+			: ChainIndex(INDEX_NONE), bStarted(false) {}
+
+		int32 ChainIndex;
+		TArray<int32> Tasks;
+		bool bStarted;
+		TSharedPtr<FExecution> Execution;
 	};
 
 	friend class STaskRow;
@@ -85,28 +282,86 @@ public:
 	SLICommandletExecutor();
 	~SLICommandletExecutor();
 
-	void Construct(const FArguments& Arguments, const TSharedRef<SWindow>& InParentWindow, const TArray<LocalizationCommandletExecution::FTask>& Tasks);
+	void Construct(const FArguments& Arguments, const TSharedRef<SWindow>& InParentWindow, const TArray<FLITaskChain>& TaskChains);
 	void Tick(const FGeometry& AllottedGeometry, const double InCurrentTime, const float InDeltaTime) override;
 	bool WasSuccessful() const;
-	void Log(const FString &String);
+
+	// Whether the task actually ran and succeeded, as opposed to being skipped or up to date.
+	// Task index within the chain.
+	bool DidTaskRun(const int32 ChainIndex, const int32 TaskIndex) const;
+
+	// Whether every task of the chain succeeded, was skipped or was up to date.
+	bool WasChainSuccessful(const int32 ChainIndex) const;
+
+	// Whether background tasks are still running, or about to start.
+	bool HasBackgroundWork() const;
 
 private:
 	//static TSharedPtr<FLocalizationCommandletProcess> PyExecute(const FString& ConfigFilePath, const bool UseProjectFile);
-	void ExecuteCommandlet(const TSharedRef<FTaskListModel>& TaskListModel);
-	void OnCommandletProcessCompletion(const int32 ReturnCode);
+
+	// Starts the chains that are ready and then every task group whose dependencies are done, as many as may run at once.
+	void ScheduleTasks();
+
+	// Settles chains that have nothing running and nothing left that could still start.
+	void UpdateChainStates();
+
+	// Succeeded, skipped or up to date.
+	bool IsTaskDone(const int32 TaskIndex) const;
+	void ExecuteCommandlet(const int32 TaskIndex);
+	void ExecuteInEditor(const int32 TaskIndex);
+	void ExecutePipeline(const int32 GroupIndex);
+	void StartLogPump(FExecution& Execution);
+	void FlushPendingLog(FExecution& Execution);
+	void ProcessPipelineLine(FExecution& Execution, const ANSICHAR* Utf8, const int32 Len);
+	void AppendTaskLog(const TSharedPtr<FTaskListModel>& TaskListModel, const ANSICHAR* Utf8, const int32 Len);
+	void SetTaskLog(const TSharedPtr<FTaskListModel>& TaskListModel, const FText& Message);
+	void OnExecutionCompletion(const int32 GroupIndex, const int32 ReturnCode);
+	void OnPipelineCompletion(const int32 GroupIndex, const int32 ReturnCode);
+	void SelectTask(const int32 TaskIndex);
+	void MarkTaskStarted(const TSharedPtr<FTaskListModel>& TaskListModel);
+	void MarkTaskFinished(const TSharedPtr<FTaskListModel>& TaskListModel, const bool bSucceeded);
+	void SkipTask(const TSharedRef<FTaskListModel>& TaskListModel, const FTaskListModel::EState State, const FText& Reason);
 	void CancelCommandlet();
-	void CleanUpProcessAndPump();
+	void CleanUpExecution(FExecution& Execution);
+
+	// Whether a task is running inside the editor.
+	bool IsEditorBusy() const;
 
 	bool HasCompleted() const;
 
+	// Every chain completed, or stopped at a failed task. Background tasks may still be running.
+	bool IsRunFinished() const;
+	void FinishRun();
+	FText GetRunSummaryText() const;
+
+	FText GetTaskDisplayName(const FTaskListModel& TaskListModel) const;
+
 	FText GetProgressMessageText() const;
 	TOptional<float> GetProgressPercentage() const;
 
+	// Estimates from the task's own progress lines where it has any, and from how long it took on earlier runs.
+	double GetExpectedDuration(const FTaskListModel& TaskListModel) const;
+	float GetTaskFraction(const FTaskListModel& TaskListModel) const;
+
+	// Seconds, or negative when there's nothing to base an estimate on.
+	double GetTaskTimeLeft(const FTaskListModel& TaskListModel) const;
+	FText GetTaskProgressText(const FTaskListModel& TaskListModel) const;
+	FText GetTaskUsageText(const FTaskListModel& TaskListModel) const;
+
+	// When the task started and ended (or now, while it runs) as fractions of the run so far, zero for both if it never started.
+	void GetTaskTimeline(const FTaskListModel& TaskListModel, float& OutStart, float& OutEnd) const;
+
 	TSharedRef<ITableRow> OnGenerateTaskListRow(TSharedPtr<FTaskListModel> TaskListModel, const TSharedRef<STableViewBase>& Table);
 	TSharedPtr<FTaskListModel> GetCurrentTaskToView() const;
 
 	FText GetCurrentTaskProcessArguments() const;
-	FText GetLogString() const;
+	FString GetLogString() const;
+
+	TSharedRef<ITableRow> OnGenerateLogRow(TSharedPtr<FLILogBuffer::FLine> Line, const TSharedRef<STableViewBase>& Table);
+	void OnTaskSelectionChanged(TSharedPtr<FTaskListModel> TaskListModel, ESelectInfo::Type SelectInfo);
+	void RefreshLogView(const bool bScrollToEnd, const int32 FirstNewLine = 0);
+	TSharedRef<SWidget> GenerateCategoryMenu();
+	FText GetCategoryFilterText() const;
 
 	FReply OnCopyLogClicked();
 	void CopyLogToClipboard();
@@ -116,19 +371,30 @@ private:
 	FText GetCloseButtonText() const;
 	FReply OnCloseButtonClicked();
 	
-	int32 CurrentTaskIndex;
+	bool bSingleProcess;
+	int32 MaxParallelChains;
+	int32 MaxParallelTasks;
+	TArray<FChain> Chains;
+	TArray<FTaskGroup> TaskGroups;
+	double RunStartTime;
+	double RunEndTime;
+	FSimpleDelegate OnCompleted;
+	bool bCompletionReported;
 	TArray< TSharedPtr<FTaskListModel> > TaskListModels;
 	TSharedPtr<SProgressBar> ProgressBar;
 	TSharedPtr< SListView< TSharedPtr<FTaskListModel> > > TaskListView;
 
-	struct
-	{
-		FCriticalSection CriticalSection;
-		FString String;
-	} PendingLogData;
+	// Only the lines on screen are turned into widgets, which keeps huge logs cheap to show and append to.
+	TSharedPtr< SListView< TSharedPtr<FLILogBuffer::FLine> > > LogListView;
+	TSharedPtr<FTaskListModel> ViewedTask;
+	const TArray< TSharedPtr<FLILogBuffer::FLine> > NoLogLines;
+
+	// Applies to whichever task is being viewed; FilteredLogLines holds what it lets through.
+	FLILogBuffer::FFilter LogFilter;
+	TArray< TSharedPtr<FLILogBuffer::FLine> > FilteredLogLines;
+
+	FLITaskHistory TaskHistory;
+	TSharedPtr<FLIRunSummary> RunSummary;
 
 	TSharedPtr<SWindow> ParentWindow;
-	TSharedPtr<FLICommandletProcess> CommandletProcess;
-	FRunnable* Runnable;
-	FRunnableThread* RunnableThread;
 };
@@ -0,0 +1,89 @@
+// Copyright (C) 2022 Dakarai Simmons - All Rights Reserved
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "LISpreadsheet.h"
+
+class IMappedFileHandle;
+class IMappedFileRegion;
+
+/*
+ * Reader for CSV and TSV files, which hold a single page laid out like a workbook's ("Keys | English | (Language)...").
+ * The file is mapped and scanned 16 bytes at a time for delimiters, quotes and line breaks. Cells are views into
+ * the mapping; only quoted cells with doubled quotes in them are unescaped, into a buffer shared by a whole chunk.
+ *
+ * Large files are cut into chunks at row boundaries, and the chunks are parsed on several threads. Where a row
+ * boundary is depends on whether the cut falls inside a quoted cell, which is found by following the quotes the
+ * way the parser does, every stretch between cuts on its own thread and both ways it could start. Rows are still
+ * visited in order, and come out the same as reading the file in one go.
+ */
+class FLIDelimitedReader
+{
+public:
+	// Return false to stop reading.
+	typedef TFunctionRef<bool(const FLISpreadsheetRow& Row)> FRowVisitor;
+
+	FLIDelimitedReader();
+	~FLIDelimitedReader();
+
+	// Whether the path has an extension this reader is for (.csv, .tsv or .tab).
+	static bool IsDelimitedFile(const FString& Path);
+
+	/*
+	 * Maps the file and works out its delimiter: a tab for .tsv and .tab files, a comma for .csv files,
+	 * unless the header row has more of another one (Excel writes semicolons in some locales).
+	 * UTF-16 files are converted to UTF-8 first, so they're read from memory instead of the mapping.
+	 */
+	bool Open(const FString& Path);
+	void Close();
+
+	// The file's only page goes by the file's base name.
+	const FString& GetPageName() const
+	{
+		return PageName;
+	}
+
+	ANSICHAR GetDelimiter() const
+	{
+		return Delimiter;
+	}
+
+	bool ReadHeaderRow(TArray<FString>& OutHeader) const;
+
+	/*
+	 * Visits every row on the calling thread, starting with the header row as row 1.
+	 * Blank lines are skipped and aren't counted.
+	 */
+	bool ForEachRow(FRowVisitor Visitor) const;
+
+	// Bytes per chunk. Tests make it small so that ordinary files get cut; anything past the file's size means one chunk.
+	void SetChunkSize(const int64 InChunkSize)
+	{
+		ChunkSize = FMath::Max<int64>(InChunkSize, 1);
+	}
+
+private:
+	struct FChunk;
+
+	int64 FindRowStart(int64 Pos, bool bInQuotes) const;
+	void ParseChunk(FChunk& Chunk, const int32 MaxRows = MAX_int32) const;
+	ANSICHAR DetectDelimiter(const ANSICHAR DefaultDelimiter) const;
+
+	IMappedFileHandle* MappedHandle;
+	IMappedFileRegion* MappedRegion;
+
+	// Used instead of the mapping for UTF-16 files and on platforms that can't map files.
+	TArray<uint8> LoadedData;
+
+	const ANSICHAR* Data;
+	int64 Size;
+
+	// Where the first row starts, past any byte order mark
+	int64 Start;
+
+	int64 ChunkSize;
+
+	ANSICHAR Delimiter;
+	FString PageName;
+};
@@ -0,0 +1,29 @@
+// Copyright (C) 2022 Dakarai Simmons - All Rights Reserved
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class ULocalizationTarget;
+
+/*
+ * A hash of everything Gather Text reads for a target (packages from the asset registry, gathered
+ * source files, the generated gather config and the manifests of the targets it depends on)
+ * plus the manifest it writes.
+ * When neither changed since the last gather, running it again would produce the same manifest.
+ */
+class FLIGatherFingerprint
+{
+public:
+	// Returns 0 when it can't be worked out yet, e.g. while the asset registry is still scanning.
+	static uint64 ComputeInputs(const ULocalizationTarget* Target, const FString& GatherConfigPath);
+
+	static bool IsUpToDate(const ULocalizationTarget* Target, const uint64 Inputs);
+
+	// Called after a gather with the given inputs succeeded.
+	static bool Record(const ULocalizationTarget* Target, const uint64 Inputs);
+
+private:
+	static uint64 ComputeOutputs(const ULocalizationTarget* Target);
+	static FString GetPath(const ULocalizationTarget* Target);
+};
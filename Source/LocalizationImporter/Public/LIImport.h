@@ -0,0 +1,130 @@
+// Copyright (C) 2022 Dakarai Simmons - All Rights Reserved
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "LIApplyTranslations.h"
+#include "LICommandletExecutor.h"
+
+class FLIRunSummary;
+class ULocalizationTarget;
+
+/*
+ * What to import, as picked in the dialog or passed to the LocalizationImport commandlet.
+ */
+struct FLIImportRequest
+{
+	FLIImportRequest()
+		: bCaseSensitive(false),
+		bForceRefresh(false),
+		bMatchByKey(true),
+		bQuickCompile(false) {}
+
+	// Merged into one translation table; where two of them have the same row, the later one wins.
+	TArray<FString> Spreadsheets;
+
+	// Read from every spreadsheet that has them
+	TArray<FString> Pages;
+
+	// Column titles in the spreadsheet, e.g. "Spanish (Spain)"
+	TArray<FString> Languages;
+
+	bool bCaseSensitive;
+	bool bForceRefresh;
+	bool bMatchByKey;
+
+	// Only write the .locres files, straight from the spreadsheets and what was last gathered (see FLIQuickCompile)
+	bool bQuickCompile;
+};
+
+/*
+ * One import of a set of spreadsheets into a localization target, from the generated configs to the list of tasks.
+ * The dialog hands the tasks to the commandlet executor, the LocalizationImport commandlet runs them as a
+ * pipeline in its own process; either way they're the same tasks with the same configs.
+ */
+class FLIImport
+{
+public:
+	FLIImport()
+		: Target(nullptr),
+		GatherTaskIndex(INDEX_NONE),
+		CompileTaskIndex(INDEX_NONE),
+		GatherInputs(0) {}
+
+	// The first target of the game target set, or the one with the given name.
+	static ULocalizationTarget* FindGameTarget(const FString& Name = FString());
+
+	static TArray<ULocalizationTarget*> GetGameTargets();
+
+	// Indices of the targets in the list that the given one depends on (its target dependencies), which have to be imported first.
+	static TArray<int32> FindDependencies(const TArray<ULocalizationTarget*>& Targets, const int32 TargetIndex);
+
+	/*
+	 * A gather leaves out the text already in the manifests of the targets it depends on, and its fingerprint was
+	 * taken before any of them ran. So when the gather of one of the targets runs, so do those of the targets that
+	 * depend on it. One prepared import per target, in the same order.
+	 */
+	static void InvalidateDependentGathers(const TArray<FLIImport*>& Imports, const TArray<ULocalizationTarget*>& Targets);
+
+	/*
+	 * Writes the update settings and every localization config the tasks run with, then lays the tasks out.
+	 * A quick compile only needs the update settings, and is a single task.
+	 * The time it takes goes into the run summary.
+	 */
+	bool Prepare(ULocalizationTarget* InTarget, const FLIImportRequest& Request, FLIRunSummary& RunSummary, FText& OutError);
+
+	// Records what a finished run leaves behind for the next one to build on.
+	void Finish(const bool bSucceeded, const bool bGatherRan) const;
+
+	/*
+	 * Reloads the editor's localization resources when it shows one of the given cultures, or one whose
+	 * translations fall back on them, so new .locres files show up in the editor and in PIE without a restart.
+	 */
+	static void ReloadTranslations(const TArray<FString>& Cultures);
+
+	ULocalizationTarget* GetTarget() const
+	{
+		return Target;
+	}
+
+	const FLIApplySettings& GetApplySettings() const
+	{
+		return ApplySettings;
+	}
+
+	const TArray<FLITask>& GetTasks() const
+	{
+		return Tasks;
+	}
+
+	int32 GetGatherTaskIndex() const
+	{
+		return GatherTaskIndex;
+	}
+
+	// The task that writes the .locres files, the quick compile included.
+	int32 GetCompileTaskIndex() const
+	{
+		return CompileTaskIndex;
+	}
+
+private:
+	bool IsGatherUpToDate() const
+	{
+		return Tasks.IsValidIndex(GatherTaskIndex) && Tasks[GatherTaskIndex].bUpToDate;
+	}
+
+	bool WillGather() const
+	{
+		return Tasks.IsValidIndex(GatherTaskIndex) && !Tasks[GatherTaskIndex].bUpToDate;
+	}
+
+	ULocalizationTarget* Target;
+	FLIApplySettings ApplySettings;
+	TArray<FLITask> Tasks;
+	int32 GatherTaskIndex;
+	int32 CompileTaskIndex;
+
+	// Fingerprint of the gather's inputs, recorded once the gather went through
+	uint64 GatherInputs;
+};
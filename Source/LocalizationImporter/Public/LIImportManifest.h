@@ -0,0 +1,63 @@
+// Copyright (C) 2022 Dakarai Simmons - All Rights Reserved
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "LISpreadsheet.h"
+
+/*
+ * What each .po file was last filled in from, so the next import only has to touch what changed.
+ * The apply step writes a pending manifest whenever a culture wasn't up to date. It only replaces
+ * the real one once the rest of the import (import and compile) has gone through as well.
+ */
+class FLIImportManifest
+{
+public:
+	struct FCultureRecord
+	{
+		FCultureRecord()
+			: SettingsHash(0), SpreadsheetHash(0), POHash(0) {}
+
+		// Pages, case sensitivity and language column the culture was filled in from
+		uint64 SettingsHash;
+
+		uint64 SpreadsheetHash;
+
+		// The .po file as the apply step left it
+		uint64 POHash;
+
+		// Hash of each lookup key to the hash of its translation
+		TMap<uint64, uint64> Entries;
+	};
+
+	bool Load(const FString& Path);
+	bool Save(const FString& Path) const;
+
+	// Keyed by the full path of the culture's .po file, which also tells localization targets apart.
+	const FCultureRecord* FindCulture(const FString& POPath) const
+	{
+		return Cultures.Find(POPath);
+	}
+
+	FCultureRecord& FindOrAddCulture(const FString& POPath)
+	{
+		return Cultures.FindOrAdd(POPath);
+	}
+
+	// Every localization target has a manifest of its own, so several targets can be imported at the same time.
+	static FString GetPath(const FString& TargetName);
+	static FString GetPendingPath(const FString& TargetName);
+
+	// Replaces the manifest with the pending one, if there is one. Called once an import fully succeeded.
+	static bool CommitPending(const FString& TargetName);
+	static void DiscardPending(const FString& TargetName);
+
+	static uint64 HashFile(const FString& Path);
+
+	// Hashes the files in order, so the same files listed in another order hash differently.
+	static uint64 HashFiles(const TArray<FString>& Paths);
+	static uint64 HashText(const FLIUtf8View& Text);
+
+private:
+	TMap<FString, FCultureRecord> Cultures;
+};
@@ -0,0 +1,47 @@
+// Copyright (C) 2022 Dakarai Simmons - All Rights Reserved
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/DeveloperSettings.h"
+#include "LIImporterSettings.generated.h"
+
+/**
+ * Per-user options for the importer, found under Editor Preferences > Plugins.
+ */
+UCLASS(config=EditorPerProjectUserSettings, meta=(DisplayName="Localization Importer"))
+class ULIImporterSettings : public UDeveloperSettings
+{
+    GENERATED_BODY()
+
+public:
+    ULIImporterSettings(const FObjectInitializer& ObjectInitializer);
+
+    virtual FName GetCategoryName() const override;
+
+    // Number of worker threads to use for a given amount of work, based on a cap where 0 means one per logical core.
+    static int32 GetNumWorkers(const int32 Cap, const int32 NumItems);
+
+    /** Run Gather, Export, Update, Import and Compile inside one commandlet process so the engine only boots once. */
+    UPROPERTY(config, EditAnywhere, Category=Performance)
+    bool bRunInSingleProcess;
+
+    /** How many cultures have their .po files updated at the same time. 0 uses every core. */
+    UPROPERTY(config, EditAnywhere, Category=Performance, meta=(ClampMin=0, UIMin=0))
+    int32 MaxParallelCultures;
+
+    /** How many localization targets are imported at the same time, each with commandlet processes of its own. 0 uses every core. */
+    UPROPERTY(config, EditAnywhere, Category=Performance, meta=(ClampMin=0, UIMin=0))
+    int32 MaxParallelTargets;
+
+    /**
+     * How many tasks run at the same time across all targets, such as reports and compiling once the import is done.
+     * Every commandlet process loads an engine of its own, so this is what keeps memory in check. 0 uses every core.
+     */
+    UPROPERTY(config, EditAnywhere, Category=Performance, meta=(ClampMin=0, UIMin=0))
+    int32 MaxParallelTasks;
+
+    /** Regenerate the word count reports after each import. They run at low priority once the translations are compiled, without holding the import up. */
+    UPROPERTY(config, EditAnywhere, Category=Performance)
+    bool bGenerateReports;
+};
@@ -0,0 +1,27 @@
+// Copyright (C) 2022 Dakarai Simmons - All Rights Reserved
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "LILocalizationImportCommandlet.generated.h"
+
+/**
+ * Runs the whole import the dialog runs, without any UI, for build machines.
+ * Several spreadsheets are separated by '+' and merged into one table, later ones winning over earlier ones.
+ * Pages, languages and targets are comma separated; leaving them out imports every one the spreadsheets (or the project) have.
+ * Several targets run side by side in commandlet processes of their own, each after the targets it depends on.
+ * -Quick only writes the .locres files, from the spreadsheets and what was last gathered (see FLIQuickCompile).
+ * Usage: -run=LocalizationImport -Spreadsheet="<path to the .xlsx, .csv or .tsv>[+<path>...]" [-Pages="<page>,..."] [-Languages="<language>,..."]
+ *        [-Target="<localization target>,..."] [-CaseSensitive] [-ForceRefresh] [-NoMatchByKey] [-Quick]
+ */
+UCLASS()
+class ULocalizationImportCommandlet : public UCommandlet
+{
+    GENERATED_BODY()
+
+public:
+    ULocalizationImportCommandlet();
+
+    virtual int32 Main(const FString& Params) override;
+};
@@ -0,0 +1,150 @@
+// Copyright (C) 2022 Dakarai Simmons - All Rights Reserved
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/*
+ * A task's log output, kept as an append-only list of lines.
+ * The text of the lines is packed into large chunks that are never reallocated, so
+ * appending only costs the new lines, and the lines themselves are light handles
+ * a list view can virtualize over, turning into text only while they're on screen.
+ *
+ * Each line is parsed into category, verbosity and message as it's added, and indexed
+ * by category and severity, so filtering the log never has to look at its text again.
+ */
+class FLILogBuffer
+{
+public:
+	enum class ESeverity : uint8
+	{
+		Message,
+		Warning,
+		Error
+	};
+
+	struct FLine
+	{
+		int32 Chunk;
+		int32 Offset;
+		int32 Len;
+
+		// Index into GetCategories(), INDEX_NONE for lines that aren't "Category: Verbosity: Message"
+		int32 Category;
+
+		// Where the message starts, counted from the start of the line
+		int32 MessageOffset;
+
+		ELogVerbosity::Type Verbosity;
+
+		ESeverity GetSeverity() const
+		{
+			return Verbosity <= ELogVerbosity::Error ? ESeverity::Error : Verbosity == ELogVerbosity::Warning ? ESeverity::Warning : ESeverity::Message;
+		}
+	};
+
+	struct FFilter
+	{
+		FFilter()
+			: bErrors(true), bWarnings(true), bMessages(true), Category(INDEX_NONE) {}
+
+		bool bErrors;
+		bool bWarnings;
+		bool bMessages;
+
+		// INDEX_NONE for every category
+		int32 Category;
+
+		bool IsEmpty() const
+		{
+			return bErrors && bWarnings && bMessages && Category == INDEX_NONE;
+		}
+
+		bool Matches(const FLine& Line) const;
+	};
+
+	/*
+	 * Splits raw UTF-8 output into lines and decodes each one straight into chunk storage.
+	 * A trailing incomplete line is held back until the rest of it arrives or Flush is called,
+	 * which also keeps a character split between two reads from being decoded in halves.
+	 */
+	void Append(const ANSICHAR* Utf8, const int32 Len);
+
+	void Append(const FString& Text)
+	{
+		const FTCHARToUTF8 Converted(*Text);
+		Append(Converted.Get(), Converted.Length());
+	}
+
+	// Adds whatever incomplete line is still held back.
+	void Flush();
+
+	void Reset();
+
+	// Every complete line so far, in the form a list view takes its items in.
+	const TArray<TSharedPtr<FLine>>& GetLines() const
+	{
+		return Lines;
+	}
+
+	// Appends the lines from FirstLine on that the filter lets through, going through the index when it can.
+	void GetFilteredLines(const FFilter& Filter, TArray<TSharedPtr<FLine>>& OutLines, const int32 FirstLine = 0) const;
+
+	const TArray<FString>& GetCategories() const
+	{
+		return Categories;
+	}
+
+	int32 GetNumWarnings() const
+	{
+		return WarningLines.Num();
+	}
+
+	int32 GetNumErrors() const
+	{
+		return ErrorLines.Num();
+	}
+
+	int32 Num() const
+	{
+		return Lines.Num();
+	}
+
+	bool IsEmpty() const
+	{
+		return Lines.Num() == 0 && PartialLine.Num() == 0;
+	}
+
+	FString GetLineText(const FLine& Line) const
+	{
+		return Chunks[Line.Chunk].Mid(Line.Offset, Line.Len);
+	}
+
+	// The line's characters where they're stored, Len of them and not null terminated.
+	const TCHAR* GetLineChars(const FLine& Line) const
+	{
+		return *Chunks[Line.Chunk] + Line.Offset;
+	}
+
+	// The whole log joined back together, including a held back incomplete line.
+	FString ToString() const;
+
+private:
+	void AddLine(const ANSICHAR* Utf8, int32 Len);
+	void ParseLine(FLine& Line);
+	int32 FindOrAddCategory(const TCHAR* Name, const int32 Len);
+
+	// Characters per chunk. Lines longer than this get a chunk of their own.
+	static const int32 ChunkCapacity = 64 * 1024;
+
+	TArray<FString> Chunks;
+	TArray<TSharedPtr<FLine>> Lines;
+	TArray<ANSICHAR> PartialLine;
+
+	TArray<FString> Categories;
+
+	// Line indices, per category and of the lines that are warnings or errors
+	TArray<TArray<int32>> CategoryLines;
+	TArray<int32> WarningLines;
+	TArray<int32> ErrorLines;
+};
@@ -0,0 +1,54 @@
+// Copyright (C) 2022 Dakarai Simmons - All Rights Reserved
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/CircularQueue.h"
+#include "HAL/ThreadSafeBool.h"
+
+/*
+ * Hands raw (UTF-8) log output from the log pump thread to the Slate tick without locking.
+ * Output travels in chunks: the producer fills one, pushes it, and the consumer hands it back
+ * once it's been appended to the log, so after warming up no chunk is ever allocated again.
+ * Both directions are single-producer single-consumer ring buffers.
+ */
+class FLILogQueue
+{
+public:
+	typedef TArray<uint8> FChunk;
+
+	FLILogQueue();
+	~FLILogQueue();
+
+	// Producer side. Returns a recycled chunk when there is one; its contents are left for the caller to overwrite.
+	FChunk* AcquireChunk();
+
+	/*
+	 * Producer side. Waits for the consumer when it has fallen a whole queue behind, which never involves the consumer waiting back.
+	 * Once the queue is stopped it drops the chunk instead of waiting.
+	 */
+	void Push(FChunk* Chunk);
+
+	// Producer side. Copies the text into a chunk and pushes it.
+	void Write(const ANSICHAR* Text, const int32 Len);
+
+	// Consumer side. The chunk goes back through ReleaseChunk once it has been used.
+	bool Pop(FChunk*& OutChunk);
+	void ReleaseChunk(FChunk* Chunk);
+
+	/*
+	 * Either side. For a consumer about to wait for the producer to finish: the producer stops waiting
+	 * for room and drops what doesn't fit, so it can't end up waiting on the consumer in turn.
+	 */
+	void Stop();
+
+	// Drops whatever is still queued. Neither side may be in use while this runs.
+	void Reset();
+
+private:
+	static const uint32 QueueSize = 1024;
+
+	TCircularQueue<FChunk*> Ready;
+	TCircularQueue<FChunk*> Free;
+	FThreadSafeBool bStopped;
+};
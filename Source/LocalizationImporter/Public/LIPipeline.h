@@ -0,0 +1,60 @@
+// Copyright (C) 2022 Dakarai Simmons - All Rights Reserved
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "LIRunSummary.h"
+
+/*
+ * A chain of commandlets run one after another inside a single process,
+ * so the engine only boots (and scans the asset registry) once per import.
+ * Written by the commandlet executor and run by the LIPipeline commandlet.
+ */
+struct FLIPipeline
+{
+	struct FStep
+	{
+		FString Name;
+
+		// Commandlet name as it would be passed to -run=, e.g. "GatherText"
+		FString CommandletName;
+
+		// Command line handed to the commandlet's Main
+		FString Arguments;
+
+		// Skip the step when this file doesn't exist once the step is reached
+		FString RequiredFile;
+	};
+
+	bool SaveToFile(const FString& Path) const;
+	bool LoadFromFile(const FString& Path);
+
+	// One file per name, so pipelines for several localization targets can run at the same time.
+	static FString GetDefaultPath(const FString& Name);
+
+	/*
+	 * Runs every step in order and stops at the first one that fails.
+	 * Each step is bracketed by marker lines in the log (see below), which is how
+	 * the executor follows along from the other end of the pipe.
+	 * Returns the return code of the failed step, or 0, and the index of the failed step in OutFailedStep.
+	 */
+	int32 Run(int32* OutFailedStep = nullptr) const;
+
+	/*
+	 * "<marker><step index>" when a step starts or is skipped, and
+	 * "<marker><step index> <return code> <CPU seconds> <peak resident bytes>" when it ends,
+	 * the usage being this process's, which is all the step's in a process of its own.
+	 */
+	static const TCHAR* const StepBeginMarker;
+	static const TCHAR* const StepSkipMarker;
+	static const TCHAR* const StepEndMarker;
+
+	// Cheap test on a raw UTF-8 line, so only lines that may hold a marker have to be converted and parsed.
+	static bool MayContainMarker(const ANSICHAR* Line, const int32 Len);
+
+	static bool ParseStepBegin(const FString& Line, int32& OutStepIndex);
+	static bool ParseStepSkip(const FString& Line, int32& OutStepIndex);
+	static bool ParseStepEnd(const FString& Line, int32& OutStepIndex, int32& OutReturnCode, FLIProcessUsage& OutUsage);
+
+	TArray<FStep> Steps;
+};
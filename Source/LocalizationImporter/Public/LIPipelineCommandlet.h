@@ -0,0 +1,22 @@
+// Copyright (C) 2022 Dakarai Simmons - All Rights Reserved
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "LIPipelineCommandlet.generated.h"
+
+/**
+ * Runs every step of an import inside this one process.
+ * Usage: -run=LIPipeline -config="<path to the pipeline written by the commandlet executor>"
+ */
+UCLASS()
+class ULIPipelineCommandlet : public UCommandlet
+{
+    GENERATED_BODY()
+
+public:
+    ULIPipelineCommandlet();
+
+    virtual int32 Main(const FString& Params) override;
+};
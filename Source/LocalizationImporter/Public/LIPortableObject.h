@@ -0,0 +1,74 @@
+// Copyright (C) 2022 Dakarai Simmons - All Rights Reserved
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "LISpreadsheet.h"
+
+class IMappedFileHandle;
+class IMappedFileRegion;
+
+/*
+ * A .po file mapped into memory and split into entries.
+ * Entries only record where their msgctxt/msgid/msgstr lines are, so parsing
+ * doesn't copy any text and the file can be rewritten by copying the untouched
+ * ranges straight out of the mapping.
+ */
+class FLIPortableObject
+{
+public:
+	struct FSpan
+	{
+		int32 Offset = 0;
+		int32 Len = 0;
+	};
+
+	// Each span covers the keyword line and any continuation lines, including line endings.
+	struct FEntry
+	{
+		FSpan MsgCtxt;
+		FSpan MsgId;
+		FSpan MsgStr;
+	};
+
+	struct FReplacement
+	{
+		int32 EntryIndex;
+		FLIUtf8View MsgStr;
+	};
+
+	FLIPortableObject();
+	~FLIPortableObject();
+
+	bool Load(const FString& Path);
+	void Unload();
+
+	const TArray<FEntry>& GetEntries() const
+	{
+		return Entries;
+	}
+
+	// The (still escaped) text of a msgctxt/msgid/msgstr, joined across continuation lines.
+	FLIUtf8View GetString(const FSpan& Block, TArray<ANSICHAR>& Scratch) const;
+
+	/*
+	 * Writes the file to OutPath in one pass, swapping the msgstr of each replaced entry
+	 * for a single line holding the new (already escaped) text. Replacements must be
+	 * sorted by entry index.
+	 */
+	bool Save(const FString& OutPath, const TArray<FReplacement>& Replacements) const;
+
+private:
+	void Parse();
+
+	IMappedFileHandle* MappedHandle;
+	IMappedFileRegion* MappedRegion;
+
+	// Used instead of the mapping on platforms that can't map files.
+	TArray<uint8> LoadedData;
+
+	const ANSICHAR* Data;
+	int32 Size;
+	bool bCRLF;
+	TArray<FEntry> Entries;
+};
@@ -0,0 +1,69 @@
+// Copyright (C) 2022 Dakarai Simmons - All Rights Reserved
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/*
+ * How far along a running task is, pieced together from the lines it logs:
+ * - gather steps ("Executing GatherTextStep<N>: ...") out of the steps in its config,
+ * - a "[ 42.00%]" style percentage at the start of a message, taken as progress through the current step,
+ * - "[LIProgress] <done>/<total>" lines, which the plugin's own steps log.
+ */
+struct FLIProgress
+{
+	FLIProgress()
+		: NumSteps(0), Step(INDEX_NONE), StepFraction(0.0f), Fraction(-1.0f) {}
+
+	static const TCHAR* const Marker;
+
+	// Logs a progress line for the step that's running, from any thread.
+	static void Report(const int32 Done, const int32 Total);
+
+	// Number of GatherTextStep sections in a gather config, 0 for anything else.
+	static int32 CountGatherSteps(const FString& ConfigPath);
+
+	// Expects the message part of a log line, which doesn't have to be null terminated.
+	void ParseMessage(const TCHAR* Message, const int32 Len);
+
+	// Between 0 and 1, or negative while the task hasn't said anything about its progress.
+	float GetFraction() const;
+
+	int32 NumSteps;
+	int32 Step;
+	float StepFraction;
+
+	// Set by progress lines, which cover the whole task
+	float Fraction;
+};
+
+/*
+ * How long each task took the last few times it ran, so the executor can estimate
+ * progress and time left before a task reports anything, or when it never does.
+ * Stored next to the other state the plugin keeps in Saved/LocalizationImporter.
+ */
+class FLITaskHistory
+{
+public:
+	bool Load();
+	bool Save() const;
+
+	static FString GetPath();
+
+	// Tasks are told apart by commandlet and config, since the same commandlet runs several different steps.
+	static FString MakeKey(const FString& CommandletName, const FString& ScriptPath);
+
+	// Seconds, or 0 when the task hasn't succeeded before.
+	double GetDuration(const FString& Key) const;
+
+	// Blended with the earlier durations, so one unusually quick or slow run doesn't throw the estimate off.
+	void Record(const FString& Key, const double Seconds);
+
+	const TMap<FString, double>& GetDurations() const
+	{
+		return Durations;
+	}
+
+private:
+	TMap<FString, double> Durations;
+};
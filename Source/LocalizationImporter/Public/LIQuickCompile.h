@@ -0,0 +1,39 @@
+// Copyright (C) 2022 Dakarai Simmons - All Rights Reserved
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+struct FLIApplySettings;
+class ULocalizationTarget;
+
+/*
+ * Where a localization target's gathered text and compiled translations live.
+ * Worked out up front, since the target itself can't be looked at off the game thread.
+ */
+struct FLILocResTarget
+{
+	static FLILocResTarget FromTarget(const ULocalizationTarget* Target);
+
+	// Holds the manifest, and a folder per culture with its archive and .locres file
+	FString DataDirectory;
+	FString ManifestName;
+	FString ArchiveName;
+	FString LocResName;
+	FString NativeCulture;
+};
+
+/*
+ * Writes each culture's .locres file straight from the translation table and the target's gathered
+ * manifest and archives, inside the editor. There's no gather, no .po files and no commandlet, so
+ * a translator can check a fix in seconds.
+ *
+ * Entries are matched and filled in the way the update step fills in the .po files, but the archives
+ * aren't written. The full import is what ships: the import manifest is dropped, so the next one
+ * goes over every culture again and compiles over these files.
+ */
+class FLIQuickCompile
+{
+public:
+	static bool Run(const FLIApplySettings& Settings, const FLILocResTarget& Target);
+};
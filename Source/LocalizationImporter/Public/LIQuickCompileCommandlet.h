@@ -0,0 +1,23 @@
+// Copyright (C) 2022 Dakarai Simmons - All Rights Reserved
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "LIQuickCompileCommandlet.generated.h"
+
+/**
+ * Writes the .locres files of a localization target straight from the spreadsheet, skipping the .po files.
+ * The editor does this itself; this is for the LocalizationImport commandlet's -Quick runs.
+ * Usage: -run=LIQuickCompile -config="<path to the settings written by the import dialog>"
+ */
+UCLASS()
+class ULIQuickCompileCommandlet : public UCommandlet
+{
+    GENERATED_BODY()
+
+public:
+    ULIQuickCompileCommandlet();
+
+    virtual int32 Main(const FString& Params) override;
+};
@@ -0,0 +1,117 @@
+// Copyright (C) 2022 Dakarai Simmons - All Rights Reserved
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+
+/*
+ * CPU time and peak resident memory of a process, as far as the platform lets us see them.
+ * Platforms without a way to ask leave it invalid.
+ */
+struct FLIProcessUsage
+{
+	FLIProcessUsage()
+		: CPUSeconds(-1.0), PeakResidentBytes(0) {}
+
+	bool IsValid() const
+	{
+		return CPUSeconds >= 0.0;
+	}
+
+	// User and kernel time, negative when unknown
+	double CPUSeconds;
+
+	uint64 PeakResidentBytes;
+
+	// Reads a child process's usage so far. Fails once the process has been reaped on platforms that go through /proc.
+	static bool SampleProcess(const FProcHandle& Handle, const uint32 ProcessId, FLIProcessUsage& OutUsage);
+
+	static bool SampleCurrentProcess(FLIProcessUsage& OutUsage);
+};
+
+/*
+ * Where the time of one import went, from the dialog's preparation to the last task.
+ * Written to Saved/LocalizationImporter/LastRun.json once the run is over, and shown by the executor.
+ */
+class FLIRunSummary
+{
+public:
+	enum class EStageKind : uint8
+	{
+		// Work done in the editor process, by the dialog or a task that runs in the editor
+		Editor,
+
+		// A commandlet process of its own
+		Process,
+
+		// One step of the pipeline process, as measured by that process
+		Step
+	};
+
+	struct FStage
+	{
+		FStage()
+			: Kind(EStageKind::Editor), WallSeconds(0.0) {}
+
+		FString Name;
+		EStageKind Kind;
+		FString Result;
+		double WallSeconds;
+		FLIProcessUsage Usage;
+	};
+
+	/*
+	 * Records the editor's wall and CPU time over a scope as a stage of the run.
+	 * Pair it with a TRACE_CPUPROFILER_EVENT_SCOPE to see the same stage in Unreal Insights.
+	 */
+	class FScopedStage
+	{
+	public:
+		FScopedStage(FLIRunSummary& InSummary, const FString& InName);
+		~FScopedStage();
+
+	private:
+		FLIRunSummary& Summary;
+		FString Name;
+		double StartTime;
+		FLIProcessUsage StartUsage;
+	};
+
+	FLIRunSummary();
+
+	void AddStage(const FStage& Stage)
+	{
+		Stages.Add(Stage);
+	}
+
+	// Stops the clock on the whole run and writes the summary.
+	bool Finish(const bool bInSucceeded);
+
+	bool IsFinished() const
+	{
+		return EndTime > 0.0;
+	}
+
+	double GetWallSeconds() const;
+
+	// Time spent in the editor and in commandlet processes; steps are already part of their process.
+	double GetCPUSeconds() const;
+
+	uint64 GetPeakResidentBytes() const;
+
+	const TArray<FStage>& GetStages() const
+	{
+		return Stages;
+	}
+
+	static FString GetPath();
+
+private:
+	bool Save(const FString& Path) const;
+
+	TArray<FStage> Stages;
+	double StartTime;
+	double EndTime;
+	bool bSucceeded;
+};
@@ -0,0 +1,79 @@
+// Copyright (C) 2022 Dakarai Simmons - All Rights Reserved
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/ThreadSafeBool.h"
+#include "LocalizationImporterTypes.h"
+
+/*
+ * Non-owning view of UTF-8 text.
+ * Spreadsheet cells are handed out as views into the reader's buffers
+ * so walking a sheet doesn't allocate a string per cell.
+ */
+struct FLIUtf8View
+{
+	FLIUtf8View()
+		: Data(nullptr), Len(0) {}
+
+	FLIUtf8View(const ANSICHAR* InData, const int32 InLen)
+		: Data(InData), Len(InLen) {}
+
+	bool IsEmpty() const
+	{
+		return Len == 0;
+	}
+
+	bool Equals(const ANSICHAR* Other) const
+	{
+		const int32 OtherLen = FCStringAnsi::Strlen(Other);
+		return OtherLen == Len && (Len == 0 || FMemory::Memcmp(Data, Other, Len) == 0);
+	}
+
+	FString ToString() const
+	{
+		const FUTF8ToTCHAR Converted(Data, Len);
+		return FString(Converted.Length(), Converted.Get());
+	}
+
+	const ANSICHAR* Data;
+	int32 Len;
+};
+
+// One row of a sheet. Missing cells are empty views.
+struct FLISpreadsheetRow
+{
+	FLISpreadsheetRow()
+		: RowNumber(0) {}
+
+	FLIUtf8View GetCell(const int32 Column) const
+	{
+		return Cells.IsValidIndex(Column) ? Cells[Column] : FLIUtf8View();
+	}
+
+	// 1-based, as displayed in Excel.
+	int32 RowNumber;
+	TArray<FLIUtf8View> Cells;
+};
+
+class FLISpreadsheet
+{
+public:
+	/*
+	 * Lists every page laid out as "Keys | English | (Language)..." as unchecked settings,
+	 * followed by the languages found in the header row as checked settings.
+	 * Only the header row of each page is read.
+	 * A .csv or .tsv file is a single page named after the file.
+	 * Raising the cancel flag from another thread makes it give up early and return false.
+	 */
+	static bool ImportSpreadsheet(const FString& Path, TArray<FUpdateTranslationsSettings>& OutSettings, const FThreadSafeBool* CancelFlag = nullptr);
+
+	// Lists the pages and languages of several spreadsheets at once, each name only once. Fails if any of them fails.
+	static bool ImportSpreadsheets(const TArray<FString>& Paths, TArray<FUpdateTranslationsSettings>& OutSettings, const FThreadSafeBool* CancelFlag = nullptr);
+
+	static bool IsTranslationPageHeader(const TArray<FString>& HeaderRow);
+
+private:
+	static bool ImportDelimitedFile(const FString& Path, TArray<FUpdateTranslationsSettings>& OutSettings);
+	static void AddLanguages(const TArray<FString>& HeaderRow, TArray<FUpdateTranslationsSettings>& OutSettings);
+};
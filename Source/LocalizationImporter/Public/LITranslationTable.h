@@ -0,0 +1,186 @@
+// Copyright (C) 2022 Dakarai Simmons - All Rights Reserved
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "LISpreadsheet.h"
+
+class IMappedFileHandle;
+class IMappedFileRegion;
+
+/*
+ * The spreadsheet's translations, one entry per row, looked up either by the row's key
+ * (the Keys column, matched against a .po entry's msgctxt) or by its English text.
+ * Everything lives in one UTF-8 string pool with flat entry arrays and open addressed
+ * indices on top, so a lookup is a hash and a memcmp with no allocations.
+ * Keys and translations are stored already escaped the way a .po file expects them,
+ * which lets the PO join compare and copy bytes directly.
+ *
+ * Since the table is nothing but flat arrays, it's saved as they are. Loading a saved table
+ * maps the file and points the arrays at it, after one pass checking the spans and buckets.
+ */
+class FLITranslationTable
+{
+public:
+	FLITranslationTable();
+	~FLITranslationTable();
+
+	/*
+	 * Reads the given pages of every spreadsheet that has them and keeps the requested language columns.
+	 * Spreadsheets are read in order and later ones take precedence: a row whose key (or English text,
+	 * for rows without a key) was already seen in an earlier spreadsheet replaces that row, and keeps
+	 * its translations for the languages the new row leaves empty. Each page has to be in at least one.
+	 *
+	 * Cells containing pairs of U+2060 (word joiner) are split into one entry per pair,
+	 * matched up positionally between the English and translated cells. Those entries can
+	 * only be found by their English text, since the row's key doesn't say which part is which.
+	 */
+	bool Build(const TArray<FString>& Spreadsheets, const TArray<FString>& Pages, const TArray<FString>& InLanguages, const bool bInCaseSensitive);
+
+	/*
+	 * Identifies what a table was built from: the spreadsheets' contents (see FLIImportManifest::HashFiles),
+	 * its pages and the case sensitivity. Languages aren't part of it, check them with HasLanguages.
+	 */
+	static uint64 HashSource(const uint64 SpreadsheetHash, const TArray<FString>& Pages, const bool bInCaseSensitive);
+
+	// Writes a new file and renames it over the old one in one step. Fails on Windows while another process has the old one mapped.
+	bool Save(const FString& Path, const uint64 SourceHash) const;
+
+	// Fails, leaving the table empty, when the file is missing, damaged, from another version or built from another source.
+	bool Load(const FString& Path, const uint64 SourceHash);
+
+	static FString GetDefaultPath();
+
+	bool HasLanguages(const TArray<FString>& InLanguages) const;
+
+	// Turns an escaped msgid into the form used by the index (trimmed, and lowercased if the table isn't case-sensitive).
+	FLIUtf8View MakeLookupKey(const FLIUtf8View& EscapedText, TArray<ANSICHAR>& Scratch) const;
+
+	// Expects a key from MakeLookupKey. Repeated English text finds the last row it appeared in.
+	int32 Find(const FLIUtf8View& LookupKey) const;
+
+	/*
+	 * Finds the row whose key matches an (escaped) msgctxt. Unreal writes msgctxt as "Namespace,Key",
+	 * so a spreadsheet that only lists keys is matched against the part after the namespace.
+	 */
+	int32 FindByContext(const FLIUtf8View& EscapedContext) const;
+
+	FLIUtf8View GetTranslation(const int32 EntryIndex, const int32 LanguageIndex) const;
+
+	// The entry's English text, in the same form MakeLookupKey produces.
+	FLIUtf8View GetSource(const int32 EntryIndex) const
+	{
+		return GetView(Data.Entries[EntryIndex].Source);
+	}
+
+	// The entry's key, empty for rows without one and for split cells.
+	FLIUtf8View GetKey(const int32 EntryIndex) const
+	{
+		return GetView(Data.Entries[EntryIndex].Key);
+	}
+
+	int32 GetLanguageIndex(const FString& Language) const
+	{
+		return Languages.IndexOfByKey(Language);
+	}
+
+	int32 Num() const
+	{
+		return Data.NumEntries;
+	}
+
+	bool IsCaseSensitive() const
+	{
+		return bCaseSensitive;
+	}
+
+private:
+	struct FSpan
+	{
+		int32 Offset;
+		int32 Len;
+	};
+
+	struct FEntry
+	{
+		FSpan Source;
+		uint32 SourceHash;
+		FSpan Key;
+		uint32 KeyHash;
+	};
+
+	// Power of two sized, INDEX_NONE marks an empty slot. A repeated text points at the last entry that had it.
+	struct FIndex
+	{
+		FIndex()
+			: NumUsed(0) {}
+
+		TArray<int32> Buckets;
+		int32 NumUsed;
+	};
+
+	// Where lookups read from: the arrays below once the table is built, or the file once it's loaded.
+	struct FData
+	{
+		const ANSICHAR* Pool = nullptr;
+		const FEntry* Entries = nullptr;
+		const FSpan* Translations = nullptr;
+		const int32* SourceBuckets = nullptr;
+		const int32* KeyBuckets = nullptr;
+		int32 NumEntries = 0;
+		int32 NumSourceBuckets = 0;
+		int32 NumKeyBuckets = 0;
+		int32 NumKeys = 0;
+	};
+
+	// Both mark the pages they found; a spreadsheet without any of the pages is skipped.
+	bool AddWorkbook(const FString& Path, const TArray<FString>& Pages, TArray<bool>& OutPagesFound);
+	bool AddDelimitedFile(const FString& Path, const TArray<FString>& Pages, TArray<bool>& OutPagesFound);
+	void MapLanguageColumns(const FLISpreadsheetRow& HeaderRow, TArray<int32>& OutColumnLanguages) const;
+	void AddRow(const FLISpreadsheetRow& Row, const TArray<int32>& ColumnLanguages);
+	int32 AddEntry(const FLIUtf8View& SourceText, const FLIUtf8View& KeyText);
+	void SetTranslation(const int32 EntryIndex, const int32 LanguageIndex, const FLIUtf8View& Text);
+
+	FSpan AddEscaped(const FLIUtf8View& Text, const bool bLowercase);
+	FLIUtf8View GetView(const FSpan& Span) const
+	{
+		return FLIUtf8View(Data.Pool + Span.Offset, Span.Len);
+	}
+
+	// Points Data at the arrays, which have to be done growing.
+	void UpdateData();
+
+	// Whether every span lies inside the pool and every bucket holds an entry or nothing, for a table read from a file.
+	bool IsDataValid(const int32 PoolSize) const;
+	void Reset();
+
+	// Returns the entry that had the same text before, or INDEX_NONE.
+	int32 AddToIndex(FIndex& Index, FSpan FEntry::*Text, uint32 FEntry::*Hash, const int32 EntryIndex);
+	int32 FindInIndex(const int32* Buckets, const int32 NumBuckets, FSpan FEntry::*Text, uint32 FEntry::*Hash, const FLIUtf8View& Key, const uint32 KeyHash) const;
+	static int32 FindSlot(const int32* Buckets, const int32 NumBuckets, const FEntry* InEntries, const ANSICHAR* InPool,
+		FSpan FEntry::*Text, uint32 FEntry::*Hash, const FLIUtf8View& Key, const uint32 KeyHash);
+	void Rehash(FIndex& Index, uint32 FEntry::*Hash, const int32 NewBucketCount);
+
+	TArray<FString> Languages;
+	bool bCaseSensitive;
+
+	TArray<ANSICHAR> Pool;
+	TArray<FEntry> Entries;
+
+	// Entries.Num() * Languages.Num() spans, one row per entry.
+	TArray<FSpan> Translations;
+
+	FIndex SourceIndex;
+	FIndex KeyIndex;
+
+	// While building, the first entry of the spreadsheet being read. Entries before it come from earlier spreadsheets.
+	int32 FirstSpreadsheetEntry;
+
+	FData Data;
+
+	IMappedFileHandle* MappedHandle;
+	IMappedFileRegion* MappedRegion;
+
+	// Used instead of the mapping on platforms that can't map files.
+	TArray<uint8> LoadedData;
+};
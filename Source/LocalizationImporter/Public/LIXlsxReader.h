@@ -0,0 +1,73 @@
+// Copyright (C) 2022 Dakarai Simmons - All Rights Reserved
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/ThreadSafeBool.h"
+#include "LIZipArchive.h"
+#include "LISpreadsheet.h"
+
+/*
+ * Streaming reader for .xlsx workbooks.
+ * The workbook is never loaded as a whole: sheet XML is inflated and scanned block by block,
+ * so reading just the header rows stays fast and bounded regardless of the sheet size.
+ */
+class FLIXlsxReader
+{
+public:
+	struct FSheet
+	{
+		FString Name;
+		FString EntryPath;
+	};
+
+	// Return false to stop reading the sheet.
+	typedef TFunctionRef<bool(const FLISpreadsheetRow& Row)> FRowVisitor;
+
+	bool Open(const FString& Path);
+
+	// Reading stops, and fails, once the flag is raised. The flag has to outlive the reader.
+	void SetCancelFlag(const FThreadSafeBool* InCancelFlag)
+	{
+		CancelFlag = InCancelFlag;
+	}
+
+	bool IsCancelled() const
+	{
+		return CancelFlag && *CancelFlag;
+	}
+
+	const TArray<FSheet>& GetSheets() const
+	{
+		return Sheets;
+	}
+
+	/*
+	 * Reads row 1 of every sheet. Only the shared strings those rows reference are
+	 * decoded, and the shared string part is abandoned as soon as the last one is found.
+	 */
+	bool ReadHeaderRows(TArray<TArray<FString>>& OutHeaders);
+
+	// Streams every row of a sheet. Loads the full shared string table on first use.
+	bool ForEachRow(const int32 SheetIndex, FRowVisitor Visitor);
+
+private:
+	bool ReadWorkbook();
+	bool LoadSharedStrings();
+
+	FLIZipReader Zip;
+	TArray<FSheet> Sheets;
+	FString SharedStringsPath;
+
+	struct FSpan
+	{
+		int32 Offset;
+		int32 Len;
+	};
+
+	const FThreadSafeBool* CancelFlag = nullptr;
+
+	bool bSharedStringsLoaded = false;
+	TArray<ANSICHAR> SharedStringPool;
+	TArray<FSpan> SharedStrings;
+};
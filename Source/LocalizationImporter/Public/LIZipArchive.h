@@ -0,0 +1,48 @@
+// Copyright (C) 2022 Dakarai Simmons - All Rights Reserved
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Templates/UniquePtr.h"
+
+class IFileHandle;
+
+/*
+ * Minimal read-only view of a zip archive (which is all an .xlsx file is).
+ * Only the central directory is kept in memory. Entries are inflated on demand
+ * in fixed size blocks, so reading a large worksheet never holds the whole thing.
+ */
+class FLIZipReader
+{
+public:
+	struct FEntry
+	{
+		FString Name;
+		uint16 Method = 0;
+		uint32 CompressedSize = 0;
+		uint32 UncompressedSize = 0;
+		uint32 LocalHeaderOffset = 0;
+	};
+
+	// Receives each inflated block. Return false to stop reading early.
+	typedef TFunctionRef<bool(const uint8* Data, int32 Size)> FBlockVisitor;
+
+	FLIZipReader();
+	~FLIZipReader();
+
+	bool Open(const FString& Path);
+	void Close();
+
+	const FEntry* FindEntry(const FString& Name) const;
+
+	// Streams the entry through the visitor. Stopping early still counts as success.
+	bool ReadEntry(const FEntry& Entry, FBlockVisitor Visitor);
+	bool ReadEntryToArray(const FEntry& Entry, TArray<uint8>& OutData);
+
+	static const int32 BlockSize = 64 * 1024;
+
+private:
+	TUniquePtr<IFileHandle> FileHandle;
+	TArray<FEntry> Entries;
+	TMap<FString, int32> EntryIndices;
+};